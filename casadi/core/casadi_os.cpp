@@ -46,6 +46,14 @@ std::string filesep() {
     #endif
 }
 
+#ifdef CASADI_WITH_THREAD
+std::recursive_mutex& plugin_mutex() {
+    // Shared by the plugin registries of all interfaces
+    static std::recursive_mutex mtx;
+    return mtx;
+}
+#endif //CASADI_WITH_THREAD
+
 std::vector<std::string> get_search_paths() {
 
     // Build up search paths;
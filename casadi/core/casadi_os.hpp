@@ -26,6 +26,13 @@
 #include <casadi/core/casadi_export.h>
 #include <vector>
 #include <string>
+#ifdef CASADI_WITH_THREAD
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.mutex.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <mutex>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif //CASADI_WITH_THREAD
 
 /// \cond INTERNAL
 
@@ -77,6 +84,12 @@ CASADI_EXPORT char pathsep();
  */
 CASADI_EXPORT std::string filesep();
 
+#ifdef CASADI_WITH_THREAD
+/* \brief Lock held while looking up, loading or registering plugins
+ */
+CASADI_EXPORT std::recursive_mutex& plugin_mutex();
+#endif //CASADI_WITH_THREAD
+
 // For dynamic loading
 #ifdef WITH_DL
 
@@ -55,6 +55,8 @@ namespace casadi {
     bool prefix_set = false;
     this->prefix = "";
     avoid_stack_ = false;
+    this->split_size = 0;
+    this->n_units = 1;
     indent_ = 2;
 
     // Read options
@@ -100,6 +102,12 @@ namespace casadi {
         casadi_assert_dev(indent_>=0);
       } else if (e.first=="avoid_stack") {
         avoid_stack_ = e.second;
+      } else if (e.first=="split_size") {
+        this->split_size = e.second;
+        casadi_assert(this->split_size>=0, "Option 'split_size' must be nonnegative");
+      } else if (e.first=="n_units") {
+        this->n_units = e.second;
+        casadi_assert(this->n_units>=1, "Option 'n_units' must be positive");
       } else if (e.first=="prefix") {
         this->prefix = e.second.to_string();
         prefix_set = true;
@@ -450,6 +458,13 @@ namespace casadi {
     std::string fullname = prefix + this->name + this->suffix;
     file_open(s, fullname, this->cpp);
 
+    // List the other translation units, to be compiled and linked with this file
+    if (this->n_units>1) {
+      s << "/*CASADIMETA\n:units";
+      for (casadi_int k=1; k<this->n_units; ++k) s << " " << unit_name(k);
+      s << "\n*/\n\n";
+    }
+
     // Dump code to file
     dump(s);
 
@@ -462,6 +477,13 @@ namespace casadi {
     // Finalize file
     file_close(s, this->cpp);
 
+    // Generate the other translation units
+    for (casadi_int k=1; k<this->n_units; ++k) {
+      file_open(s, prefix + unit_name(k), this->cpp);
+      dump_unit(s, k);
+      file_close(s, this->cpp);
+    }
+
     // Generate s-function
     if (this->with_sfunction) {
       for (unsigned ii=0; ii<this->added_sfunctions.size(); ii++) {
@@ -783,10 +805,7 @@ namespace casadi {
     return "casadi_ri" + str(size);
   }
 
-  void CodeGenerator::dump(std::ostream& s) {
-    // Consistency check
-    casadi_assert_dev(current_indent_ == 0);
-
+  void CodeGenerator::dump_preamble(std::ostream& s, casadi_int unit) {
     // Prefix internal symbols to avoid symbol collisions
     s << "/* How to prefix internal symbols */\n"
       << "#ifdef CASADI_CODEGEN_PREFIX\n"
@@ -823,7 +842,9 @@ namespace casadi {
     if (!added_shorthands_.empty()) {
       s << "/* Add prefix to internal symbols */\n";
       for (auto&& i : added_shorthands_) {
-        s << "#define " << "casadi_" << i <<  " CASADI_PREFIX(" << i <<  ")\n";
+        // Other translation units have their own copies of the auxiliary functions
+        std::string id = unit==0 || i.compare(0, 4, "part")==0 ? i : "u" + str(unit) + "_" + i;
+        s << "#define " << "casadi_" << i <<  " CASADI_PREFIX(" << id <<  ")\n";
       }
       s << std::endl;
     }
@@ -840,6 +861,40 @@ namespace casadi {
 
     // Codegen auxiliary functions
     s << this->auxiliaries.str();
+  }
+
+  void CodeGenerator::dump_unit(std::ostream& s, casadi_int unit) {
+    dump_preamble(s, unit);
+
+    // Parts of split function bodies
+    for (auto&& p : parts_) {
+      if (p.first==unit) s << p.second;
+    }
+  }
+
+  std::string CodeGenerator::unit_name(casadi_int unit) const {
+    return this->name + "_" + str(unit) + this->suffix;
+  }
+
+  std::string CodeGenerator::add_part(const std::string& body) {
+    casadi_int ind = parts_.size();
+    std::string fname = shorthand("part" + str(ind), false);
+    casadi_int unit = ind % this->n_units;
+    std::stringstream ss;
+    // Parts in other translation units need external linkage
+    if (unit==0) ss << "static ";
+    ss << "void " << fname << "(const casadi_real** arg, casadi_real** res, casadi_real* w) {\n"
+       << body << "}\n\n";
+    parts_.push_back(std::make_pair(unit, ss.str()));
+    return fname;
+  }
+
+  void CodeGenerator::dump(std::ostream& s) {
+    // Consistency check
+    casadi_assert_dev(current_indent_ == 0);
+
+    // Code preceding constants and function definitions
+    dump_preamble(s, 0);
 
     // Print integer constants
     if (!integer_constants_.empty()) {
@@ -892,6 +947,19 @@ namespace casadi {
       s << std::endl << std::endl;
     }
 
+    // Parts of split function bodies, declared if defined in another translation unit
+    if (!parts_.empty()) {
+      for (auto&& p : parts_) {
+        if (p.first!=0) {
+          s << p.second.substr(0, p.second.find(" {\n")) << ";\n";
+        }
+      }
+      s << std::endl;
+      for (auto&& p : parts_) {
+        if (p.first==0) s << p.second;
+      }
+    }
+
     // Codegen body
     s << this->body.str();
 
@@ -1403,6 +1471,23 @@ namespace casadi {
 
       this->auxiliaries << sanitize_source(casadi_qrqp_str, inst);
       break;
+    case AUX_KKT:
+      add_auxiliary(AUX_CLEAR);
+      this->auxiliaries << sanitize_source(casadi_kkt_str, inst);
+      break;
+    case AUX_IPQP:
+      add_auxiliary(AUX_COPY);
+      add_auxiliary(AUX_FILL);
+      add_auxiliary(AUX_CLEAR);
+      add_auxiliary(AUX_AXPY);
+      add_auxiliary(AUX_FMIN);
+      add_auxiliary(AUX_FMAX);
+      add_auxiliary(AUX_INF);
+      add_auxiliary(AUX_REAL_MIN);
+      add_include("stdio.h");
+      add_include("math.h");
+      this->auxiliaries << sanitize_source(casadi_ipqp_str, inst);
+      break;
     case AUX_NLP:
       add_auxiliary(AUX_ORACLE);
       this->auxiliaries << sanitize_source(casadi_nlp_str, inst);
@@ -1422,6 +1507,9 @@ namespace casadi {
     case AUX_LDL:
       this->auxiliaries << sanitize_source(casadi_ldl_str, inst);
       break;
+    case AUX_BAND:
+      this->auxiliaries << sanitize_source(casadi_band_str, inst);
+      break;
     case AUX_NEWTON:
       add_auxiliary(AUX_COPY);
       add_auxiliary(AUX_AXPY);
@@ -2307,6 +2395,18 @@ namespace casadi {
            + beta + ", " + prinv + ", " + pc + ", " + w + ");";
   }
 
+  std::string CodeGenerator::
+  qr_solve_block(const std::string& x, casadi_int nrhs, casadi_int nb, bool tr,
+      const std::string& sp_v, const std::string& v,
+      const std::string& sp_r, const std::string& r,
+      const std::string& beta, const std::string& prinv,
+      const std::string& pc, const std::string& w) {
+    add_auxiliary(CodeGenerator::AUX_QR);
+    return "casadi_qr_solve_block(" + x + ", " + str(nrhs) + ", " + str(nb) + ", "
+           + (tr ? "1" : "0") + ", " + sp_v + ", " + v + ", " + sp_r + ", " + r + ", "
+           + beta + ", " + prinv + ", " + pc + ", " + w + ");";
+  }
+
   std::string CodeGenerator::
   lsqr_solve(const std::string& A, const std::string&x,
              casadi_int nrhs, bool tr, const std::string& sp, const std::string& w) {
@@ -2324,6 +2424,15 @@ namespace casadi {
            + d + ", " + p + ", " + w + ");";
   }
 
+  std::string CodeGenerator::
+  ldl_super(const std::string& sp_a, const std::string& a, const std::string& sn,
+      const std::string& sp_lt, const std::string& lt, const std::string& d,
+      const std::string& p, const std::string& iw, const std::string& w) {
+    add_auxiliary(CodeGenerator::AUX_LDL);
+    return "casadi_ldl_super(" + sp_a + ", " + a + ", " + sn + ", " + sp_lt + ", "
+           + lt + ", " + d + ", " + p + ", " + iw + ", " + w + ");";
+  }
+
   std::string CodeGenerator::
   ldl_solve(const std::string& x, casadi_int nrhs,
     const std::string& sp_lt, const std::string& lt, const std::string& d,
@@ -2333,6 +2442,30 @@ namespace casadi {
            + lt + ", " + d + ", " + p + ", " + w + ");";
   }
 
+  std::string CodeGenerator::
+  ldl_solve_block(const std::string& x, casadi_int nrhs, casadi_int nb,
+    const std::string& sp_lt, const std::string& lt, const std::string& d,
+    const std::string& p, const std::string& w) {
+    add_auxiliary(CodeGenerator::AUX_LDL);
+    return "casadi_ldl_solve_block(" + x + ", " + str(nrhs) + ", " + str(nb) + ", " + sp_lt
+           + ", " + lt + ", " + d + ", " + p + ", " + w + ");";
+  }
+
+  std::string CodeGenerator::
+  band_fact(const std::string& sp_a, const std::string& a, const std::string& bp,
+      const std::string& iw, const std::string& w) {
+    add_auxiliary(CodeGenerator::AUX_BAND);
+    return "casadi_band_fact(" + sp_a + ", " + a + ", " + bp + ", " + iw + ", " + w + ");";
+  }
+
+  std::string CodeGenerator::
+  band_solve(const std::string& x, casadi_int nrhs, bool tr, const std::string& bp,
+      const std::string& iw, const std::string& w) {
+    add_auxiliary(CodeGenerator::AUX_BAND);
+    return "casadi_band_solve(" + x + ", " + str(nrhs) + ", " + (tr ? "1" : "0") + ", "
+           + bp + ", " + iw + ", " + w + ");";
+  }
+
   std::string CodeGenerator::
   fmax(const std::string& x, const std::string& y) {
     add_auxiliary(CodeGenerator::AUX_FMAX);
@@ -214,6 +214,22 @@ namespace casadi {
         \identifier{se} */
     std::string sx_work(casadi_int i);
 
+    /** \brief Add a part of a split function body
+
+        Defines a function taking the arguments arg, res and w of the calling function.
+        The parts are distributed round-robin over the translation units.
+        \return Name of the function
+
+        \identifier{28a} */
+    std::string add_part(const std::string& body);
+
+    /** \brief Should a function body with a given number of instructions be split?
+
+        \identifier{28b} */
+    bool split(casadi_int n_instructions) const {
+      return split_size>0 && n_instructions>split_size;
+    }
+
     /** \brief Specify the default value for a local variable
 
         \identifier{sf} */
@@ -399,6 +415,15 @@ namespace casadi {
                          const std::string& beta, const std::string& prinv,
                          const std::string& pc, const std::string& w);
 
+    /** \brief QR solve for blocks of nb right-hand sides at once
+
+        \identifier{28u} */
+    std::string qr_solve_block(const std::string& x, casadi_int nrhs, casadi_int nb, bool tr,
+                         const std::string& sp_v, const std::string& v,
+                         const std::string& sp_r, const std::string& r,
+                         const std::string& beta, const std::string& prinv,
+                         const std::string& pc, const std::string& w);
+
     /** \\brief LSQR solve
 
          \identifier{t1} */
@@ -413,6 +438,15 @@ namespace casadi {
                    const std::string& d, const std::string& p,
                    const std::string& w);
 
+    /** \brief Supernodal LDL factorization
+
+        \identifier{28m} */
+    std::string ldl_super(const std::string& sp_a, const std::string& a,
+                   const std::string& sn, const std::string& sp_lt,
+                   const std::string& lt, const std::string& d,
+                   const std::string& p, const std::string& iw,
+                   const std::string& w);
+
     /** \brief LDL solve
 
         \identifier{t3} */
@@ -421,6 +455,28 @@ namespace casadi {
                          const std::string& d, const std::string& p,
                          const std::string& w);
 
+    /** \brief LDL solve for blocks of nb right-hand sides at once
+
+        \identifier{28v} */
+    std::string ldl_solve_block(const std::string& x, casadi_int nrhs, casadi_int nb,
+                          const std::string& sp_lt, const std::string& lt,
+                          const std::string& d, const std::string& p,
+                          const std::string& w);
+
+    /** \brief Banded LU factorization with a dense border
+
+        \identifier{28o} */
+    std::string band_fact(const std::string& sp_a, const std::string& a,
+                   const std::string& bp, const std::string& iw,
+                   const std::string& w);
+
+    /** \brief Banded linear solve with a dense border
+
+        \identifier{28p} */
+    std::string band_solve(const std::string& x, casadi_int nrhs, bool tr,
+                   const std::string& bp, const std::string& iw,
+                   const std::string& w);
+
     /** \brief fmax
 
         \identifier{t4} */
@@ -581,10 +637,13 @@ namespace casadi {
       AUX_QR,
       AUX_QP,
       AUX_QRQP,
+      AUX_KKT,
+      AUX_IPQP,
       AUX_NLP,
       AUX_SQPMETHOD,
       AUX_FEASIBLESQPMETHOD,
       AUX_LDL,
+      AUX_BAND,
       AUX_NEWTON,
       AUX_TO_DOUBLE,
       AUX_TO_INT,
@@ -795,6 +854,15 @@ namespace casadi {
     // Generate mex entry point
     void generate_mex(std::ostream &s) const;
 
+    // Generate code preceding constants and function definitions
+    void dump_preamble(std::ostream& s, casadi_int unit);
+
+    // Generate a translation unit, other than the main file
+    void dump_unit(std::ostream& s, casadi_int unit);
+
+    // Name of the file of a translation unit, other than the main file
+    std::string unit_name(casadi_int unit) const;
+
     // Generate function specific code for Simulink s-Function
     std::string codegen_sfunction(const Function& f) const;
 
@@ -857,6 +925,12 @@ namespace casadi {
     // Do we want to be lean on stack usage?
     bool avoid_stack_;
 
+    // Maximum number of instructions in a part of a split function body, 0 for no splitting
+    casadi_int split_size;
+
+    // Number of translation units, i.e. generated source files
+    casadi_int n_units;
+
     std::string infinity, nan, real_min;
 
     /** \brief Codegen scalar
@@ -926,6 +1000,9 @@ namespace casadi {
     std::vector<std::vector<casadi_int> > integer_constants_;
     std::vector<std::vector<char> > char_constants_;
 
+    // Parts of split function bodies: translation unit and definition
+    std::vector<std::pair<casadi_int, std::string> > parts_;
+
     // Does any function need thread-local memory?
     bool needs_mem_;
 
@@ -30,6 +30,14 @@
 #include "serializing_stream.hpp"
 #include <cassert>
 
+#ifdef CASADI_WITH_THREAD
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.mutex.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <mutex>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif // CASADI_WITH_THREAD
+
 /// \cond INTERNAL
 
 // Cashing of constants requires a map
@@ -78,6 +86,32 @@ bool is_equal(const SXNode* node, casadi_int depth) const override {
 
 protected:
 
+/** \brief Increase the reference count of a cached node, unless it is being destroyed
+
+    \identifier{294} */
+static bool count_up_alive(SXNode* n) {
+#ifdef CASADI_WITH_THREAD
+  unsigned int c = n->count.load();
+  while (c>0) {
+    if (n->count.compare_exchange_weak(c, c+1)) return true;
+  }
+  return false;
+#else // CASADI_WITH_THREAD
+  if (n->count==0) return false;
+  n->count++;
+  return true;
+#endif // CASADI_WITH_THREAD
+}
+
+#ifdef CASADI_WITH_THREAD
+/** \brief Protects the caches of constants in the derived classes
+
+ * (storage is allocated for it in sx_element.cpp)
+
+    \identifier{295} */
+static std::mutex cache_mutex_;
+#endif // CASADI_WITH_THREAD
+
 /** \brief  Print expression
 
     \identifier{1jo} */
@@ -108,29 +142,42 @@ class RealtypeSX : public ConstantSX {
 
     /// Destructor
     ~RealtypeSX() override {
-      size_t num_erased = cached_constants_.erase(value);
-      assert(num_erased==1);
-      (void)num_erased;
+#ifdef CASADI_WITH_THREAD
+      std::lock_guard<std::mutex> lock(cache_mutex_);
+#endif // CASADI_WITH_THREAD
+      // The entry may already have been taken over by a new node with the same value
+      CACHING_MAP<double, RealtypeSX*>::iterator it = cached_constants_.find(value);
+      if (it!=cached_constants_.end() && it->second==this) cached_constants_.erase(it);
     }
 
-    /// Static creator function (use instead of constructor)
+    /** \brief Static creator function (use instead of constructor)
+
+        The returned node holds a reference owned by the caller
+
+        \identifier{296} */
     inline static RealtypeSX* create(double value) {
+#ifdef CASADI_WITH_THREAD
+      std::lock_guard<std::mutex> lock(cache_mutex_);
+#endif // CASADI_WITH_THREAD
       // Try to find the constant
       CACHING_MAP<double, RealtypeSX*>::iterator it = cached_constants_.find(value);
 
-      // If not found, add it,
-      if (it==cached_constants_.end()) {
-        // Allocate a new object
-        RealtypeSX* n = new RealtypeSX(value);
+      // Reuse it, unless it is already being destroyed
+      if (it!=cached_constants_.end() && count_up_alive(it->second)) return it->second;
 
-        // Add to hash_table
-        cached_constants_.insert(it, std::make_pair(value, n));
+      // Allocate a new object
+      RealtypeSX* n = new RealtypeSX(value);
+      n->count++;
 
-        // Return it to caller
-        return n;
-      } else { // Else, returned the object
-        return it->second;
+      // Add to hash_table
+      if (it==cached_constants_.end()) {
+        cached_constants_.insert(std::make_pair(value, n));
+      } else {
+        it->second = n;
       }
+
+      // Return it to caller
+      return n;
     }
 
     ///@{
@@ -181,29 +228,42 @@ class IntegerSX : public ConstantSX {
 
     /// Destructor
     ~IntegerSX() override {
-      size_t num_erased = cached_constants_.erase(value);
-      assert(num_erased==1);
-      (void)num_erased;
+#ifdef CASADI_WITH_THREAD
+      std::lock_guard<std::mutex> lock(cache_mutex_);
+#endif // CASADI_WITH_THREAD
+      // The entry may already have been taken over by a new node with the same value
+      CACHING_MAP<casadi_int, IntegerSX*>::iterator it = cached_constants_.find(value);
+      if (it!=cached_constants_.end() && it->second==this) cached_constants_.erase(it);
     }
 
-    /// Static creator function (use instead of constructor)
+    /** \brief Static creator function (use instead of constructor)
+
+        The returned node holds a reference owned by the caller
+
+        \identifier{297} */
     inline static IntegerSX* create(casadi_int value) {
+#ifdef CASADI_WITH_THREAD
+      std::lock_guard<std::mutex> lock(cache_mutex_);
+#endif // CASADI_WITH_THREAD
       // Try to find the constant
       CACHING_MAP<casadi_int, IntegerSX*>::iterator it = cached_constants_.find(value);
 
-      // If not found, add it,
-      if (it==cached_constants_.end()) {
-        // Allocate a new object
-        IntegerSX* n = new IntegerSX(value);
+      // Reuse it, unless it is already being destroyed
+      if (it!=cached_constants_.end() && count_up_alive(it->second)) return it->second;
 
-        // Add to hash_table
-        cached_constants_.insert(it, std::make_pair(value, n));
+      // Allocate a new object
+      IntegerSX* n = new IntegerSX(value);
+      n->count++;
 
-        // Return it to caller
-        return n;
-      } else { // Else, returned the object
-        return it->second;
+      // Add to hash_table
+      if (it==cached_constants_.end()) {
+        cached_constants_.insert(std::make_pair(value, n));
+      } else {
+        it->second = n;
       }
+
+      // Return it to caller
+      return n;
     }
 
     ///@{
@@ -465,9 +525,10 @@ public:
 inline SXNode* ConstantSX_deserialize(DeserializingStream& s) {
   char type;
   s.unpack("ConstantSX::type", type);
+  SXNode* n;
   switch (type) {
-    case '1': return casadi_limits<SXElem>::one.get();
-    case '0': return casadi_limits<SXElem>::zero.get();
+    case '1': n = casadi_limits<SXElem>::one.get(); break;
+    case '0': n = casadi_limits<SXElem>::zero.get(); break;
     case 'r': {
       double value;
       s.unpack("ConstantSX::value", value);
@@ -476,15 +537,19 @@ inline SXNode* ConstantSX_deserialize(DeserializingStream& s) {
     case 'i': {
       int value;
       s.unpack("ConstantSX::value", value);
-      if (value==2) return casadi_limits<SXElem>::two.get();
-      return IntegerSX::create(value);
+      if (value!=2) return IntegerSX::create(value);
+      n = casadi_limits<SXElem>::two.get();
+      break;
     }
-    case 'n': return casadi_limits<SXElem>::nan.get();
-    case 'f': return casadi_limits<SXElem>::minus_inf.get();
-    case 'F': return casadi_limits<SXElem>::inf.get();
-    case 'm': return casadi_limits<SXElem>::minus_one.get();
+    case 'n': n = casadi_limits<SXElem>::nan.get(); break;
+    case 'f': n = casadi_limits<SXElem>::minus_inf.get(); break;
+    case 'F': n = casadi_limits<SXElem>::inf.get(); break;
+    case 'm': n = casadi_limits<SXElem>::minus_one.get(); break;
     default: casadi_error("ConstantSX::deserialize error");
   }
+  // Hand over a reference to the caller, as for the cached constants
+  n->count++;
+  return n;
 }
 
 } // namespace casadi
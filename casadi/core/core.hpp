@@ -61,6 +61,7 @@
 #include "integration_tools.hpp"
 #include "nlp_tools.hpp"
 #include "nlp_builder.hpp"
+#include "mx_substitution.hpp"
 #include "dae_builder.hpp"
 #include "xml_file.hpp"
 #include "optistack.hpp"
@@ -27,6 +27,7 @@
 #include "casadi_misc.hpp"
 #include "serializing_stream.hpp"
 #include "dae_builder_internal.hpp"
+#include "thread_pool.hpp"
 
 #include <fstream>
 #include <iostream>
@@ -37,14 +38,6 @@
 #include <omp.h>
 #endif // WITH_OPENMP
 
-#ifdef CASADI_WITH_THREAD
-#ifdef CASADI_WITH_THREAD_MINGW
-#include <mingw.thread.h>
-#else // CASADI_WITH_THREAD_MINGW
-#include <thread>
-#endif // CASADI_WITH_THREAD_MINGW
-#endif // CASADI_WITH_THREAD
-
 namespace casadi {
 
 int FmuFunction::init_mem(void* mem) const {
@@ -307,8 +300,8 @@ void FmuFunction::init(const Dict& opts) {
 #endif // WITH_OPENMP
 #ifdef CASADI_WITH_THREAD
     case Parallelization::THREAD:
-      max_n_tasks_ = std::thread::hardware_concurrency();
-      if (verbose_) casadi_message("std::thread using at most " + str(max_n_tasks_) + " threads");
+      max_n_tasks_ = ThreadPool::num_threads();
+      if (verbose_) casadi_message("Thread pool using at most " + str(max_n_tasks_) + " threads");
       break;
 #endif // CASADI_WITH_THREAD
     default:
@@ -936,22 +929,12 @@ int FmuFunction::eval_all(FmuMemory* m, casadi_int n_task,
     #endif  // WITH_OPENMP
   } else if (parallelization_ == Parallelization::THREAD) {
     #ifdef CASADI_WITH_THREAD
-    // Return value for each thread
-    std::vector<int> flag_task(n_task);
-    // Spawn threads
-    std::vector<std::thread> threads;
-    for (casadi_int task = 0; task < n_task; ++task) {
-      threads.emplace_back(
-        [&, task](int* fl) {
-          FmuMemory* s = task == 0 ? m : m->slaves.at(task - 1);
-          *fl = eval_task(s, task, n_task, need_nondiff && task == 0,
-            need_jac, need_fwd && task == 0, need_adj, need_hess);
-        }, &flag_task[task]);
-    }
-    // Join threads
-    for (auto&& th : threads) th.join();
-    // Join return flags
-    for (int fl : flag_task) flag = flag || fl;
+    // Evaluate tasks in the thread pool, one at a time
+    flag = ThreadPool::instance().run(n_task, [&](casadi_int task) {
+      FmuMemory* s = task == 0 ? m : m->slaves.at(task - 1);
+      return eval_task(s, task, n_task, need_nondiff && task == 0,
+        need_jac, need_fwd && task == 0, need_adj, need_hess);
+    }, 1);
     #else   // CASADI_WITH_THREAD
     flag = 1;
     #endif  // CASADI_WITH_THREAD
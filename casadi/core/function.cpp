@@ -332,6 +332,15 @@ namespace casadi {
     return Function(name, ex_in, ex_out, name_in(), name_out(), my_opts);
   }
 
+  Function Function::specialize(const std::string& name, const SX& v, const SX& vdef,
+      const Dict& opts) const {
+    try {
+      return (*this)->specialize(name, v, vdef, opts);
+    } catch(std::exception& e) {
+      THROW_ERROR("specialize", e.what());
+    }
+  }
+
   Function Function::create(FunctionInternal* node) {
     Function ret;
     ret.own(node);
@@ -208,6 +208,28 @@ namespace casadi {
                     const Dict& opts=Dict()) const;
     ///@}
 
+    /** \brief Derive a function with constants or free variables replaced
+
+        Every nonzero of \a v is a free variable of the function or the value of a
+        constant occurring in it. All its occurrences are replaced by the
+        corresponding nonzero of \a vdef, which is a constant or a symbol that is
+        not an input. A symbol becomes a free variable of the new function.
+        Constants are matched by value: replacing 3 also replaces e.g. the
+        exponent in pow(x, 3) and any other constant equal to 3.
+
+        The new function reuses the sorted algorithm and the work vector assignment
+        of this one. Only the operations depending on the replaced values are
+        regenerated, so that families of functions that only differ in a few
+        parameters can be created cheaply. If the new values allow some of these
+        operations to be simplified, the function is instead created from the
+        simplified expressions, as it is when \a opts contains options that change
+        the algorithm, i.e. cse or a different live_variables. Only defined for
+        SX Functions.
+
+        \identifier{298} */
+    Function specialize(const std::string& name, const SX& v, const SX& vdef,
+                        const Dict& opts=Dict()) const;
+
     /// \cond INTERNAL
 #ifndef SWIG
     /** \brief  Create from node
@@ -894,6 +916,12 @@ namespace casadi {
 
     /** \brief Save Function to a file
 
+        Options:
+        debug   [bool]  Add type decorations for checking during load
+        binary  [bool]  Write raw bytes instead of a text encoding.
+                        Produces files that are half the size and faster to load,
+                        at the cost of compatibility with older CasADi versions.
+
         \see load
 
         \identifier{240} */
@@ -42,6 +42,8 @@
 #include "integrator_impl.hpp"
 #include "external_impl.hpp"
 #include "fmu_function.hpp"
+#include "thread_pool.hpp"
+#include "casadi_meta.hpp"
 
 #include <cctype>
 #include <typeinfo>
@@ -60,6 +62,13 @@ namespace casadi {
     record_time_ = false;
     regularity_check_ = false;
     error_on_fail_ = true;
+    n_mem_prealloc_ = 1;
+#ifdef CASADI_WITH_THREAD
+    for (auto&& b : mem_block_) b = nullptr;
+    n_mem_ = 0;
+    unused_head_ = 0;
+    mem_contention_ = 0;
+#endif // CASADI_WITH_THREAD
   }
 
   FunctionInternal::FunctionInternal(const std::string& name) : ProtoFunction(name) {
@@ -115,10 +124,17 @@ namespace casadi {
   }
 
   ProtoFunction::~ProtoFunction() {
+#ifdef CASADI_WITH_THREAD
+    for (int i = 0; i < n_mem_; ++i) {
+      if (mem_slot(i).mem!=nullptr) casadi_warning("Memory object has not been properly freed");
+    }
+    for (auto&& b : mem_block_) delete[] b.load();
+#else // CASADI_WITH_THREAD
     for (void* m : mem_) {
       if (m!=nullptr) casadi_warning("Memory object has not been properly freed");
     }
     mem_.clear();
+#endif // CASADI_WITH_THREAD
   }
 
   FunctionInternal::~FunctionInternal() {
@@ -126,6 +142,12 @@ namespace casadi {
       std::string jit_directory = get_from_dict(jit_options_, "directory", std::string(""));
       std::string jit_name = jit_directory + jit_name_ + ".c";
       if (remove(jit_name.c_str())) casadi_warning("Failed to remove " + jit_name);
+      // Other translation units
+      casadi_int n_units = get_from_dict(jit_codegen_options_, "n_units", 1);
+      for (casadi_int k=1; k<n_units; ++k) {
+        jit_name = jit_directory + jit_name_ + "_" + str(k) + ".c";
+        if (remove(jit_name.c_str())) casadi_warning("Failed to remove " + jit_name);
+      }
     }
   }
 
@@ -172,7 +194,12 @@ namespace casadi {
         "Throw exceptions when NaN or Inf appears during evaluation"}},
       {"error_on_fail",
        {OT_BOOL,
-        "Throw exceptions when function evaluation fails (default true)."}}
+        "Throw exceptions when function evaluation fails (default true)."}},
+      {"n_mem_prealloc",
+       {OT_INT,
+        "Number of memory objects to allocate during initialization, "
+        "e.g. the number of threads that will evaluate the function concurrently. "
+        "Default: 1"}}
       }
   };
 
@@ -252,6 +279,10 @@ namespace casadi {
       {"jit_options",
        {OT_DICT,
         "Options to be passed to the jit compiler."}},
+      {"jit_codegen_options",
+       {OT_DICT,
+        "Options to be passed to the code generator for just-in-time compilation, "
+        "e.g. split_size and n_units to compile large functions in parallel."}},
       {"derivative_of",
        {OT_FUNCTION,
         "The function is a derivative of another function. "
@@ -317,7 +348,9 @@ namespace casadi {
         "Options to be passed to a reverse mode constructor"}},
       {"jacobian_options",
        {OT_DICT,
-        "Options to be passed to a Jacobian constructor"}},
+        "Options to be passed to a Jacobian constructor. "
+        "The entry 'parallelization' (serial|openmp|thread) distributes "
+        "the seed colors over parallel evaluations."}},
       {"der_options",
        {OT_DICT,
         "Default options to be used to populate forward_options, reverse_options, and "
@@ -360,8 +393,11 @@ namespace casadi {
         regularity_check_ = op.second;
       } else if (op.first=="error_on_fail") {
         error_on_fail_ = op.second;
+      } else if (op.first=="n_mem_prealloc") {
+        n_mem_prealloc_ = op.second;
       }
     }
+    casadi_assert(n_mem_prealloc_>=1, "Option 'n_mem_prealloc' must be positive");
   }
 
   Dict ProtoFunction::generate_options(const std::string& target) const {
@@ -371,6 +407,7 @@ namespace casadi {
     opts["record_time"] = record_time_;
     opts["regularity_check"] = regularity_check_;
     opts["error_on_fail"] = error_on_fail_;
+    opts["n_mem_prealloc"] = n_mem_prealloc_;
     return opts;
   }
 
@@ -384,6 +421,7 @@ namespace casadi {
     opts["jit_serialize"] = jit_serialize_;
     opts["compiler"] = compiler_plugin_;
     opts["jit_options"] = jit_options_;
+    opts["jit_codegen_options"] = jit_codegen_options_;
     opts["jit_name"] = jit_base_name_;
     opts["jit_temp_suffix"] = jit_temp_suffix_;
     opts["ad_weight"] = ad_weight_;
@@ -474,6 +512,8 @@ namespace casadi {
         compiler_plugin_ = op.second.to_string();
       } else if (op.first=="jit_options") {
         jit_options_ = op.second;
+      } else if (op.first=="jit_codegen_options") {
+        jit_codegen_options_ = op.second;
       } else if (op.first=="jit_name") {
         jit_base_name_ = op.second.to_string();
       } else if (op.first=="jit_temp_suffix") {
@@ -692,6 +732,7 @@ namespace casadi {
           Dict opts;
           // Override the default to avoid random strings in the generated code
           opts["prefix"] = "jit";
+          for (auto&& op : jit_codegen_options_) opts[op.first] = op.second;
           CodeGenerator gen(jit_name_, opts);
           gen.add(self());
           if (verbose_) casadi_message("Compiling function '" + name_ + "'..");
@@ -721,6 +762,10 @@ namespace casadi {
     // Create memory object
     int mem = checkout();
     casadi_assert_dev(mem==0);
+    // Preallocate additional memory objects
+    std::vector<int> prealloc;
+    for (casadi_int i=1; i<n_mem_prealloc_; ++i) prealloc.push_back(checkout());
+    for (auto it=prealloc.rbegin(); it!=prealloc.rend(); ++it) release(*it);
   }
 
   void FunctionInternal::generate_in(const std::string& fname, const double** arg) const {
@@ -963,6 +1008,9 @@ namespace casadi {
   }
 
   Dict FunctionInternal::cache() const {
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::recursive_mutex> lock(cache_mtx_);
+#endif // CASADI_WITH_THREAD
     // Return value
     Dict ret;
     // Add all Function instances that haven't been deleted
@@ -984,16 +1032,25 @@ namespace casadi {
 
   bool FunctionInternal::incache(const std::string& fname, Function& f,
       const std::string& suffix) const {
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::recursive_mutex> lock(cache_mtx_);
+#endif // CASADI_WITH_THREAD
     auto it = cache_.find(fname + ":" + suffix);
-    if (it!=cache_.end() && it->second.alive()) {
-      f = shared_cast<Function>(it->second.shared());
-      return true;
-    } else {
-      return false;
+    if (it!=cache_.end()) {
+      // May have been destroyed in the meantime
+      Function ref = shared_cast<Function>(it->second.shared());
+      if (!ref.is_null()) {
+        f = ref;
+        return true;
+      }
     }
+    return false;
   }
 
   void FunctionInternal::tocache(const Function& f, const std::string& suffix) const {
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::recursive_mutex> lock(cache_mtx_);
+#endif // CASADI_WITH_THREAD
     // Add to cache
     cache_.insert(std::make_pair(f.name() + ":" + suffix, f));
     // Remove a lost reference, if any, to prevent uncontrolled growth
@@ -1129,100 +1186,146 @@ namespace casadi {
     }
   };
 
+  template<bool fwd>
+  void FunctionInternal::sp_sweeps(casadi_int oind, casadi_int iind, casadi_int n,
+                                   const std::function<void(casadi_int, bvec_t*)>& seed,
+                                   const std::function<void(casadi_int, const bvec_t*)>& collect)
+                                   const {
+    // Evaluate sweeps [begin, end) with separate buffers
+    auto run = [&](casadi_int begin, casadi_int end, int mem) {
+      std::vector<typename JacSparsityTraits<fwd>::arg_t> arg(sz_arg(), nullptr);
+      std::vector<bvec_t*> res(sz_res(), nullptr);
+      std::vector<casadi_int> iw(sz_iw());
+      std::vector<bvec_t> w(sz_w(), 0);
+      std::vector<bvec_t> s_in(nnz_in(iind), 0), s_out(nnz_out(oind), 0);
+      arg[iind] = get_ptr(s_in);
+      res[oind] = get_ptr(s_out);
+      bvec_t* seed_v = fwd ? get_ptr(s_in) : get_ptr(s_out);
+      const bvec_t* sens_v = fwd ? get_ptr(s_out) : get_ptr(s_in);
+      for (casadi_int s=begin; s<end; ++s) {
+        seed(s, seed_v);
+        if (!fwd) std::fill(w.begin(), w.end(), 0);
+        JacSparsityTraits<fwd>::sp(this, get_ptr(arg), get_ptr(res),
+                                   get_ptr(iw), get_ptr(w), memory(mem));
+        collect(s, sens_v);
+        std::fill(s_in.begin(), s_in.end(), 0);
+        std::fill(s_out.begin(), s_out.end(), 0);
+      }
+      return 0;
+    };
+
+    // Quick return if possible
+    if (n==0) return;
+
+    // The first sweep is serial, so that lazily initialized data, e.g. the Jacobian
+    // sparsity patterns of embedded functions, is in place before going parallel
+    run(0, 1, 0);
+    if (n==1) return;
+
+    // Remaining sweeps in contiguous blocks, one memory object per block
+    casadi_int n_blocks = std::min(n - 1, ThreadPool::num_threads());
+    std::vector<int> mem(n_blocks);
+    for (casadi_int b=0; b<n_blocks; ++b) mem[b] = checkout();
+    try {
+      ThreadPool::instance().run(n_blocks, [&](casadi_int b) {
+        return run(1 + (b * (n - 1)) / n_blocks, 1 + ((b + 1) * (n - 1)) / n_blocks, mem[b]);
+      }, 1);
+    } catch (...) {
+      for (int m : mem) release(m);
+      throw;
+    }
+    for (int m : mem) release(m);
+  }
+
   template<bool fwd>
   Sparsity FunctionInternal::get_jac_sparsity_gen(casadi_int oind, casadi_int iind) const {
     // Number of nonzero inputs and outputs
     casadi_int nz_in = nnz_in(iind);
     casadi_int nz_out = nnz_out(oind);
 
-    // Evaluation buffers
-    std::vector<typename JacSparsityTraits<fwd>::arg_t> arg(sz_arg(), nullptr);
-    std::vector<bvec_t*> res(sz_res(), nullptr);
-    std::vector<casadi_int> iw(sz_iw());
-    std::vector<bvec_t> w(sz_w(), 0);
-
-    // Seeds and sensitivities
-    std::vector<bvec_t> seed(nz_in, 0);
-    arg[iind] = get_ptr(seed);
-    std::vector<bvec_t> sens(nz_out, 0);
-    res[oind] = get_ptr(sens);
-    if (!fwd) std::swap(seed, sens);
+    // Number of seed and sensitivity directions
+    casadi_int nz_seed = fwd ? nz_in : nz_out;
+    casadi_int nz_sens = fwd ? nz_out : nz_in;
 
     // Number of forward sweeps we must make
-    casadi_int nsweep = seed.size() / bvec_size;
-    if (seed.size() % bvec_size) nsweep++;
+    casadi_int nsweep = nz_seed / bvec_size;
+    if (nz_seed % bvec_size) nsweep++;
 
     // Print
     if (verbose_) {
       casadi_message(str(nsweep) + std::string(fwd ? " forward" : " reverse") + " sweeps "
-                     "needed for " + str(seed.size()) + " directions");
+                     "needed for " + str(nz_seed) + " directions");
     }
 
-    // Progress
-    casadi_int progress = -10;
+    // Progress, over the sweeps started so far
+    casadi_int progress = -10, n_started = 0;
+#ifdef CASADI_WITH_THREAD
+    std::mutex mtx_progress;
+#endif // CASADI_WITH_THREAD
 
-    // Temporary vectors
-    std::vector<casadi_int> jcol, jrow;
+    // Sparsity triplets found in each sweep
+    std::vector<std::vector<casadi_int> > jcol_s(nsweep), jrow_s(nsweep);
 
     // Loop over the variables, bvec_size variables at a time
-    for (casadi_int s=0; s<nsweep; ++s) {
-
-      // Print progress
-      if (verbose_) {
-        casadi_int progress_new = (s*100)/nsweep;
-        // Print when entering a new decade
-        if (progress_new / 10 > progress / 10) {
-          progress = progress_new;
-          casadi_message(str(progress) + " %");
+    sp_sweeps<fwd>(oind, iind, nsweep,
+      [&](casadi_int s, bvec_t* seed) {
+        // Print progress
+        if (verbose_) {
+#ifdef CASADI_WITH_THREAD
+          std::lock_guard<std::mutex> lock(mtx_progress);
+#endif // CASADI_WITH_THREAD
+          casadi_int progress_new = (n_started++*100)/nsweep;
+          // Print when entering a new decade
+          if (progress_new / 10 > progress / 10) {
+            progress = progress_new;
+            casadi_message(str(progress) + " %");
+          }
         }
-      }
-
-      // Nonzero offset
-      casadi_int offset = s*bvec_size;
-
-      // Number of local seed directions
-      casadi_int ndir_local = seed.size()-offset;
-      ndir_local = std::min(static_cast<casadi_int>(bvec_size), ndir_local);
-
-      for (casadi_int i=0; i<ndir_local; ++i) {
-        seed[offset+i] |= bvec_t(1)<<i;
-      }
-
-      // Propagate the dependencies
-      JacSparsityTraits<fwd>::sp(this, get_ptr(arg), get_ptr(res),
-                                  get_ptr(iw), get_ptr(w), memory(0));
 
-      // Loop over the nonzeros of the output
-      for (casadi_int el=0; el<sens.size(); ++el) {
+        // Nonzero offset
+        casadi_int offset = s*bvec_size;
 
-        // Get the sparsity sensitivity
-        bvec_t spsens = sens[el];
+        // Number of local seed directions
+        casadi_int ndir_local = std::min(static_cast<casadi_int>(bvec_size), nz_seed-offset);
 
-        if (!fwd) {
-          // Clear the sensitivities for the next sweep
-          sens[el] = 0;
+        for (casadi_int i=0; i<ndir_local; ++i) {
+          seed[offset+i] |= bvec_t(1)<<i;
         }
-
-        // If there is a dependency in any of the directions
-        if (spsens!=0) {
-
-          // Loop over seed directions
-          for (casadi_int i=0; i<ndir_local; ++i) {
-
-            // If dependents on the variable
-            if ((bvec_t(1) << i) & spsens) {
-              // Add to pattern
-              jcol.push_back(el);
-              jrow.push_back(i+offset);
+      },
+      [&](casadi_int s, const bvec_t* sens) {
+        casadi_int offset = s*bvec_size;
+        casadi_int ndir_local = std::min(static_cast<casadi_int>(bvec_size), nz_seed-offset);
+        std::vector<casadi_int>& jcol = jcol_s[s];
+        std::vector<casadi_int>& jrow = jrow_s[s];
+
+        // Loop over the nonzeros of the output
+        for (casadi_int el=0; el<nz_sens; ++el) {
+
+          // Get the sparsity sensitivity
+          bvec_t spsens = sens[el];
+
+          // If there is a dependency in any of the directions
+          if (spsens!=0) {
+
+            // Loop over seed directions
+            for (casadi_int i=0; i<ndir_local; ++i) {
+
+              // If dependents on the variable
+              if ((bvec_t(1) << i) & spsens) {
+                // Add to pattern
+                jcol.push_back(el);
+                jrow.push_back(i+offset);
+              }
             }
           }
         }
-      }
+      });
 
-      // Remove the seeds
-      for (casadi_int i=0; i<ndir_local; ++i) {
-        seed[offset+i] = 0;
-      }
+    // Collect the triplets in the order of the sweeps
+    std::vector<casadi_int> jcol, jrow;
+    for (casadi_int s=0; s<nsweep; ++s) {
+      jcol.insert(jcol.end(), jcol_s[s].begin(), jcol_s[s].end());
+      jrow.insert(jrow.end(), jrow_s[s].begin(), jrow_s[s].end());
     }
 
     // Construct sparsity pattern and return
@@ -1477,18 +1580,14 @@ namespace casadi {
     // Number of nonzero outputs
     casadi_int nz_out = nnz_out(oind);
 
-    // Seeds and sensitivities
-    std::vector<bvec_t> s_in(nz_in, 0);
-    std::vector<bvec_t> s_out(nz_out, 0);
-
-    // Evaluation buffers
-    std::vector<const bvec_t*> arg_fwd(sz_arg(), nullptr);
-    std::vector<bvec_t*> arg_adj(sz_arg(), nullptr);
-    arg_fwd[iind] = arg_adj[iind] = get_ptr(s_in);
-    std::vector<bvec_t*> res(sz_res(), nullptr);
-    res[oind] = get_ptr(s_out);
-    std::vector<casadi_int> iw(sz_iw());
-    std::vector<bvec_t> w(sz_w());
+    // Seeds and lookup table of a sweep
+    struct Sweep {
+      // Seeded ranges [begin, end) and the corresponding bit, stored as triplets
+      std::vector<casadi_int> toggle;
+      // Lookup table
+      IM lookup;
+    };
+    std::vector<Sweep> sweeps;
 
     // Sparsity triplet accumulator
     std::vector<casadi_int> jcol, jrow;
@@ -1567,16 +1666,13 @@ namespace casadi {
             "(fwd cost: " + str(fwd_cost) + ", adj cost: " + str(adj_cost) + ")");
       }
 
-      // Get seeds and sensitivities
-      bvec_t* seed_v = use_fwd ? get_ptr(s_in) : get_ptr(s_out);
-      bvec_t* sens_v = use_fwd ? get_ptr(s_out) : get_ptr(s_in);
-
       // The number of zeros in the seed and sensitivity directions
       casadi_int nz_seed = use_fwd ? nz_in  : nz_out;
       casadi_int nz_sens = use_fwd ? nz_out : nz_in;
 
-      // Clear the seeds
-      for (casadi_int i=0; i<nz_seed; ++i) seed_v[i]=0;
+      // Seeds of the current sweep
+      sweeps.clear();
+      std::vector<casadi_int> toggle;
 
       // Choose the active jacobian coloring scheme
       Sparsity D = use_fwd ? D1 : D2;
@@ -1667,8 +1763,9 @@ namespace casadi {
               }
 
               // Toggle on seeds
-              bvec_toggle(seed_v, fine_row[fci+fci_start], fine_row[fci+fci_start+1],
-                          bvec_i+bvec_i_mod);
+              toggle.push_back(fine_row[fci+fci_start]);
+              toggle.push_back(fine_row[fci+fci_start+1]);
+              toggle.push_back(bvec_i+bvec_i_mod);
               bvec_i_mod++;
             }
           }
@@ -1684,52 +1781,11 @@ namespace casadi {
             nsweeps+=1;
 
             // Construct lookup table
-            IM lookup = IM::triplet(lookup_row, lookup_col, lookup_value, bvec_size,
+            Sweep sw;
+            sw.toggle.swap(toggle);
+            sw.lookup = IM::triplet(lookup_row, lookup_col, lookup_value, bvec_size,
                                     coarse_col.size());
-
-            // Propagate the dependencies
-            if (use_fwd) {
-              JacSparsityTraits<true>::sp(this, get_ptr(arg_fwd), get_ptr(res),
-                get_ptr(iw), get_ptr(w), memory(0));
-            } else {
-              std::fill(w.begin(), w.end(), 0);
-              JacSparsityTraits<false>::sp(this, get_ptr(arg_adj), get_ptr(res),
-                get_ptr(iw), get_ptr(w), memory(0));
-            }
-
-            // Temporary bit work vector
-            bvec_t spsens;
-
-            // Loop over the cols of coarse blocks
-            for (casadi_int cri=0;cri<coarse_col.size()-1;++cri) {
-
-              // Loop over the cols of fine blocks within the current coarse block
-              for (casadi_int fri=fine_col_lookup[coarse_col[cri]];
-                   fri<fine_col_lookup[coarse_col[cri+1]];++fri) {
-                // Lump individual sensitivities together into fine block
-                bvec_or(sens_v, spsens, fine_col[fri], fine_col[fri+1]);
-
-                // Next iteration if no sparsity
-                if (!spsens) continue;
-
-                // Loop over all bvec_bits
-                for (casadi_int bvec_i=0;bvec_i<bvec_size;++bvec_i) {
-                  if (spsens & bvec_lookup[bvec_i]) {
-                    // if dependency is found, add it to the new sparsity pattern
-                    casadi_int ind = lookup.sparsity().get_nz(bvec_i, cri);
-                    if (ind==-1) continue;
-                    jrow.push_back(bvec_i+lookup->at(ind));
-                    jcol.push_back(fri);
-                  }
-                }
-              }
-            }
-
-            // Clear the forward seeds/adjoint sensitivities, ready for next bvec sweep
-            std::fill(s_in.begin(), s_in.end(), 0);
-
-            // Clear the adjoint seeds/forward sensitivities, ready for next bvec sweep
-            std::fill(s_out.begin(), s_out.end(), 0);
+            sweeps.push_back(sw);
 
             // Clean lookup table
             lookup_col.clear();
@@ -1749,6 +1805,61 @@ namespace casadi {
 
       }
 
+      // Sparsity triplets found in each sweep
+      std::vector<std::vector<casadi_int> > jrow_s(sweeps.size()), jcol_s(sweeps.size());
+
+      // Set the seeds of a sweep
+      auto seed = [&](casadi_int s, bvec_t* seed_v) {
+        const std::vector<casadi_int>& t = sweeps[s].toggle;
+        for (casadi_int k=0; k<t.size(); k+=3) bvec_toggle(seed_v, t[k], t[k+1], t[k+2]);
+      };
+
+      // Collect the dependencies found in a sweep
+      auto collect = [&](casadi_int s, const bvec_t* sens_v) {
+        const IM& lookup = sweeps[s].lookup;
+
+        // Temporary bit work vector
+        bvec_t spsens;
+
+        // Loop over the cols of coarse blocks
+        for (casadi_int cri=0;cri<coarse_col.size()-1;++cri) {
+
+          // Loop over the cols of fine blocks within the current coarse block
+          for (casadi_int fri=fine_col_lookup[coarse_col[cri]];
+               fri<fine_col_lookup[coarse_col[cri+1]];++fri) {
+            // Lump individual sensitivities together into fine block
+            bvec_or(sens_v, spsens, fine_col[fri], fine_col[fri+1]);
+
+            // Next iteration if no sparsity
+            if (!spsens) continue;
+
+            // Loop over all bvec_bits
+            for (casadi_int bvec_i=0;bvec_i<bvec_size;++bvec_i) {
+              if (spsens & bvec_lookup[bvec_i]) {
+                // if dependency is found, add it to the new sparsity pattern
+                casadi_int ind = lookup.sparsity().get_nz(bvec_i, cri);
+                if (ind==-1) continue;
+                jrow_s[s].push_back(bvec_i+lookup->at(ind));
+                jcol_s[s].push_back(fri);
+              }
+            }
+          }
+        }
+      };
+
+      // Propagate the dependencies
+      if (use_fwd) {
+        sp_sweeps<true>(oind, iind, sweeps.size(), seed, collect);
+      } else {
+        sp_sweeps<false>(oind, iind, sweeps.size(), seed, collect);
+      }
+
+      // Collect the triplets in the order of the sweeps
+      for (casadi_int s=0; s<sweeps.size(); ++s) {
+        jrow.insert(jrow.end(), jrow_s[s].begin(), jrow_s[s].end());
+        jcol.insert(jcol.end(), jcol_s[s].begin(), jcol_s[s].end());
+      }
+
       // Swap results if adjoint mode was used
       if (use_fwd) {
         // Construct fine sparsity pattern
@@ -1857,6 +1968,9 @@ namespace casadi {
 
   Sparsity& FunctionInternal::jac_sparsity(casadi_int oind, casadi_int iind, bool compact,
       bool symmetric) const {
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::recursive_mutex> lock(cache_mtx_);
+#endif // CASADI_WITH_THREAD
     // If first call, allocate cache
     for (bool c : {false, true}) {
       if (jac_sparsity_[c].empty()) jac_sparsity_[c].resize(n_in_ * n_out_);
@@ -1882,7 +1996,16 @@ namespace casadi {
         } else {
           // Use internal routine to determine sparsity
           if (has_spfwd() || has_sprev() || has_jac_sparsity(oind, iind)) {
-            sp = get_jac_sparsity(oind, iind, symmetric);
+            // Look up in the on-disk cache
+            std::string cached = sparsity_cache_path("jac_" + str(oind) + "_" + str(iind)
+                                                     + (symmetric ? "_symm" : ""));
+            std::vector<Sparsity> c;
+            if (!cached.empty() && sparsity_cache_get(cached, c) && c.size()==1) {
+              sp = c[0];
+            } else {
+              sp = get_jac_sparsity(oind, iind, symmetric);
+              if (!cached.empty() && !sp.is_null()) sparsity_cache_put(cached, {sp});
+            }
           }
           // If null, dense
           if (sp.is_null()) sp = Sparsity::dense(nnz_out(oind), nnz_in(iind));
@@ -1922,6 +2045,17 @@ namespace casadi {
     if (verbose_) casadi_message(name_ + "::get_partition");
     casadi_assert(allow_forward || allow_reverse, "Inconsistent options");
 
+    // Look up in the on-disk cache
+    std::string cached = sparsity_cache_path("partition_" + str(oind) + "_" + str(iind)
+      + "_" + str(compact) + str(symmetric) + str(allow_forward) + str(allow_reverse)
+      + "_" + str(ad_weight()));
+    std::vector<Sparsity> c;
+    if (!cached.empty() && sparsity_cache_get(cached, c) && c.size()==2) {
+      D1 = c[0];
+      D2 = c[1];
+      return;
+    }
+
     // Sparsity pattern with transpose
     Sparsity &AT = jac_sparsity(oind, iind, compact, symmetric);
     Sparsity A = symmetric ? AT : AT.T();
@@ -2013,6 +2147,74 @@ namespace casadi {
       }
 
     }
+
+    // Save to the on-disk cache
+    if (!cached.empty()) sparsity_cache_put(cached, {D1, D2});
+  }
+
+  std::string FunctionInternal::sparsity_cache_path(const std::string& entry) const {
+    if (GlobalOptions::sparsity_cache_directory.empty()) return std::string();
+    // Hash the serialized function, on first use
+    if (sparsity_cache_key_.empty()) {
+      try {
+        std::string buf = self().serialize() + CasadiMeta::version();
+        // 64-bit FNV-1a hash
+        uint64_t h = 14695981039346656037ULL;
+        for (char c : buf) {
+          h ^= static_cast<unsigned char>(c);
+          h *= 1099511628211ULL;
+        }
+        std::stringstream ss;
+        ss << std::hex << std::setw(16) << std::setfill('0') << h;
+        sparsity_cache_key_ = ss.str();
+      } catch (std::exception& e) {
+        if (verbose_) casadi_message("Sparsity cache not available: " + std::string(e.what()));
+        sparsity_cache_key_ = "-";
+      }
+    }
+    if (sparsity_cache_key_=="-") return std::string();
+    // Make sure that the directory ends with a separator
+    std::string dir = GlobalOptions::sparsity_cache_directory;
+    if (dir.back()!='/' && dir.back()!='\\') dir += filesep();
+    return dir + "casadi_sp_" + sparsity_cache_key_ + "_" + entry + ".casadi";
+  }
+
+  bool FunctionInternal::sparsity_cache_get(const std::string& path, std::vector<Sparsity>& sp) {
+    std::ifstream file(path, std::ios_base::binary);
+    if (!file.good()) return false;
+    try {
+      DeserializingStream s(file);
+      s.unpack("sparsity_cache", sp);
+    } catch (std::exception& e) {
+      casadi_warning("Ignoring corrupt sparsity cache entry '" + path + "': "
+                     + std::string(e.what()));
+      return false;
+    }
+    return true;
+  }
+
+  void FunctionInternal::sparsity_cache_put(const std::string& path,
+      const std::vector<Sparsity>& sp) {
+    // Write to a temporary file in the same directory, then publish atomically
+    std::string tmp;
+    try {
+      tmp = temporary_file(path.substr(0, path.size()-7) + "_", ".tmp");
+    } catch (std::exception& e) {
+      casadi_warning("Cannot write to sparsity cache: " + std::string(e.what()));
+      return;
+    }
+    {
+      std::ofstream file(tmp, std::ios_base::binary);
+      SerializingStream s(file);
+      s.pack("sparsity_cache", sp);
+      if (!file.good()) {
+        casadi_warning("Failed to write '" + tmp + "'.");
+        file.close();
+        remove(tmp.c_str());
+        return;
+      }
+    }
+    if (rename(tmp.c_str(), path.c_str())) remove(tmp.c_str());
   }
 
   std::vector<DM> FunctionInternal::eval_dm(const std::vector<DM>& arg) const {
@@ -2239,8 +2441,10 @@ namespace casadi {
   }
 
   Function FunctionInternal::jacobian() const {
+    // Distribute the seed colors over parallel evaluations?
+    bool parallel = jacobian_options_.find("parallelization")!=jacobian_options_.end();
     // Used wrapped function if jacobian not available
-    if (!has_jacobian()) {
+    if (!has_jacobian() && !parallel) {
       // Derivative information must be available
       casadi_assert(has_derivative(),
                             "Derivatives cannot be calculated for " + name_);
@@ -2266,8 +2470,14 @@ namespace casadi {
       Dict opts = combine(jacobian_options_, der_options_);
       opts["derivative_of"] = self();
       // Generate derivative function
-      casadi_assert_dev(enable_jacobian_);
-      f = get_jacobian(fname, inames, onames, opts);
+      if (parallel) {
+        std::string parallelization = opts["parallelization"].to_string();
+        opts.erase("parallelization");
+        f = get_jacobian_map(fname, inames, onames, parallelization, opts);
+      } else {
+        casadi_assert_dev(enable_jacobian_);
+        f = get_jacobian(fname, inames, onames, opts);
+      }
       // Consistency checks
       casadi_assert(f.n_in() == inames.size(),
         "Mismatching input signature, expected " + str(inames));
@@ -2279,6 +2489,126 @@ namespace casadi {
     return f;
   }
 
+  Function FunctionInternal::
+  get_jacobian_map(const std::string& name,
+                   const std::vector<std::string>& inames,
+                   const std::vector<std::string>& onames,
+                   const std::string& parallelization,
+                   const Dict& opts) const {
+    casadi_assert(has_derivative(), "Derivatives cannot be calculated for " + name_);
+
+    // Symbolic inputs and their nonzeros
+    std::vector<MX> arg = mx_in();
+    std::vector<MX> arg_nz(n_in_);
+    for (casadi_int i=0; i<n_in_; ++i) {
+      arg_nz[i] = MX::sparsity_cast(arg[i], Sparsity::dense(nnz_in(i)));
+    }
+    MX x = vertcat(arg_nz);
+
+    // Function from all input nonzeros to all output nonzeros
+    MX v = MX::sym("v", nnz_in());
+    std::vector<casadi_int> offset = {0};
+    for (casadi_int i=0; i<n_in_; ++i) offset.push_back(offset.back() + nnz_in(i));
+    std::vector<MX> v_split = vertsplit(v, offset);
+    for (casadi_int i=0; i<n_in_; ++i) {
+      v_split[i] = MX::sparsity_cast(v_split[i], sparsity_in(i));
+    }
+    std::vector<MX> r = self()(v_split);
+    for (casadi_int i=0; i<n_out_; ++i) {
+      r[i] = MX::sparsity_cast(r[i], Sparsity::dense(nnz_out(i)));
+    }
+    Function flat("flat_" + name, {v}, {vertcat(r)}, {{"ad_weight", ad_weight()}});
+
+    // Jacobian sparsity, in terms of nonzeros
+    Sparsity jsp = flat.jac_sparsity(0, 0);
+    std::vector<casadi_int> jsp_row = jsp.get_row(), jsp_col = jsp.get_col();
+
+    // Nonzeros of the Jacobian
+    MX jac_nz;
+    if (jsp.nnz()==0) {
+      jac_nz = MX(Sparsity(jsp.size()));
+    } else {
+      // Seed colors
+      Sparsity D1, D2;
+      flat->get_partition(0, 0, D1, D2, true, false, true, true);
+      bool fwd = !D1.is_null();
+      const Sparsity& D = fwd ? D1 : D2;
+      casadi_int n_dir = D.size2();
+
+      // Directions per evaluation, number of parallel evaluations
+      casadi_int n_task = std::min(n_dir, ThreadPool::num_threads());
+      casadi_int n_seed = (n_dir + n_task - 1) / n_task;
+      n_task = (n_dir + n_seed - 1) / n_seed;
+      if (verbose_) {
+        casadi_message(str(n_dir) + (fwd ? " forward" : " reverse") + " directions in "
+                       + str(n_task) + " evaluations");
+      }
+
+      // Seed matrix, color of each seeded nonzero
+      std::vector<casadi_int> color = D.get_col(), seeded = D.get_row();
+      casadi_int n_seeded = fwd ? jsp.size2() : jsp.size1();
+      DM seed = DM::ones(Sparsity::triplet(n_seeded, n_seed * n_task, seeded, color));
+      std::vector<casadi_int> color_of(n_seeded, -1);
+      for (casadi_int k=0; k<color.size(); ++k) color_of[seeded[k]] = color[k];
+
+      // Calculate the directional derivatives
+      Function dfun = fwd ? flat.forward(n_seed) : flat.reverse(n_seed);
+      dfun = dfun.map(n_task, parallelization);
+      MX out = MX(Sparsity(jsp.size1(), n_task));
+      MX sens = dfun(std::vector<MX>{repmat(x, 1, n_task), out, seed}).at(0);
+      sens = densify(sens);
+
+      // Pick the Jacobian nonzeros
+      std::vector<casadi_int> nz(jsp.nnz());
+      for (casadi_int k=0; k<nz.size(); ++k) {
+        if (fwd) {
+          nz[k] = color_of[jsp_col[k]] * jsp.size1() + jsp_row[k];
+        } else {
+          nz[k] = color_of[jsp_row[k]] * jsp.size2() + jsp_col[k];
+        }
+      }
+      jac_nz = sens->get_nzref(jsp, nz);
+    }
+
+    // Map nonzeros to elements of the vectorized inputs and outputs
+    std::vector<casadi_int> r_el, c_el, r_offset = {0}, c_offset = {0};
+    for (casadi_int i=0; i<n_out_; ++i) {
+      for (casadi_int e : sparsity_out(i).find()) r_el.push_back(r_offset.back() + e);
+      r_offset.push_back(r_offset.back() + numel_out(i));
+    }
+    for (casadi_int i=0; i<n_in_; ++i) {
+      for (casadi_int e : sparsity_in(i).find()) c_el.push_back(c_offset.back() + e);
+      c_offset.push_back(c_offset.back() + numel_in(i));
+    }
+    for (casadi_int& e : jsp_row) e = r_el[e];
+    for (casadi_int& e : jsp_col) e = c_el[e];
+    // The order of the nonzeros is preserved
+    Sparsity sp = Sparsity::triplet(r_offset.back(), c_offset.back(), jsp_row, jsp_col);
+    MX J = MX::sparsity_cast(jac_nz, sp);
+
+    // Split up Jacobian
+    std::vector<std::vector<MX> > Jblocks = MX::blocksplit(J, r_offset, c_offset);
+    std::vector<MX> ret_out;
+    ret_out.reserve(onames.size());
+    for (casadi_int i=0; i<n_out_; ++i) {
+      for (casadi_int j=0; j<n_in_; ++j) {
+        MX b = Jblocks.at(i).at(j);
+        if (!is_diff_out_.at(i) || !is_diff_in_.at(j)) b = MX(b.size());
+        ret_out.push_back(b);
+      }
+    }
+
+    // All inputs of the return function
+    std::vector<MX> ret_in = arg;
+    for (casadi_int i=0; i<n_out_; ++i) {
+      ret_in.push_back(MX::sym(inames[n_in_+i], Sparsity(size_out(i))));
+    }
+
+    Dict options = opts;
+    options["allow_duplicate_io_names"] = true;
+    return Function(name, ret_in, ret_out, inames, onames, options);
+  }
+
   Function FunctionInternal::
   get_jacobian(const std::string& name,
                const std::vector<std::string>& inames,
@@ -2470,7 +2800,9 @@ namespace casadi {
 
     // Determine work vector size
     casadi_int sz_w_codegen = sz_w();
-    if (is_a("SXFunction", true) && !g.avoid_stack()) sz_w_codegen = 0;
+    if (is_a("SXFunction", true) && !g.avoid_stack() && !g.split(n_instructions())) {
+      sz_w_codegen = 0;
+    }
 
     // Function that returns work vector lengths
     g << g.declare(
@@ -2865,6 +3197,14 @@ namespace casadi {
       stats["t_wall_" +s.first] = s.second.t_wall;
       stats["t_proc_" +s.first] = s.second.t_proc;
     }
+    // Memory object statistics
+#ifdef CASADI_WITH_THREAD
+    stats["n_mem"] = static_cast<casadi_int>(n_mem_);
+    stats["n_mem_contention"] = static_cast<casadi_int>(mem_contention_);
+#else // CASADI_WITH_THREAD
+    stats["n_mem"] = static_cast<casadi_int>(mem_.size());
+    stats["n_mem_contention"] = 0;
+#endif // CASADI_WITH_THREAD
     return stats;
   }
 
@@ -3259,6 +3599,11 @@ namespace casadi {
     casadi_error("'free_sx' only defined for 'SXFunction'");
   }
 
+  Function FunctionInternal::specialize(const std::string& name, const SX& v, const SX& vdef,
+      const Dict& opts) const {
+    casadi_error("'specialize' only defined for 'SXFunction'");
+  }
+
   void FunctionInternal::generate_lifted(Function& vdef_fcn,
                                          Function& vinit_fcn) const {
     casadi_error("'generate_lifted' only defined for 'MXFunction'");
@@ -3430,10 +3775,20 @@ namespace casadi {
   }
 
   void ProtoFunction::clear_mem() {
+#ifdef CASADI_WITH_THREAD
+    for (int i = 0; i < n_mem_; ++i) {
+      MemSlot& s = mem_slot(i);
+      if (s.mem!=nullptr) free_mem(s.mem);
+      s.mem = nullptr;
+    }
+    n_mem_ = 0;
+    unused_head_ = 0;
+#else // CASADI_WITH_THREAD
     for (auto&& i : mem_) {
       if (i!=nullptr) free_mem(i);
     }
     mem_.clear();
+#endif // CASADI_WITH_THREAD
   }
 
   size_t FunctionInternal::get_n_in() {
@@ -3530,17 +3885,81 @@ namespace casadi {
     return Sparsity::scalar();
   }
 
-  void* ProtoFunction::memory(int ind) const {
 #ifdef CASADI_WITH_THREAD
+  ProtoFunction::MemSlot& ProtoFunction::mem_slot(int ind) const {
+    // Block k holds memory objects 2^k-1, ..., 2^(k+1)-2
+    unsigned int ind1 = static_cast<unsigned int>(ind) + 1;
+    int k = 0;
+    while (ind1 >> (k + 1)) k++;
+    return mem_block_[k].load(std::memory_order_acquire)[ind1 - (1u << k)];
+  }
+
+  void* ProtoFunction::memory(int ind) const {
+    casadi_assert(ind>=0 && ind<n_mem_.load(std::memory_order_acquire),
+      "Memory object " + str(ind) + " out of range");
+    return mem_slot(ind).mem;
+  }
+
+  int ProtoFunction::checkout() const {
+    // Pop an unused memory object from the list, without locking
+    uint64_t head = unused_head_.load(std::memory_order_acquire);
+    while (true) {
+      int ind = static_cast<int>(head & 0xffffffffu) - 1;
+      if (ind < 0) break;
+      uint64_t next = static_cast<uint64_t>(mem_slot(ind).next.load(std::memory_order_relaxed) + 1);
+      uint64_t new_head = (((head >> 32) + 1) << 32) | next;
+      if (unused_head_.compare_exchange_weak(head, new_head,
+          std::memory_order_acq_rel, std::memory_order_acquire)) {
+        return ind;
+      }
+      mem_contention_++;
+    }
+    // Allocate a new memory object
     std::lock_guard<std::mutex> lock(mtx_);
-#endif //CASADI_WITH_THREAD
+    int ind = n_mem_.load(std::memory_order_relaxed);
+    unsigned int ind1 = static_cast<unsigned int>(ind) + 1;
+    int k = 0;
+    while (ind1 >> (k + 1)) k++;
+    casadi_assert(k < max_mem_block, "Too many memory objects");
+    if (mem_block_[k].load(std::memory_order_relaxed) == nullptr) {
+      MemSlot* b = new MemSlot[1u << k];
+      for (unsigned int j = 0; j < (1u << k); ++j) {
+        b[j].mem = nullptr;
+        b[j].next = -1;
+      }
+      mem_block_[k].store(b, std::memory_order_release);
+    }
+    void* m = alloc_mem();
+    if (init_mem(m)) {
+      free_mem(m);
+      casadi_error("Failed to create or initialize memory object");
+    }
+    // Publish only once initialized
+    mem_slot(ind).mem = m;
+    n_mem_.store(ind + 1, std::memory_order_release);
+    return ind;
+  }
+
+  void ProtoFunction::release(int mem) const {
+    // Push onto the list of unused memory objects, without locking
+    MemSlot& s = mem_slot(mem);
+    uint64_t head = unused_head_.load(std::memory_order_relaxed);
+    while (true) {
+      s.next.store(static_cast<int>(head & 0xffffffffu) - 1, std::memory_order_relaxed);
+      uint64_t new_head = (((head >> 32) + 1) << 32) | static_cast<uint64_t>(mem + 1);
+      if (unused_head_.compare_exchange_weak(head, new_head,
+          std::memory_order_release, std::memory_order_relaxed)) {
+        return;
+      }
+      mem_contention_++;
+    }
+  }
+#else // CASADI_WITH_THREAD
+  void* ProtoFunction::memory(int ind) const {
     return mem_.at(ind);
   }
 
   int ProtoFunction::checkout() const {
-#ifdef CASADI_WITH_THREAD
-    std::lock_guard<std::mutex> lock(mtx_);
-#endif //CASADI_WITH_THREAD
     if (unused_.empty()) {
       // Allocate a new memory object
       void* m = alloc_mem();
@@ -3558,11 +3977,9 @@ namespace casadi {
   }
 
   void ProtoFunction::release(int mem) const {
-#ifdef CASADI_WITH_THREAD
-    std::lock_guard<std::mutex> lock(mtx_);
-#endif //CASADI_WITH_THREAD
     unused_.push(mem);
   }
+#endif // CASADI_WITH_THREAD
 
   Function FunctionInternal::
   factory(const std::string& name,
@@ -3826,23 +4243,32 @@ namespace casadi {
   }
 
   void ProtoFunction::serialize_body(SerializingStream& s) const {
-    s.version("ProtoFunction", 2);
+    s.version("ProtoFunction", 3);
     s.pack("ProtoFunction::name", name_);
     s.pack("ProtoFunction::verbose", verbose_);
     s.pack("ProtoFunction::print_time", print_time_);
     s.pack("ProtoFunction::record_time", record_time_);
     s.pack("ProtoFunction::regularity_check", regularity_check_);
     s.pack("ProtoFunction::error_on_fail", error_on_fail_);
+    s.pack("ProtoFunction::n_mem_prealloc", n_mem_prealloc_);
   }
 
   ProtoFunction::ProtoFunction(DeserializingStream& s) {
-    int version = s.version("ProtoFunction", 1, 2);
+    int version = s.version("ProtoFunction", 1, 3);
     s.unpack("ProtoFunction::name", name_);
     s.unpack("ProtoFunction::verbose", verbose_);
     s.unpack("ProtoFunction::print_time", print_time_);
     s.unpack("ProtoFunction::record_time", record_time_);
     if (version >= 2) s.unpack("ProtoFunction::regularity_check", regularity_check_);
     if (version >= 2) s.unpack("ProtoFunction::error_on_fail", error_on_fail_);
+    n_mem_prealloc_ = 1;
+    if (version >= 3) s.unpack("ProtoFunction::n_mem_prealloc", n_mem_prealloc_);
+#ifdef CASADI_WITH_THREAD
+    for (auto&& b : mem_block_) b = nullptr;
+    n_mem_ = 0;
+    unused_head_ = 0;
+    mem_contention_ = 0;
+#endif // CASADI_WITH_THREAD
   }
 
   void FunctionInternal::serialize_type(SerializingStream &s) const {
@@ -3851,7 +4277,7 @@ namespace casadi {
 
   void FunctionInternal::serialize_body(SerializingStream& s) const {
     ProtoFunction::serialize_body(s);
-    s.version("FunctionInternal", 6);
+    s.version("FunctionInternal", 7);
     s.pack("FunctionInternal::is_diff_in", is_diff_in_);
     s.pack("FunctionInternal::is_diff_out", is_diff_out_);
     s.pack("FunctionInternal::sp_in", sparsity_in_);
@@ -3873,6 +4299,7 @@ namespace casadi {
     s.pack("FunctionInternal::jit_temp_suffix", jit_temp_suffix_);
     s.pack("FunctionInternal::jit_base_name", jit_base_name_);
     s.pack("FunctionInternal::jit_options", jit_options_);
+    s.pack("FunctionInternal::jit_codegen_options", jit_codegen_options_);
     s.pack("FunctionInternal::compiler_plugin", compiler_plugin_);
     s.pack("FunctionInternal::has_refcount", has_refcount_);
 
@@ -3927,7 +4354,7 @@ namespace casadi {
   }
 
   FunctionInternal::FunctionInternal(DeserializingStream& s) : ProtoFunction(s) {
-    int version = s.version("FunctionInternal", 1, 6);
+    int version = s.version("FunctionInternal", 1, 7);
     s.unpack("FunctionInternal::is_diff_in", is_diff_in_);
     s.unpack("FunctionInternal::is_diff_out", is_diff_out_);
     s.unpack("FunctionInternal::sp_in", sparsity_in_);
@@ -3962,6 +4389,9 @@ namespace casadi {
     s.unpack("FunctionInternal::jit_temp_suffix", jit_temp_suffix_);
     s.unpack("FunctionInternal::jit_base_name", jit_base_name_);
     s.unpack("FunctionInternal::jit_options", jit_options_);
+    if (version >= 7) {
+      s.unpack("FunctionInternal::jit_codegen_options", jit_codegen_options_);
+    }
     s.unpack("FunctionInternal::compiler_plugin", compiler_plugin_);
     s.unpack("FunctionInternal::has_refcount", has_refcount_);
 
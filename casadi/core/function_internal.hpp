@@ -29,6 +29,7 @@
 #include "function.hpp"
 #include <set>
 #include <stack>
+#include <functional>
 #include "code_generator.hpp"
 #include "importer.hpp"
 #include "options.hpp"
@@ -40,6 +41,7 @@
 #else // CASADI_WITH_THREAD_MINGW
 #include <mutex>
 #endif // CASADI_WITH_THREAD_MINGW
+#include <atomic>
 #endif //CASADI_WITH_THREAD
 
 // This macro is for documentation purposes
@@ -248,6 +250,9 @@ namespace casadi {
     /// Throw an exception on failure?
     bool error_on_fail_;
 
+    /// Number of memory objects to allocate during initialization
+    casadi_int n_mem_prealloc_;
+
   protected:
     /** \brief Deserializing constructor
 
@@ -260,11 +265,44 @@ namespace casadi {
 #endif // CASADI_WITH_THREAD
 
   private:
+#ifdef CASADI_WITH_THREAD
+    /** \brief Slot holding a memory object
+
+        Memory objects are stored in blocks of doubling size which are never moved,
+        block k holding objects 2^k-1, ..., 2^(k+1)-2. This allows memory() and the
+        checkout of unused memory objects to proceed without locking.
+
+        \identifier{280} */
+    struct MemSlot {
+      void* mem;
+      // Next unused memory object, -1 if none
+      std::atomic<int> next;
+    };
+
+    /// Maximum number of memory blocks
+    static const int max_mem_block = 31;
+
+    /// Memory slot corresponding to a memory object
+    MemSlot& mem_slot(int ind) const;
+
+    /// Blocks of memory slots, allocated on demand
+    mutable std::atomic<MemSlot*> mem_block_[max_mem_block];
+
+    /// Number of memory objects
+    mutable std::atomic<int> n_mem_;
+
+    /// Head of the list of unused memory objects: ABA tag and index+1 packed in 32 bits each
+    mutable std::atomic<uint64_t> unused_head_;
+
+    /// Number of times the list of unused memory objects was contended
+    mutable std::atomic<casadi_int> mem_contention_;
+#else // CASADI_WITH_THREAD
     /// Memory objects
     mutable std::vector<void*> mem_;
 
     /// Unused memory objects
     mutable std::stack<int> unused_;
+#endif // CASADI_WITH_THREAD
   };
 
   /** \brief Internal class for Function
@@ -591,6 +629,19 @@ namespace casadi {
                                   const Dict& opts) const;
     ///@}
 
+    /** \brief Jacobian with the seed colors distributed over parallel evaluations
+
+        The directional derivatives are calculated by a single forward or reverse mode
+        function, mapped over groups of seed colors with the given parallelization.
+        Used when the option 'parallelization' is passed in jacobian_options.
+
+        \identifier{28d} */
+    Function get_jacobian_map(const std::string& name,
+                              const std::vector<std::string>& inames,
+                              const std::vector<std::string>& onames,
+                              const std::string& parallelization,
+                              const Dict& opts) const;
+
     ///@{
     /** \brief Get Jacobian sparsity
 
@@ -704,6 +755,10 @@ namespace casadi {
     /// Get free variables (SX)
     virtual std::vector<SX> free_sx() const;
 
+    /// Derive a function with constants or free variables replaced
+    virtual Function specialize(const std::string& name, const SX& v, const SX& vdef,
+                                const Dict& opts) const;
+
     /** \brief Does the function have free variables
 
         \identifier{l8} */
@@ -986,10 +1041,40 @@ namespace casadi {
     /// Convert from compact Jacobian sparsity pattern
     Sparsity from_compact(casadi_int oind, casadi_int iind, const Sparsity& sp) const;
 
+    /** \brief Path of an entry in the on-disk sparsity cache
+
+        \return Empty string if caching is disabled or the function cannot be serialized
+
+        \identifier{28e} */
+    std::string sparsity_cache_path(const std::string& entry) const;
+
+    /** \brief Read sparsity patterns from the on-disk sparsity cache
+
+        \return true on a hit
+
+        \identifier{28f} */
+    static bool sparsity_cache_get(const std::string& path, std::vector<Sparsity>& sp);
+
+    /** \brief Write sparsity patterns to the on-disk sparsity cache
+
+        \identifier{28g} */
+    static void sparsity_cache_put(const std::string& path, const std::vector<Sparsity>& sp);
+
     /// Get the sparsity pattern via sparsity seed propagation
     template<bool fwd>
     Sparsity get_jac_sparsity_gen(casadi_int oind, casadi_int iind) const;
 
+    /** \brief Independent sweeps of sparsity seed propagation, distributed over the thread pool
+
+        For sweep s, seed(s, v) sets the seeds, collect(s, v) reads the sensitivities.
+        Both must only access data belonging to sweep s.
+
+        \identifier{28h} */
+    template<bool fwd>
+    void sp_sweeps(casadi_int oind, casadi_int iind, casadi_int n,
+                   const std::function<void(casadi_int, bvec_t*)>& seed,
+                   const std::function<void(casadi_int, const bvec_t*)>& collect) const;
+
     /// A flavor of get_jac_sparsity_gen that does hierarchical block structure recognition
     Sparsity get_jac_sparsity_hierarchical(casadi_int oind, casadi_int iind) const;
 
@@ -1288,6 +1373,14 @@ namespace casadi {
     /// Cache for sparsities of the Jacobian blocks
     mutable std::vector<Sparsity> jac_sparsity_[2];
 
+#ifdef CASADI_WITH_THREAD
+    /// Protects the caches above, the function may be shared between threads
+    mutable std::recursive_mutex cache_mtx_;
+#endif // CASADI_WITH_THREAD
+
+    /// Key of the function in the on-disk sparsity cache, "-" if not available
+    mutable std::string sparsity_cache_key_;
+
     /// If the function is the derivative of another function
     Function derivative_of_;
 
@@ -1299,6 +1392,9 @@ namespace casadi {
     Importer compiler_;
     Dict jit_options_;
 
+    /// Options for the code generator, for just-in-time compilation
+    Dict jit_codegen_options_;
+
     /// Penalty factor for using a complete Jacobian to calculate directional derivatives
     double jac_penalty_;
 
@@ -28,14 +28,27 @@
 
 namespace casadi {
 
+#ifdef CASADI_WITH_THREAD
+  std::atomic<bool> GlobalOptions::simplification_on_the_fly(true);
+  std::atomic<bool> GlobalOptions::hierarchical_sparsity(true);
+#else // CASADI_WITH_THREAD
   bool GlobalOptions::simplification_on_the_fly = true;
   bool GlobalOptions::hierarchical_sparsity = true;
+#endif // CASADI_WITH_THREAD
 
   std::string GlobalOptions::casadipath;
   std::string GlobalOptions::casadi_include_path;
 
   casadi_int GlobalOptions::max_num_dir = 64;
 
+  casadi_int GlobalOptions::thread_pool_size = 0;
+  casadi_int GlobalOptions::thread_pool_chunk_size = 0;
+
+  std::string GlobalOptions::jit_cache_directory;
+  casadi_int GlobalOptions::jit_cache_max_size = 0;
+
+  std::string GlobalOptions::sparsity_cache_directory;
+
   // By default, use zero-based indexing
   casadi_int GlobalOptions::start_index = 0;
 
@@ -32,6 +32,10 @@
 #include "casadi/core/casadi_common.hpp"
 #include <casadi/core/casadi_export.h>
 
+#ifdef CASADI_WITH_THREAD
+#include <atomic>
+#endif // CASADI_WITH_THREAD
+
 namespace casadi {
 
   /** \brief Collects global CasADi options
@@ -56,20 +60,69 @@ namespace casadi {
 
       * e.g.   cos(-x) -> cos(x)
       * Default: true
+      * Read while expressions are being constructed, atomic if built WITH_THREAD
 
           \identifier{17v} */
+#ifdef CASADI_WITH_THREAD
+      static std::atomic<bool> simplification_on_the_fly;
+#else // CASADI_WITH_THREAD
       static bool simplification_on_the_fly;
+#endif // CASADI_WITH_THREAD
 
       static std::string casadipath;
 
       static std::string casadi_include_path;
 
+#ifdef CASADI_WITH_THREAD
+      static std::atomic<bool> hierarchical_sparsity;
+#else // CASADI_WITH_THREAD
       static bool hierarchical_sparsity;
+#endif // CASADI_WITH_THREAD
 
       static casadi_int max_num_dir;
 
       static casadi_int start_index;
 
+      /** \brief Number of threads used by parallel evaluation with std::thread
+
+      * Includes the calling thread. Zero means std::thread::hardware_concurrency().
+      * Default: 0
+
+          \identifier{27t} */
+      static casadi_int thread_pool_size;
+
+      /** \brief Number of loop indices handed out to a thread at a time
+
+      * Zero means automatic, i.e. about four chunks per thread.
+      * Default: 0
+
+          \identifier{27u} */
+      static casadi_int thread_pool_chunk_size;
+
+      /** \brief Directory of the on-disk cache of just-in-time compiled code
+
+      * Shared between processes. Empty means no caching.
+      * Default: empty
+
+          \identifier{283} */
+      static std::string jit_cache_directory;
+
+      /** \brief Maximum size of the just-in-time compilation cache in bytes
+
+      * The least recently used entries are removed when exceeded. Zero means no limit.
+      * Default: 0
+
+          \identifier{284} */
+      static casadi_int jit_cache_max_size;
+
+      /** \brief Directory of the on-disk cache of Jacobian sparsity patterns and colorings
+
+      * Entries are keyed by a hash of the serialized function. Empty means no caching.
+      * Default: empty
+
+          \identifier{28c} */
+      static std::string sparsity_cache_directory;
+
 #endif //SWIG
       // Setter and getter for simplification_on_the_fly
       static void setSimplificationOnTheFly(bool flag) { simplification_on_the_fly = flag; }
@@ -88,6 +141,23 @@ namespace casadi {
       static void setMaxNumDir(casadi_int ndir) { max_num_dir=ndir; }
       static casadi_int getMaxNumDir() { return max_num_dir; }
 
+      static void setThreadPoolSize(casadi_int n) { thread_pool_size=n; }
+      static casadi_int getThreadPoolSize() { return thread_pool_size; }
+
+      static void setThreadPoolChunkSize(casadi_int n) { thread_pool_chunk_size=n; }
+      static casadi_int getThreadPoolChunkSize() { return thread_pool_chunk_size; }
+
+      static void setJitCacheDirectory(const std::string & dir) { jit_cache_directory = dir; }
+      static std::string getJitCacheDirectory() { return jit_cache_directory; }
+
+      static void setJitCacheMaxSize(casadi_int n) { jit_cache_max_size=n; }
+      static casadi_int getJitCacheMaxSize() { return jit_cache_max_size; }
+
+      static void setSparsityCacheDirectory(const std::string & dir) {
+        sparsity_cache_directory = dir;
+      }
+      static std::string getSparsityCacheDirectory() { return sparsity_cache_directory; }
+
   };
 
 } // namespace casadi
@@ -68,6 +68,10 @@ namespace casadi {
     return ImporterInternal::getPlugin(name).doc;
   }
 
+  Dict Importer::cache_stats() {
+    return ImporterInternal::cache_stats();
+  }
+
   std::string Importer::plugin_name() const {
     return (*this)->plugin_name();
   }
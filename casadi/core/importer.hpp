@@ -114,6 +114,14 @@ namespace casadi {
     /// Get solver specific documentation
     static std::string doc(const std::string& name);
 
+    /** \brief Statistics of the on-disk cache of compiled code
+
+        Number of hits, misses, stored entries and evicted entries,
+        accumulated over the process.
+
+        \identifier{289} */
+    static Dict cache_stats();
+
     /// Query plugin name
     std::string plugin_name() const;
 
@@ -24,11 +24,43 @@
 
 
 #include "importer_internal.hpp"
+#include "casadi_meta.hpp"
+#include "casadi_os.hpp"
+#include "global_options.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <tuple>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <windows.h>
+#include <sys/utime.h>
+#else // _WIN32
+#include <dirent.h>
+#include <utime.h>
+#endif // _WIN32
+#ifdef CASADI_WITH_THREAD
+#include <atomic>
+#endif // CASADI_WITH_THREAD
 
 namespace casadi {
 
+  // Cache statistics
+#ifdef CASADI_WITH_THREAD
+  typedef std::atomic<casadi_int> cache_counter_t;
+#else // CASADI_WITH_THREAD
+  typedef casadi_int cache_counter_t;
+#endif // CASADI_WITH_THREAD
+  static cache_counter_t cache_hits(0), cache_misses(0), cache_stores(0), cache_evictions(0);
+
+  // Prefix of file names in the cache
+  static const std::string cache_prefix = "casadi_jit_";
+
   ImporterInternal::ImporterInternal(const std::string& name) : name_(name) {
     verbose_ = false;
+    cache_directory_ = GlobalOptions::jit_cache_directory;
+    cache_max_size_ = GlobalOptions::jit_cache_max_size;
   }
 
   ImporterInternal::~ImporterInternal() {
@@ -45,7 +77,15 @@ namespace casadi {
   = {{},
      {{"verbose",
        {OT_BOOL,
-        "Verbose evaluation -- for debugging"}}
+        "Verbose evaluation -- for debugging"}},
+      {"cache_directory",
+       {OT_STRING,
+        "Directory of an on-disk cache of compiled code, shared between processes. "
+        "Empty string disables the cache. Default: GlobalOptions::getJitCacheDirectory()"}},
+      {"cache_max_size",
+       {OT_INT,
+        "Maximum size of the cache in bytes, zero for no limit. "
+        "Default: GlobalOptions::getJitCacheMaxSize()"}}
       }
     };
 
@@ -120,8 +160,167 @@ namespace casadi {
     for (auto&& op : opts) {
       if (op.first=="verbose") {
         verbose_ = op.second;
+      } else if (op.first=="cache_directory") {
+        cache_directory_ = op.second.to_string();
+      } else if (op.first=="cache_max_size") {
+        cache_max_size_ = op.second;
+      }
+    }
+
+    // Cache directory must end with a file separator
+    if (!cache_directory_.empty()) {
+      char last = cache_directory_.back();
+      if (last!='/' && last!='\\') cache_directory_ += filesep();
+    }
+  }
+
+  std::vector<std::string> ImporterInternal::units() const {
+    std::vector<std::string> ret;
+    if (!has_meta("units")) return ret;
+    // Relative to the directory of the source file
+    std::string dir = name_.substr(0, name_.find_last_of("/\\") + 1);
+    std::istringstream ss(get_meta("units"));
+    std::string u;
+    while (ss >> u) ret.push_back(dir + u);
+    return ret;
+  }
+
+  std::string ImporterInternal::cache_key(const std::string& config) const {
+    // 64-bit FNV-1a hash
+    uint64_t h = 14695981039346656037ULL;
+    auto hash = [&h](const char* s, size_t n) {
+      for (size_t i=0; i<n; ++i) {
+        h ^= static_cast<unsigned char>(s[i]);
+        h *= 1099511628211ULL;
+      }
+    };
+    char buf[4096];
+    std::vector<std::string> sources = units();
+    sources.insert(sources.begin(), name_);
+    for (auto&& src : sources) {
+      std::ifstream file(src, std::ios_base::binary);
+      casadi_assert(file.good(), "Cannot open source file '" + src + "'.");
+      while (file.read(buf, sizeof(buf)) || file.gcount()>0) hash(buf, file.gcount());
+      hash("", 1);
+    }
+    hash(config.c_str(), config.size());
+    hash(plugin_name(), std::char_traits<char>::length(plugin_name()));
+    hash(CasadiMeta::version(), std::char_traits<char>::length(CasadiMeta::version()));
+    // Hexadecimal representation
+    std::stringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << h;
+    return ss.str();
+  }
+
+  bool ImporterInternal::cache_get(const std::string& key, const std::string& suffix,
+      std::string& path) const {
+    std::string cached = cache_directory_ + cache_prefix + key + suffix;
+    std::ifstream file(cached);
+    if (!file.good()) {
+      cache_misses++;
+      if (verbose_) casadi_message("Cache miss for '" + cached + "'");
+      return false;
+    }
+    // Mark as recently used
+    utime(cached.c_str(), nullptr);
+    cache_hits++;
+    if (verbose_) casadi_message("Cache hit for '" + cached + "'");
+    path = cached;
+    return true;
+  }
+
+  std::string ImporterInternal::cache_put(const std::string& key, const std::string& suffix,
+      const std::string& file) const {
+    std::string cached = cache_directory_ + cache_prefix + key + suffix;
+    // Copy to a temporary file in the same directory
+    std::string tmp;
+    try {
+      tmp = temporary_file(cache_directory_ + cache_prefix + key + "_", ".tmp");
+    } catch (std::exception& e) {
+      casadi_warning("Cannot write to cache directory '" + cache_directory_ + "': "
+                     + std::string(e.what()));
+      return std::string();
+    }
+    {
+      std::ifstream src(file, std::ios_base::binary);
+      std::ofstream dst(tmp, std::ios_base::binary);
+      dst << src.rdbuf();
+      if (!src.good() || !dst.good()) {
+        casadi_warning("Failed to copy '" + file + "' to cache.");
+        dst.close();
+        remove(tmp.c_str());
+        return std::string();
+      }
+    }
+    // Publish atomically
+    if (rename(tmp.c_str(), cached.c_str())) {
+      // E.g. Windows, where the entry may have been published by another process
+      remove(tmp.c_str());
+      std::ifstream existing(cached);
+      if (!existing.good()) return std::string();
+    } else {
+      cache_stores++;
+    }
+
+    // Enforce size limit
+    if (cache_max_size_>0) {
+      // Entries: modification time, size and name
+      std::vector<std::tuple<int64_t, int64_t, std::string> > entries;
+#ifdef _WIN32
+      WIN32_FIND_DATAA fd;
+      HANDLE h = FindFirstFileA((cache_directory_ + cache_prefix + "*").c_str(), &fd);
+      if (h!=INVALID_HANDLE_VALUE) {
+        do {
+          int64_t t = (static_cast<int64_t>(fd.ftLastWriteTime.dwHighDateTime) << 32)
+            | fd.ftLastWriteTime.dwLowDateTime;
+          int64_t sz = (static_cast<int64_t>(fd.nFileSizeHigh) << 32) | fd.nFileSizeLow;
+          entries.emplace_back(t, sz, fd.cFileName);
+        } while (FindNextFileA(h, &fd));
+        FindClose(h);
+      }
+#else // _WIN32
+      DIR* dir = opendir(cache_directory_.c_str());
+      if (dir) {
+        while (struct dirent* de = readdir(dir)) {
+          std::string name = de->d_name;
+          if (name.compare(0, cache_prefix.size(), cache_prefix)!=0) continue;
+          struct stat st;
+          if (stat((cache_directory_ + name).c_str(), &st)) continue;
+          entries.emplace_back(st.st_mtime, st.st_size, name);
+        }
+        closedir(dir);
+      }
+#endif // _WIN32
+      // Files being written by other processes are not counted
+      int64_t total = 0;
+      for (auto&& e : entries) {
+        const std::string& name = std::get<2>(e);
+        if (name.size()<4 || name.compare(name.size()-4, 4, ".tmp")!=0) total += std::get<1>(e);
+      }
+      // Remove least recently used entries, keeping the new one
+      std::sort(entries.begin(), entries.end());
+      for (auto&& e : entries) {
+        if (total<=cache_max_size_) break;
+        const std::string& name = std::get<2>(e);
+        if (name.size()>=4 && name.compare(name.size()-4, 4, ".tmp")==0) continue;
+        std::string path = cache_directory_ + name;
+        if (path==cached) continue;
+        if (remove(path.c_str())==0) {
+          total -= std::get<1>(e);
+          cache_evictions++;
+        }
       }
     }
+    return cached;
+  }
+
+  Dict ImporterInternal::cache_stats() {
+    Dict stats;
+    stats["hits"] = static_cast<casadi_int>(cache_hits);
+    stats["misses"] = static_cast<casadi_int>(cache_misses);
+    stats["stores"] = static_cast<casadi_int>(cache_stores);
+    stats["evictions"] = static_cast<casadi_int>(cache_evictions);
+    return stats;
   }
 
   void ImporterInternal::read_meta(std::istream& file, casadi_int& offset) {
@@ -304,6 +503,9 @@ namespace casadi {
   }
 
   ImporterInternal::ImporterInternal(DeserializingStream& s) {
+    verbose_ = false;
+    cache_directory_ = GlobalOptions::jit_cache_directory;
+    cache_max_size_ = GlobalOptions::jit_cache_max_size;
     s.version("ImporterInternal", 1);
     s.unpack("ImporterInternal::name", name_);
     s.unpack("ImporterInternal::meta", meta_);
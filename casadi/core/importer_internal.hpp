@@ -134,6 +134,9 @@ namespace casadi {
     /// Get library name
     virtual std::string library() const;
 
+    /// Other source files (translation units) to be compiled and linked with name_
+    std::vector<std::string> units() const;
+
     /// Can meta information be read?
     virtual bool can_have_meta() const { return true;}
 
@@ -163,6 +166,44 @@ namespace casadi {
         \identifier{21h} */
     bool verbose_;
 
+    /// Directory of the on-disk cache of compiled code, empty if disabled
+    std::string cache_directory_;
+
+    /// Maximum size of the cache in bytes, zero if unlimited
+    casadi_int cache_max_size_;
+
+    /** \brief Cache key for the source file compiled with a given configuration
+
+        The key is a hash of the contents of the source file, the configuration
+        string, e.g. compiler command and flags, and the CasADi version.
+
+        \identifier{285} */
+    std::string cache_key(const std::string& config) const;
+
+    /** \brief Look up a compiled file in the cache
+
+        \return true and the path of the cached file on a hit
+
+        \identifier{286} */
+    bool cache_get(const std::string& key, const std::string& suffix, std::string& path) const;
+
+    /** \brief Publish a compiled file in the cache
+
+        The file is copied to a temporary file in the cache directory, which is then
+        renamed, making the entry appear atomically to other processes. The least
+        recently used entries are removed if the cache exceeds its maximum size.
+
+        \return Path of the cached copy, or an empty string on failure
+
+        \identifier{287} */
+    std::string cache_put(const std::string& key, const std::string& suffix,
+                          const std::string& file) const;
+
+    /** \brief Cache statistics, accumulated over all importers of the process
+
+        \identifier{288} */
+    static Dict cache_stats();
+
     void serialize(SerializingStream& s) const;
 
     virtual void serialize_type(SerializingStream& s) const;
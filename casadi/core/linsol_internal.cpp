@@ -24,6 +24,8 @@
 
 
 #include "linsol_internal.hpp"
+#include "sparsity_internal.hpp"
+#include <unordered_map>
 
 namespace casadi {
 
@@ -48,6 +50,13 @@ namespace casadi {
     }
   }
 
+  Dict LinsolInternal::get_stats(void* mem) const {
+    Dict stats = ProtoFunction::get_stats(mem);
+    // Number of instances sharing the symbolic factorization
+    stats["n_symbolic_users"] = static_cast<casadi_int>(symbolic_.use_count());
+    return stats;
+  }
+
   int LinsolInternal::init_mem(void* mem) const {
     if (!mem) return 1;
     if (ProtoFunction::init_mem(mem)) return 1;
@@ -112,8 +121,161 @@ namespace casadi {
     g << "#error " <<  class_name() << " does not support code generation\n";
   }
 
+  std::vector<casadi_int> LinsolInternal::postorder(const std::vector<casadi_int>& parent) {
+    casadi_int n = parent.size();
+    std::vector<casadi_int> post(n), w(3*n);
+    SparsityInternal::postorder(get_ptr(parent), n, get_ptr(post), get_ptr(w));
+    return post;
+  }
+
+  bool LinsolInternal::tree_partition(const std::vector<casadi_int>& parent,
+      const std::vector<double>& cost, casadi_int ntask, std::vector<casadi_int>& task_ptr,
+      std::vector<casadi_int>& subtrees, std::vector<casadi_int>& top) {
+    casadi_int n = parent.size();
+    task_ptr.clear();
+    subtrees.clear();
+    top.clear();
+    if (ntask<2) return false;
+    // Size, first node and cost of each subtree, children precede their parents
+    std::vector<casadi_int> size(n, 1), first = range(n);
+    std::vector<double> subcost = cost;
+    double total = 0;
+    for (casadi_int j=0; j<n; ++j) {
+      total += cost[j];
+      casadi_int p = parent[j];
+      if (p<0) continue;
+      casadi_assert(p>j, "Elimination tree must be postordered");
+      size[p] += size[j];
+      subcost[p] += subcost[j];
+      first[p] = std::min(first[p], first[j]);
+    }
+    for (casadi_int j=0; j<n; ++j) {
+      casadi_assert(first[j]==j-size[j]+1, "Elimination tree must be postordered");
+    }
+    // Not worth the synchronization overhead
+    if (total<1e4) return false;
+    // Linked lists of children
+    std::vector<casadi_int> head(n, -1), next(n, -1);
+    for (casadi_int j=n-1; j>=0; --j) {
+      if (parent[j]>=0) {
+        next[j] = head[parent[j]];
+        head[parent[j]] = j;
+      }
+    }
+    // Assign subtrees to the least loaded task, largest first
+    std::vector<double> load(ntask);
+    std::vector<casadi_int> owner;
+    auto by_cost = [&](casadi_int i, casadi_int j) { return subcost[i]>subcost[j];};
+    auto assign = [&](std::vector<casadi_int>& roots) {
+      std::stable_sort(roots.begin(), roots.end(), by_cost);
+      std::fill(load.begin(), load.end(), 0);
+      owner.resize(roots.size());
+      for (casadi_int k=0; k<roots.size(); ++k) {
+        owner[k] = std::min_element(load.begin(), load.end()) - load.begin();
+        load[owner[k]] += subcost[roots[k]];
+      }
+      return *std::max_element(load.begin(), load.end());
+    };
+    // Start with the whole trees
+    std::vector<casadi_int> roots;
+    for (casadi_int j=0; j<n; ++j) if (parent[j]<0) roots.push_back(j);
+    double top_cost = 0, best = assign(roots);
+    std::vector<casadi_int> best_roots = roots;
+    // Split the largest subtree as long as there is a chance of improvement
+    while (roots.size() <= 16*ntask) {
+      casadi_int j = roots.front();
+      if (head[j]<0) break;
+      top_cost += cost[j];
+      if (top_cost>=best) break;
+      roots.erase(roots.begin());
+      for (casadi_int c=head[j]; c>=0; c=next[c]) roots.push_back(c);
+      double t = top_cost + assign(roots);
+      if (t<best) {
+        best = t;
+        best_roots = roots;
+      }
+    }
+    // Require a speedup of at least 10 percent
+    if (best>0.9*total) return false;
+    // Collect the subtrees of each task
+    assign(best_roots);
+    std::vector<bool> in_subtree(n, false);
+    task_ptr.push_back(0);
+    for (casadi_int t=0; t<ntask; ++t) {
+      for (casadi_int k=0; k<best_roots.size(); ++k) {
+        if (owner[k]!=t) continue;
+        casadi_int j = best_roots[k];
+        subtrees.push_back(first[j]);
+        subtrees.push_back(j+1);
+        for (casadi_int i=first[j]; i<=j; ++i) in_subtree[i] = true;
+      }
+      if (subtrees.size()>2*task_ptr.back()) task_ptr.push_back(subtrees.size()/2);
+    }
+    // Remaining nodes
+    for (casadi_int j=0; j<n; ++j) {
+      if (in_subtree[j]) continue;
+      if (!top.empty() && top.back()==j) {
+        top.back()++;
+      } else {
+        top.push_back(j);
+        top.push_back(j+1);
+      }
+    }
+    return true;
+  }
+
+  // Cached symbolic factorizations, by hash of the sparsity pattern
+  typedef std::unordered_multimap<std::size_t, std::weak_ptr<const LinsolSymbolic> >
+    LinsolSymbolicCache;
+
+  static LinsolSymbolicCache& linsol_symbolic_cache() {
+    static LinsolSymbolicCache ret;
+    return ret;
+  }
+
+#ifdef CASADI_WITH_THREAD
+  static std::mutex mutex_linsol_symbolic;
+#endif //CASADI_WITH_THREAD
+
+  const LinsolSymbolic& LinsolInternal::symbolic_cached(const std::string& key,
+      const std::function<LinsolSymbolic*()>& fcn) {
+    std::string full_key = std::string(plugin_name()) + ":" + key;
+    std::size_t h = sp_.hash();
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(mutex_linsol_symbolic);
+#endif //CASADI_WITH_THREAD
+    LinsolSymbolicCache& cache = linsol_symbolic_cache();
+    // Look for a matching entry still in use
+    auto eq = cache.equal_range(h);
+    for (auto it=eq.first; it!=eq.second; ++it) {
+      std::shared_ptr<const LinsolSymbolic> sym = it->second.lock();
+      if (sym && sym->key==full_key && sym->sp==sp_) {
+        if (verbose_) casadi_message("Reusing symbolic factorization");
+        symbolic_ = sym;
+        return *symbolic_;
+      }
+    }
+    // Calculate a new one
+    std::shared_ptr<LinsolSymbolic> sym(fcn());
+    sym->sp = sp_;
+    sym->key = full_key;
+    symbolic_ = sym;
+    // Drop entries no longer in use
+    for (auto it=cache.begin(); it!=cache.end();) {
+      if (it->second.expired()) {
+        it = cache.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    cache.insert(std::make_pair(h, std::weak_ptr<const LinsolSymbolic>(symbolic_)));
+    return *symbolic_;
+  }
+
   std::map<std::string, LinsolInternal::Plugin> LinsolInternal::solvers_;
 
+  const casadi_int LinsolInternal::max_nrhs_block;
+
   const std::string LinsolInternal::infix_ = "linsol";
 
 
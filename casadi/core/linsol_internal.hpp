@@ -29,6 +29,7 @@
 #include "linsol.hpp"
 #include "function_internal.hpp"
 #include "plugin_interface.hpp"
+#include <memory>
 
 /// \cond INTERNAL
 
@@ -42,6 +43,21 @@ namespace casadi {
     LinsolMemory() : is_sfact(false), is_nfact(false) {}
   };
 
+  /** \brief Symbolic factorization of a linear solver plugin
+
+      Depends only on the sparsity pattern of the linear system and on the options,
+      such that it can be shared read-only among instances, cf. LinsolInternal::symbolic_cached
+
+      \identifier{28s} */
+  struct CASADI_EXPORT LinsolSymbolic {
+    // Sparsity pattern of the linear system
+    Sparsity sp;
+    // Plugin name and options
+    std::string key;
+    // Destructor
+    virtual ~LinsolSymbolic() {}
+  };
+
   /** Internal class
       @copydoc Linsol_doc
   */
@@ -67,6 +83,9 @@ namespace casadi {
     /// Initialize
     void init(const Dict& opts) override;
 
+    /// Get all statistics
+    Dict get_stats(void* mem) const override;
+
     /** \brief Create memory block
 
         \identifier{e6} */
@@ -139,6 +158,46 @@ namespace casadi {
     const casadi_int* row() const { return sp_.row();}
     casadi_int nnz() const { return sp_.nnz();}
 
+    /// Maximum number of right-hand sides per block in multi-RHS solves
+    static const casadi_int max_nrhs_block = 8;
+
+    /** \brief Postorder of an elimination tree
+
+        Reordering the nodes accordingly makes every subtree a contiguous range
+
+        \identifier{28q} */
+    static std::vector<casadi_int> postorder(const std::vector<casadi_int>& parent);
+
+    /** \brief Distribute a postordered elimination tree over parallel tasks
+
+        Subtrees are split, largest first, as long as this reduces the estimated
+        time of a tree-parallel factorization: the cost of the most loaded task
+        plus the cost of the remaining nodes, which are ancestors of the subtrees
+        and are processed serially afterwards.
+        Task t is assigned the subtrees [subtrees[2*k], subtrees[2*k+1]) for
+        task_ptr[t] <= k < task_ptr[t+1]. The remaining nodes are returned as
+        the ranges [top[2*k], top[2*k+1]) in increasing order.
+        Returns false if a parallel factorization is not expected to pay off.
+
+        \identifier{28r} */
+    static bool tree_partition(const std::vector<casadi_int>& parent,
+                               const std::vector<double>& cost, casadi_int ntask,
+                               std::vector<casadi_int>& task_ptr,
+                               std::vector<casadi_int>& subtrees,
+                               std::vector<casadi_int>& top);
+
+    /** \brief Symbolic factorization from a process-wide cache
+
+        Returns the symbolic factorization calculated by fcn, which may only depend
+        on the sparsity pattern and on the options summarized in key. If another
+        instance of the same plugin holds a symbolic factorization with the same
+        sparsity pattern and key, it is reused instead. Entries are shared read-only,
+        also among threads, and released together with the last instance holding them.
+
+        \identifier{28t} */
+    const LinsolSymbolic& symbolic_cached(const std::string& key,
+                                          const std::function<LinsolSymbolic*()>& fcn);
+
     /** \brief Serialize type information
 
         \identifier{e9} */
@@ -156,6 +215,9 @@ namespace casadi {
     // Sparsity pattern of the linear system
     Sparsity sp_;
 
+    // Symbolic factorization held by this instance, if any
+    std::shared_ptr<const LinsolSymbolic> symbolic_;
+
   protected:
     /** \brief Deserializing constructor
 
@@ -25,14 +25,8 @@
 
 #include "map.hpp"
 #include "serializing_stream.hpp"
-
-#ifdef CASADI_WITH_THREAD
-#ifdef CASADI_WITH_THREAD_MINGW
-#include <mingw.thread.h>
-#else // CASADI_WITH_THREAD_MINGW
-#include <thread>
-#endif // CASADI_WITH_THREAD_MINGW
-#endif // CASADI_WITH_THREAD
+#include "sx_function.hpp"
+#include "thread_pool.hpp"
 
 namespace casadi {
 
@@ -51,7 +45,7 @@ namespace casadi {
   }
 
   Map::Map(const std::string& name, const Function& f, casadi_int n)
-    : FunctionInternal(name), f_(f), n_(n) {
+    : FunctionInternal(name), f_(f), n_(n), batch_(false) {
   }
 
   bool Map::is_a(const std::string& type, bool recursive) const {
@@ -98,6 +92,9 @@ namespace casadi {
   Map::Map(DeserializingStream& s) : FunctionInternal(s) {
     s.unpack("Map::f", f_);
     s.unpack("Map::n", n_);
+    batch_ = f_.is_a("SXFunction")
+      && static_cast<const SXFunction*>(f_.get())->has_eval_batch()
+      && sz_w() >= static_cast<const SXFunction*>(f_.get())->sz_w_batch();
   }
 
   ProtoFunction* Map::deserialize(DeserializingStream& s) {
@@ -129,6 +126,12 @@ namespace casadi {
     alloc_res(f_.sz_res());
     alloc_w(f_.sz_w());
     alloc_iw(f_.sz_iw());
+
+    // Evaluate the instructions of an SXFunction for blocks of inputs at once,
+    // also used by the serial fallback of the parallel maps
+    batch_ = f_.is_a("SXFunction")
+      && static_cast<const SXFunction*>(f_.get())->has_eval_batch();
+    if (batch_) alloc_w(static_cast<const SXFunction*>(f_.get())->sz_w_batch());
   }
 
   template<typename T>
@@ -315,6 +318,10 @@ namespace casadi {
   }
 
   int Map::eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const {
+    // Batched evaluation
+    if (batch_) {
+      return static_cast<const SXFunction*>(f_.get())->eval_batch(arg, res, iw, w, n_);
+    }
     // This checkout/release dance is an optimization.
     // Could also use the thread-safe variant f_(arg1, res1, iw, w)
     // in Map::eval_gen
@@ -467,33 +474,12 @@ namespace casadi {
     std::vector< scoped_checkout<Function> > ind; ind.reserve(n_);
     for (casadi_int i=0; i<n_; ++i) ind.emplace_back(f_);
 
-    // Allocate space for return values
-    std::vector<int> ret_values(n_);
-
-    // Spawn threads
-    std::vector<std::thread> threads;
-    for (casadi_int i=0; i<n_; ++i) {
-      // Why the lambda function?
-      // Because it was the first iteration to pass tests on MingGW
-      // using mingw-std-threads.
-      threads.emplace_back(
-        [i](const Function& f, const double** arg, double** res,
-            casadi_int* iw, double* w, casadi_int ind, int& ret) {
-              ThreadsWork(f, i, arg, res, iw, w, ind, ret);
-            },
-        std::ref(f_), arg, res, iw, w, casadi_int(ind[i]), std::ref(ret_values[i]));
-    }
-
-    // Join threads
-    for (auto && th : threads) th.join();
-
-    // Anticipate success
-    int ret = 0;
-
-    // Compute aggregate return value
-    for (int e : ret_values) ret = ret || e;
-
-    return ret;
+    // Evaluate in the thread pool
+    return ThreadPool::instance().run(n_, [&](casadi_int i) {
+      int ret;
+      ThreadsWork(f_, i, arg, res, iw, w, casadi_int(ind[i]), ret);
+      return ret;
+    });
 #endif // CASADI_WITH_THREAD
   }
 
@@ -212,6 +212,9 @@ namespace casadi {
 
     // Number of times to evaluate this function
     casadi_int n_;
+
+    // Evaluate f_, an SXFunction, for all n_ inputs at once with eval_batch
+    bool batch_;
   };
 
   /** A map Evaluate in parallel using OpenMP
@@ -265,7 +268,7 @@ namespace casadi {
     explicit OmpMap(DeserializingStream& s) : Map(s) {}
   };
 
-  /** A map Evaluate in parallel using std::thread
+  /** A map Evaluate in parallel using the std::thread based ThreadPool
       Note: Do not use this class with much more than the intended number of
       threads for the parallel evaluation as it will cause excessive memory use.
 
@@ -1084,6 +1084,7 @@ namespace casadi {
         true and the names of the duplicate expressions will be passed to casadi_warning.
         Note: Will mark the node using SXElem::set_temp.
         Make sure to call reset_input() after usage.
+        Not thread-safe: the marker is shared by all expressions referring to the node.
 
         \identifier{19t} */
     bool has_duplicates() const;
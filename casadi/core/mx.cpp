@@ -1395,6 +1395,22 @@ namespace casadi {
     }
     if (all_equal) return ex;
 
+    // Replace symbolic primitives with expressions of matching dimensions directly
+    bool direct = true;
+    std::unordered_set<const MXNode*> v_nodes;
+    for (casadi_int k=0; k<v.size() && direct; ++k) {
+      direct = v[k].is_symbolic() && v[k].size()==vdef[k].size()
+        && v_nodes.insert(v[k].get()).second;
+    }
+    if (direct) {
+      std::vector<MX> vdef_proj(vdef.size());
+      for (casadi_int k=0; k<v.size(); ++k) {
+        vdef_proj[k] = vdef[k].sparsity()==v[k].sparsity() ? vdef[k]
+          : project(vdef[k], v[k].sparsity(), true);
+      }
+      return substitute_cone(ex, v, vdef_proj);
+    }
+
     // Otherwise, evaluate symbolically
     Function F("tmp_substitute", v, ex, Dict{{"max_io", 0}, {"allow_free", true}});
     std::vector<MX> ret;
@@ -1414,107 +1430,71 @@ namespace casadi {
       "Mismatch in the number of expression to substitute: "
       + str(expr.size()) + " <-> " + str(exprs.size()) + ".");
 
-    // Sort the expression
-    Dict opts({{"max_io", 0}, {"allow_free", true}});
-    Function f("tmp_graph_substitute", std::vector<MX>{}, ex, opts);
-    MXFunction *ff = f.get<MXFunction>();
-
-    // Get references to the internal data structures
-    const std::vector<MXAlgEl>& algorithm = ff->algorithm_;
-    std::vector<MX> swork(ff->workloc_.size()-1);
-
-    // A boolean vector indicated whoch nodes are tainted by substitutions
-    std::vector<bool> tainted(swork.size());
-
-    // Temporary std::stringstream
-    std::stringstream ss;
-
-    // Construct lookup table for expressions
-    std::map<const MXNode*, casadi_int> expr_lookup;
-    for (casadi_int i=0;i<expr.size();++i) {
-      expr_lookup[expr[i].operator->()] = i;
-    }
-
-    // Construct found map
-    std::vector<bool> expr_found(expr.size());
-
-    // Allocate output vector
-    std::vector<MX> f_out(f.n_out());
-    std::vector<MX> oarg, ores;
-
-    // expr_lookup iterator
-    std::map<const MXNode*, casadi_int>::const_iterator it_lookup;
-
-    for (auto it=algorithm.begin(); it!=algorithm.end(); ++it) {
-
-      if (it->op != OP_OUTPUT) {
-        // Check if it->data points to a supplied expr
-        it_lookup = expr_lookup.find((it->data).operator->());
+    return substitute_cone(ex, expr, exprs);
+  }
 
-        if (it->res.front()>=0 && it_lookup!=expr_lookup.end()) {
-          // Fill in that expression in-place
-          swork[it->res.front()] = exprs[it_lookup->second];
-          tainted[it->res.front()] = true;
-          expr_found[it_lookup->second] = true;
+  std::vector<MX> MX::substitute_cone(const std::vector<MX>& ex,
+                                      const std::vector<MX>& v,
+                                      const std::vector<MX>& vdef) {
+    // New values of the nodes depending on v, multiple outputs stored consecutively
+    std::vector<MX> cone(vdef);
+    // Position in cone for each visited node, -1 if not depending on v
+    std::unordered_map<const MXNode*, casadi_int> ind;
+    for (casadi_int k=0; k<v.size(); ++k) {
+      // Nodes with multiple outputs are replaced through their outputs only
+      if (!v[k]->has_output()) ind[v[k].get()] = k;
+    }
+
+    // Value of a visited expression
+    auto value = [&](const MX& e) -> const MX& {
+      casadi_int i = ind.at(e.get());
+      return i<0 ? e : cone[i];
+    };
+
+    // Depth-first search, with the index of the next dependency to visit
+    std::vector<std::pair<MXNode*, casadi_int> > s;
+    std::vector<MX> arg, res;
+    for (auto&& e : ex) {
+      if (ind.count(e.get())) continue;
+      s.push_back(std::make_pair(e.get(), 0));
+      while (!s.empty()) {
+        MXNode* t = s.back().first;
+        casadi_int& next_dep = s.back().second;
+        if (next_dep < t->n_dep()) {
+          // Visit the next dependency, unless already visited
+          MXNode* d = t->dep(next_dep++).get();
+          if (!ind.count(d)) s.push_back(std::make_pair(d, 0));
           continue;
         }
-      }
-
-      switch (it->op) {
-      case OP_INPUT:
-        tainted[it->res.front()] = false;
-        break;
-      case OP_PARAMETER:
-        swork[it->res.front()] = it->data;
-        tainted[it->res.front()] = false;
-        break;
-      case OP_OUTPUT:
-        casadi_assert(it->data->segment()==0, "Not implemented");
-        f_out[it->data->ind()] = swork[it->arg.front()];
-        break;
-      default:
-        {
-          bool node_tainted = false;
-
-          // Arguments of the operation
-          oarg.resize(it->arg.size());
-          for (casadi_int i=0; i<oarg.size(); ++i) {
-            casadi_int el = it->arg[i];
-            if (el>=0) node_tainted =  node_tainted || tainted[el];
-            oarg[i] = el<0 ? MX(it->data->dep(i).size()) : swork.at(el);
-          }
-
-          // Perform the operation
-          ores.resize(it->res.size());
-          if (it->res.size()==1 && it->res[0]>=0 && !node_tainted) {
-            ores.at(0) = it->data;
-          } else {
-            it->data->eval_mx(oarg, ores);
-          }
+        s.pop_back();
 
-          // Get the result
-          for (casadi_int i=0; i<ores.size(); ++i) {
-            casadi_int el = it->res[i];
-            if (el>=0) swork.at(el) = ores[i];
-            if (el>=0) tainted[el] = node_tainted;
-          }
+        // Does the node depend on v?
+        bool in_cone = false;
+        for (casadi_int i=0; i<t->n_dep() && !in_cone; ++i) {
+          in_cone = ind.at(t->dep(i).get())>=0;
+        }
+        if (!in_cone) {
+          // Share the node
+          ind[t] = -1;
+        } else if (t->op()<0) {
+          // Output of a node with multiple outputs
+          ind[t] = ind.at(t->dep().get()) + t->which_output();
+        } else {
+          // Evaluate with the new dependencies
+          arg.resize(t->n_dep());
+          for (casadi_int i=0; i<arg.size(); ++i) arg[i] = value(t->dep(i));
+          res.resize(t->nout());
+          t->eval_mx(arg, res);
+          ind[t] = cone.size();
+          cone.insert(cone.end(), res.begin(), res.end());
         }
       }
     }
 
-    bool all_found=true;
-    for (casadi_int i=0;i<expr.size();++i) {
-      all_found = all_found && expr_found[i];
-    }
-
-    //casadi_assert(all_found,
-    //             "MXFunction::extractNodes(const std::vector<MX>& expr):"
-    //             " failed to locate all input expr."
-    //             << std::endl << "Here's a boolean list showing which ones where found: "
-    //             << expr_found);
-
-    return f_out;
-
+    // Collect the results
+    std::vector<MX> ret(ex.size());
+    for (casadi_int i=0; i<ex.size(); ++i) ret[i] = value(ex[i]);
+    return ret;
   }
 
   void MX::extract(std::vector<MX>& ex, std::vector<MX>& v,
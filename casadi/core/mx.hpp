@@ -323,6 +323,7 @@ namespace casadi {
         true and the names of the duplicate expressions will be passed to casadi_warning.
         Note: Will mark the node using MX::set_temp.
         Make sure to call reset_input() after usage.
+        Not thread-safe: the marker is shared by all expressions referring to the node.
 
         \identifier{qs} */
     bool has_duplicates() const;
@@ -384,10 +385,10 @@ namespace casadi {
     static MX deserialize(DeserializingStream& s);
 
     /// \cond INTERNAL
-    /// Get the temporary variable
+    /// Get the temporary variable, not thread-safe
     casadi_int get_temp() const;
 
-    /// Set the temporary variable
+    /// Set the temporary variable, not thread-safe
     void set_temp(casadi_int t) const;
     /// \endcond
 
@@ -921,6 +922,17 @@ namespace casadi {
     // Depth when checking equalities
     static casadi_int eq_depth_;
 
+    /** \brief Replace nodes, reevaluating only the expressions that depend on them
+
+        The remainder of the expression graph is shared with \a ex. Finding
+        these expressions still takes one search over the whole graph, see
+        MXSubstitution for repeated substitutions in the same expressions.
+
+        \identifier{29b} */
+    static std::vector<MX> substitute_cone(const std::vector<MX>& ex,
+                                           const std::vector<MX>& v,
+                                           const std::vector<MX>& vdef);
+
 #endif // SWIG
   };
 
@@ -149,6 +149,9 @@ namespace casadi {
     // All nodes
     std::vector<MXNode*> nodes;
 
+    // Place of each node in the sorted graph
+    NodeIndex<MXNode> node_ind;
+
     // Add the list of nodes
     for (casadi_int ind=0; ind<out_.size(); ++ind) {
       // Loop over primitives of each output
@@ -157,7 +160,7 @@ namespace casadi {
       for (casadi_int p=0; p<prim.size(); ++p) {
         // Get the nodes using a depth first search
         s.push(prim[p].get());
-        sort_depth_first(s, nodes);
+        sort_depth_first(s, nodes, node_ind);
         // Add an output instruction ("data" below will take ownership)
         nodes.push_back(new Output(prim[p], ind, p, nz_offset));
         // Update offset
@@ -165,11 +168,6 @@ namespace casadi {
       }
     }
 
-    // Set the temporary variables to be the corresponding place in the sorted graph
-    for (casadi_int i=0; i<nodes.size(); ++i) {
-      nodes[i]->temp = i;
-    }
-
     // Place in the algorithm for each node
     std::vector<casadi_int> place_in_alg;
     place_in_alg.reserve(nodes.size());
@@ -183,7 +181,9 @@ namespace casadi {
     // Get the sequence of instructions for the virtual machine
     algorithm_.resize(0);
     algorithm_.reserve(nodes.size());
-    for (MXNode* n : nodes) {
+    for (casadi_int k=0; k<nodes.size(); ++k) {
+      // Current node
+      MXNode* n = nodes[k];
 
       // Get the operation
       casadi_int op = n->op();
@@ -200,13 +200,13 @@ namespace casadi {
         ae.data.own(n);
         ae.arg.resize(n->n_dep());
         for (casadi_int i=0; i<n->n_dep(); ++i) {
-          ae.arg[i] = n->dep(i)->temp;
+          ae.arg[i] = node_ind.get(n->dep(i).get());
         }
         ae.res.resize(n->nout());
         if (n->has_output()) {
           std::fill(ae.res.begin(), ae.res.end(), -1);
         } else if (!ae.res.empty()) {
-          ae.res[0] = n->temp;
+          ae.res[0] = k;
         }
 
         // Increase the reference count of the dependencies
@@ -225,14 +225,14 @@ namespace casadi {
         casadi_int oind = n->which_output();
 
         // Get the index of the parent node
-        casadi_int pind = place_in_alg[n->dep(0)->temp];
+        casadi_int pind = place_in_alg[node_ind.get(n->dep(0).get())];
 
         // Save location in the algorithm element corresponding to the parent node
         casadi_int& otmp = algorithm_[pind].res.at(oind);
         if (otmp<0) {
-          otmp = n->temp; // First time this function output is encountered, save to algorithm
+          otmp = k; // First time this function output is encountered, save to algorithm
         } else {
-          n->temp = otmp; // Function output is a duplicate, use the node encountered first
+          node_ind.set(n, otmp); // Function output is a duplicate, use the node encountered first
         }
 
         // Not in the algorithm
@@ -358,16 +358,10 @@ namespace casadi {
     sz_w += wind;
     alloc_w(sz_w);
 
-    // Reset the temporary variables
-    for (casadi_int i=0; i<nodes.size(); ++i) {
-      if (nodes[i]) {
-        nodes[i]->temp = 0;
-      }
-    }
-
-    // Now mark each input's place in the algorithm
+    // Now record each input's place in the algorithm
+    std::unordered_map<const MXNode*, casadi_int> symb_ind;
     for (auto it=symb_loc.begin(); it!=symb_loc.end(); ++it) {
-      it->second->temp = it->first+1;
+      symb_ind[it->second] = it->first;
     }
 
     // Add input instructions, loop over inputs
@@ -376,10 +370,12 @@ namespace casadi {
       std::vector<MX> prim = in_[ind].primitives();
       casadi_int nz_offset=0;
       for (casadi_int p=0; p<prim.size(); ++p) {
-        casadi_int i = prim[p].get_temp()-1;
-        if (i>=0) {
+        auto it = symb_ind.find(prim[p].get());
+        if (it!=symb_ind.end() && it->second>=0) {
+          casadi_int i = it->second;
+
           // Mark read
-          prim[p].set_temp(0);
+          it->second = -1;
 
           // Replace parameter with input instruction
           algorithm_[i].data.own(new Input(prim[p].sparsity(), ind, p, nz_offset));
@@ -392,13 +388,9 @@ namespace casadi {
     // Locate free variables
     free_vars_.clear();
     for (auto it=symb_loc.begin(); it!=symb_loc.end(); ++it) {
-      casadi_int i = it->second->temp-1;
-      if (i>=0) {
+      if (symb_ind[it->second]>=0) {
         // Save to list of free parameters
         free_vars_.push_back(MX::create(it->second));
-
-        // Remove marker
-        it->second->temp=0;
       }
     }
 
@@ -32,6 +32,7 @@
 #include "calculus.hpp"
 #include "code_generator.hpp"
 #include "linsol.hpp"
+#include "node_pool.hpp"
 #include <vector>
 #include <stack>
 
@@ -59,6 +60,14 @@ namespace casadi {
         \identifier{1qc} */
     ~MXNode() override=0;
 
+    ///@{
+    /** \brief Nodes are allocated from size-class pools, cf. NodePool
+
+        \identifier{291} */
+    static void* operator new(size_t sz) { return NodePool::allocate(sz);}
+    static void operator delete(void* p, size_t sz) { NodePool::deallocate(p, sz);}
+    ///@}
+
     /** \brief Check the truth value of this node
 
         \identifier{1qd} */
@@ -702,7 +711,8 @@ namespace casadi {
 
     /** Temporary variables to be used in user algorithms like sorting,
         the user is responsible of making sure that use is thread-safe
-        The variable is initialized to zero
+        The variable is initialized to zero. Function construction only uses it
+        when CasADi is built without WITH_THREAD, see NodeIndex.
     */
     mutable casadi_int temp;
 
@@ -0,0 +1,139 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#include "mx_substitution.hpp"
+#include "mx_node.hpp"
+#include <algorithm>
+#include <unordered_set>
+
+namespace casadi {
+
+  MXSubstitution::MXSubstitution(const std::vector<MX>& ex) : ex_(ex) {
+    // Depth-first search, with the index of the next dependency to visit
+    std::vector<std::pair<MXNode*, casadi_int> > s;
+    for (auto&& e : ex_) {
+      if (pos_.count(e.get())) continue;
+      s.push_back(std::make_pair(e.get(), 0));
+      pos_[e.get()] = -1;
+      while (!s.empty()) {
+        MXNode* t = s.back().first;
+        casadi_int& next_dep = s.back().second;
+        if (next_dep < t->n_dep()) {
+          // Visit the next dependency, unless already visited
+          MXNode* d = t->dep(next_dep++).get();
+          if (pos_.insert(std::make_pair(d, -1)).second) s.push_back(std::make_pair(d, 0));
+          continue;
+        }
+        s.pop_back();
+        // All dependencies come before the node
+        pos_[t] = nodes_.size();
+        nodes_.push_back(t);
+      }
+    }
+
+    // Count the users of each node
+    user_offset_.resize(nodes_.size()+1, 0);
+    for (MXNode* t : nodes_) {
+      for (casadi_int i=0; i<t->n_dep(); ++i) user_offset_[pos_.at(t->dep(i).get())+1]++;
+    }
+    for (casadi_int k=0; k<nodes_.size(); ++k) user_offset_[k+1] += user_offset_[k];
+
+    // Store the users
+    user_.resize(user_offset_.back());
+    std::vector<casadi_int> next(user_offset_.begin(), user_offset_.end()-1);
+    for (casadi_int k=0; k<nodes_.size(); ++k) {
+      MXNode* t = nodes_[k];
+      for (casadi_int i=0; i<t->n_dep(); ++i) user_[next[pos_.at(t->dep(i).get())]++] = k;
+    }
+  }
+
+  std::vector<MX> MXSubstitution::substitute(const std::vector<MX>& v,
+                                             const std::vector<MX>& vdef) const {
+    casadi_assert(v.size()==vdef.size(),
+      "Mismatch in the number of expression to substitute: "
+      + str(v.size()) + " <-> " + str(vdef.size()) + ".");
+
+    // New values of the nodes depending on v, multiple outputs stored consecutively
+    std::vector<MX> cone(vdef);
+    // Position in cone for each node depending on v
+    std::unordered_map<casadi_int, casadi_int> ind;
+    for (casadi_int k=0; k<v.size(); ++k) {
+      // Nodes with multiple outputs are replaced through their outputs only
+      if (v[k]->has_output()) continue;
+      auto it = pos_.find(v[k].get());
+      if (it!=pos_.end()) ind[it->second] = k;
+    }
+
+    // Find the nodes depending on v through the users
+    std::unordered_set<casadi_int> visited;
+    std::vector<casadi_int> stack, affected;
+    for (auto&& i : ind) {
+      visited.insert(i.first);
+      stack.push_back(i.first);
+    }
+    while (!stack.empty()) {
+      casadi_int k = stack.back();
+      stack.pop_back();
+      for (casadi_int j=user_offset_[k]; j<user_offset_[k+1]; ++j) {
+        if (visited.insert(user_[j]).second) {
+          stack.push_back(user_[j]);
+          affected.push_back(user_[j]);
+        }
+      }
+    }
+
+    // Value of an expression in the graph
+    auto value = [&](const MX& e) -> const MX& {
+      auto it = ind.find(pos_.at(e.get()));
+      return it==ind.end() ? e : cone[it->second];
+    };
+
+    // Reevaluate in topological order
+    std::sort(affected.begin(), affected.end());
+    std::vector<MX> arg, res;
+    for (casadi_int k : affected) {
+      MXNode* t = nodes_[k];
+      if (t->op()<0) {
+        // Output of a node with multiple outputs
+        ind[k] = ind.at(pos_.at(t->dep().get())) + t->which_output();
+      } else {
+        // Evaluate with the new dependencies
+        arg.resize(t->n_dep());
+        for (casadi_int i=0; i<arg.size(); ++i) arg[i] = value(t->dep(i));
+        res.resize(t->nout());
+        t->eval_mx(arg, res);
+        ind[k] = cone.size();
+        cone.insert(cone.end(), res.begin(), res.end());
+      }
+    }
+
+    // Collect the results
+    std::vector<MX> ret(ex_.size());
+    for (casadi_int i=0; i<ex_.size(); ++i) ret[i] = value(ex_[i]);
+    return ret;
+  }
+
+} // namespace casadi
@@ -0,0 +1,91 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#ifndef CASADI_MX_SUBSTITUTION_HPP
+#define CASADI_MX_SUBSTITUTION_HPP
+
+#include "mx.hpp"
+#include <unordered_map>
+
+namespace casadi {
+
+  /** \brief Repeated substitutions in the same MX expressions
+
+      The expression graph of \a ex is indexed once: the nodes in topological
+      order and, for each node, the nodes using it. A substitution searches
+      forward from the replaced nodes through this index and reevaluates only
+      the expressions depending on them, so that its cost grows with the size
+      of this cone rather than with the size of the graph. All other nodes
+      are shared with \a ex.
+
+      MX::substitute and MX::graph_substitute search the whole graph on every
+      call and are cheaper for a single substitution.
+
+      \identifier{29c} */
+  class CASADI_EXPORT MXSubstitution {
+  public:
+    /// Default constructor
+    MXSubstitution() {}
+
+    /** \brief Index the expression graph of \a ex
+
+        \identifier{29d} */
+    explicit MXSubstitution(const std::vector<MX>& ex);
+
+    /** \brief Indexed expressions
+
+        \identifier{29e} */
+    const std::vector<MX>& ex() const { return ex_;}
+
+    /** \brief Substitute \a v with \a vdef in the indexed expressions
+
+        Same as graph_substitute(ex(), v, vdef): \a v are nodes of the graph
+        and may be symbols as well as other expressions. Nodes in \a v that do
+        not occur in the graph are ignored.
+
+        \identifier{29f} */
+    std::vector<MX> substitute(const std::vector<MX>& v,
+                               const std::vector<MX>& vdef) const;
+
+#ifndef SWIG
+  private:
+    // Indexed expressions, owning the nodes below
+    std::vector<MX> ex_;
+
+    // Nodes in topological order
+    std::vector<MXNode*> nodes_;
+
+    // Position of each node in nodes_
+    std::unordered_map<const MXNode*, casadi_int> pos_;
+
+    // Positions of the users of each node, in compressed column format
+    std::vector<casadi_int> user_offset_, user_;
+#endif // SWIG
+  };
+
+} // namespace casadi
+
+#endif // CASADI_MX_SUBSTITUTION_HPP
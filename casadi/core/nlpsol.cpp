@@ -833,6 +833,29 @@ namespace casadi {
   }
 
 
+  Sparsity Nlpsol::hess_l_blocks(std::vector<casadi_int>& blk) const {
+    // Sparsity of the Lagrangian Hessian
+    Sparsity sp = has_function("nlp_hess_l") ? get_function("nlp_hess_l").sparsity_out(0)
+      : kkt().sparsity_out(1);
+    casadi_assert(sp.is_symmetric(), "Hessian must be symmetric");
+    // Connected components, each variable being connected to itself
+    std::vector<casadi_int> p, r;
+    casadi_int nb = (sp + Sparsity::diag(nx_)).scc(p, r);
+    // Dense diagonal blocks
+    blk.resize(nx_);
+    std::vector<casadi_int> row, col;
+    for (casadi_int b=0; b<nb; ++b) {
+      for (casadi_int i=r[b]; i<r[b+1]; ++i) {
+        blk[p[i]] = b;
+        for (casadi_int j=r[b]; j<r[b+1]; ++j) {
+          row.push_back(p[j]);
+          col.push_back(p[i]);
+        }
+      }
+    }
+    return Sparsity::triplet(nx_, nx_, row, col);
+  }
+
   Function Nlpsol::
   get_forward(casadi_int nfwd, const std::string& name,
               const std::vector<std::string>& inames,
@@ -263,6 +263,12 @@ namespace casadi {
     // Get KKT function
     Function kkt() const;
 
+    /** \brief Block-diagonal sparsity covering the Lagrangian Hessian
+
+        The blocks are the connected components of the Hessian sparsity graph.
+        On return, blk holds the block index of each variable. */
+    Sparsity hess_l_blocks(std::vector<casadi_int>& blk) const;
+
     // Make sure primal-dual solution is consistent with bounds
     static void bound_consistency(casadi_int n, double* z, double* lam,
                                   const double* lbz, const double* ubz);
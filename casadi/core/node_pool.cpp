@@ -0,0 +1,219 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "node_pool.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#ifdef CASADI_WITH_THREAD
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.mutex.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <mutex>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif // CASADI_WITH_THREAD
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif // _WIN32
+
+namespace casadi {
+
+  namespace {
+
+    // Header at the start of every slab
+    struct Slab {
+      // Neighbours in the list of slabs with free blocks
+      Slab* prev;
+      Slab* next;
+      // Released blocks, linked through their first word
+      void* free;
+      // Start of the part of the slab that has never been handed out
+      char* unused;
+      // End of the slab
+      char* end;
+      // Number of blocks in use
+      casadi_int live;
+      // Is the slab in the list of slabs with free blocks?
+      bool listed;
+    };
+
+    // Offset of the first block in a slab
+    const size_t slab_header = (sizeof(Slab) + NodePool::granularity - 1)
+      / NodePool::granularity * NodePool::granularity;
+
+    // Number of size classes
+    const size_t n_class = NodePool::max_size / NodePool::granularity;
+
+    // All slabs of a given block size
+    struct SizeClass {
+      // Slabs with at least one free block
+      Slab* avail;
+      // Total number of slabs and of blocks in use
+      casadi_int n_slabs;
+      casadi_int live;
+#ifdef CASADI_WITH_THREAD
+      std::mutex mtx;
+#endif // CASADI_WITH_THREAD
+      SizeClass() : avail(nullptr), n_slabs(0), live(0) {}
+    };
+
+    // The pools are never destroyed, nodes may be released during static destruction
+    SizeClass* size_classes() {
+      static SizeClass* classes = new SizeClass[n_class];
+      return classes;
+    }
+
+    void* slab_alloc() {
+#ifdef _WIN32
+      void* p = _aligned_malloc(NodePool::slab_size, NodePool::slab_size);
+#else // _WIN32
+      void* p = nullptr;
+      if (posix_memalign(&p, NodePool::slab_size, NodePool::slab_size)) p = nullptr;
+#endif // _WIN32
+      if (p==nullptr) throw std::bad_alloc();
+      return p;
+    }
+
+    void slab_free(void* p) {
+#ifdef _WIN32
+      _aligned_free(p);
+#else // _WIN32
+      std::free(p);
+#endif // _WIN32
+    }
+
+    void unlink(SizeClass& c, Slab* s) {
+      if (s->prev) {
+        s->prev->next = s->next;
+      } else {
+        c.avail = s->next;
+      }
+      if (s->next) s->next->prev = s->prev;
+      s->prev = s->next = nullptr;
+      s->listed = false;
+    }
+
+    void push_front(SizeClass& c, Slab* s) {
+      s->prev = nullptr;
+      s->next = c.avail;
+      if (c.avail) c.avail->prev = s;
+      c.avail = s;
+      s->listed = true;
+    }
+
+  } // namespace
+
+  void* NodePool::allocate(size_t sz) {
+    if (sz>max_size) return ::operator new(sz);
+    if (sz==0) sz = 1;
+    size_t k = (sz - 1) / granularity;
+    size_t block = (k + 1) * granularity;
+    SizeClass& c = size_classes()[k];
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(c.mtx);
+#endif // CASADI_WITH_THREAD
+    Slab* s = c.avail;
+    if (s==nullptr) {
+      // Start a new slab, blocks are carved out of it on demand
+      char* mem = static_cast<char*>(slab_alloc());
+      s = reinterpret_cast<Slab*>(mem);
+      s->free = nullptr;
+      s->unused = mem + slab_header;
+      s->end = mem + slab_size;
+      s->live = 0;
+      push_front(c, s);
+      c.n_slabs++;
+    }
+    // Reuse a released block if possible
+    void* p;
+    if (s->free) {
+      p = s->free;
+      s->free = *static_cast<void**>(p);
+    } else {
+      p = s->unused;
+      s->unused += block;
+    }
+    s->live++;
+    c.live++;
+    // Take full slabs out of the list
+    if (s->free==nullptr && s->unused + block > s->end) unlink(c, s);
+    return p;
+  }
+
+  void NodePool::deallocate(void* p, size_t sz) {
+    if (p==nullptr) return;
+    if (sz>max_size) {
+      ::operator delete(p);
+      return;
+    }
+    if (sz==0) sz = 1;
+    SizeClass& c = size_classes()[(sz - 1) / granularity];
+    // Slabs are aligned to their size
+    uintptr_t mask = ~(static_cast<uintptr_t>(slab_size) - 1);
+    Slab* s = reinterpret_cast<Slab*>(reinterpret_cast<uintptr_t>(p) & mask);
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(c.mtx);
+#endif // CASADI_WITH_THREAD
+    *static_cast<void**>(p) = s->free;
+    s->free = p;
+    s->live--;
+    c.live--;
+    if (!s->listed) push_front(c, s);
+    // Return empty slabs to the system, but keep one around to avoid thrashing
+    if (s->live==0 && (s->prev || s->next)) {
+      unlink(c, s);
+      c.n_slabs--;
+      slab_free(s);
+    }
+  }
+
+  casadi_int NodePool::n_live() {
+    casadi_int ret = 0;
+    for (size_t k=0; k<n_class; ++k) {
+      SizeClass& c = size_classes()[k];
+#ifdef CASADI_WITH_THREAD
+      std::lock_guard<std::mutex> lock(c.mtx);
+#endif // CASADI_WITH_THREAD
+      ret += c.live;
+    }
+    return ret;
+  }
+
+  casadi_int NodePool::n_slabs() {
+    casadi_int ret = 0;
+    for (size_t k=0; k<n_class; ++k) {
+      SizeClass& c = size_classes()[k];
+#ifdef CASADI_WITH_THREAD
+      std::lock_guard<std::mutex> lock(c.mtx);
+#endif // CASADI_WITH_THREAD
+      ret += c.n_slabs;
+    }
+    return ret;
+  }
+
+} // namespace casadi
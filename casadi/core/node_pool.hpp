@@ -0,0 +1,89 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_NODE_POOL_HPP
+#define CASADI_NODE_POOL_HPP
+
+#include "casadi_common.hpp"
+#include <cstddef>
+
+/// \cond INTERNAL
+namespace casadi {
+
+  /** \brief Size-class pools for expression graph nodes
+
+      SXNode and MXNode instances are allocated from here rather than from the
+      general purpose heap. Requests are rounded up to a multiple of
+      granularity bytes and served from slabs of slab_size bytes, each holding
+      nodes of a single size class only. Nodes that are created together hence
+      end up next to each other in memory.
+
+      Every slab keeps its own free list and a count of the live nodes in it.
+      A slab whose last node is released is handed back to the system as a
+      whole, so tearing down a large graph releases its memory in bulk. The
+      lifetime of the individual nodes is still governed by the reference
+      counting of SXElem and MX: nodes that are still referenced keep their
+      slab alive, independently of the graph they were created with.
+
+      Requests larger than max_size bytes are forwarded to the global
+      operator new.
+
+      \identifier{28w} */
+  class CASADI_EXPORT NodePool {
+  public:
+    /// Size classes are multiples of this number of bytes
+    static const size_t granularity = 16;
+
+    /// Largest request served from a pool
+    static const size_t max_size = 512;
+
+    /// Size of a slab in bytes, a power of two
+    static const size_t slab_size = 65536;
+
+    /** \brief Allocate memory for a node of sz bytes
+
+        \identifier{28x} */
+    static void* allocate(size_t sz);
+
+    /** \brief Release memory obtained with allocate(sz)
+
+        \identifier{28y} */
+    static void deallocate(void* p, size_t sz);
+
+    /** \brief Number of nodes currently allocated from the pools
+
+        \identifier{28z} */
+    static casadi_int n_live();
+
+    /** \brief Number of slabs currently held by the pools
+
+        \identifier{290} */
+    static casadi_int n_slabs();
+  };
+
+} // namespace casadi
+/// \endcond
+
+#endif // CASADI_NODE_POOL_HPP
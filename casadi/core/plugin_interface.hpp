@@ -127,6 +127,9 @@ namespace casadi {
 
   template<class Derived>
   bool PluginInterface<Derived>::has_plugin(const std::string& pname, bool verbose) {
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::recursive_mutex> lock(plugin_mutex());
+#endif //CASADI_WITH_THREAD
 
     // Quick return if available
     if (Derived::solvers_.find(pname) != Derived::solvers_.end()) {
@@ -195,6 +198,9 @@ namespace casadi {
   template<class Derived>
   typename PluginInterface<Derived>::Plugin
       PluginInterface<Derived>::load_plugin(const std::string& pname, bool register_plugin) {
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::recursive_mutex> lock(plugin_mutex());
+#endif //CASADI_WITH_THREAD
     // Issue warning and quick return if already loaded
     if (Derived::solvers_.find(pname) != Derived::solvers_.end()) {
       casadi_warning("PluginInterface: Solver " + pname + " is already in use. Ignored.");
@@ -255,6 +261,9 @@ namespace casadi {
 
   template<class Derived>
   void PluginInterface<Derived>::registerPlugin(const Plugin& plugin) {
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::recursive_mutex> lock(plugin_mutex());
+#endif //CASADI_WITH_THREAD
 
     // Check if the solver name is in use
     typename std::map<std::string, Plugin>::iterator it=Derived::solvers_.find(plugin.name);
@@ -268,6 +277,9 @@ namespace casadi {
   template<class Derived>
   typename PluginInterface<Derived>::Plugin&
   PluginInterface<Derived>::getPlugin(const std::string& pname) {
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::recursive_mutex> lock(plugin_mutex());
+#endif //CASADI_WITH_THREAD
 
     // Check if the solver has been loaded
     auto it=Derived::solvers_.find(pname);
@@ -0,0 +1,230 @@
+//
+//    MIT No Attribution
+//
+//    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl, KU Leuven.
+//
+//    Permission is hereby granted, free of charge, to any person obtaining a copy of this
+//    software and associated documentation files (the "Software"), to deal in the Software
+//    without restriction, including without limitation the rights to use, copy, modify,
+//    merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+//    permit persons to whom the Software is furnished to do so.
+//
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+// SYMBOL "band_lu"
+// LU factorization with partial pivoting of a banded n-by-n matrix
+// with kl subdiagonals and ku superdiagonals, in LAPACK band storage:
+// A(i,j) is stored in ab[kl+ku+i-j + j*(2*kl+ku+1)], the first kl rows holding fill-in.
+// Returns 1 if the matrix is singular
+template<typename T1>
+int casadi_band_lu(T1* ab, casadi_int n, casadi_int kl, casadi_int ku, casadi_int* ipiv) {
+  casadi_int ld, kv, i, j, c, km, jp, ju, flag;
+  T1 t, *abj;
+  ld = 2*kl+ku+1;
+  kv = kl+ku;
+  flag = 0;
+  ju = 0;
+  for (j=0; j<n; ++j) {
+    abj = ab + kv + j*ld;
+    km = kl<n-1-j ? kl : n-1-j;
+    // Pivot: largest entry in column j, on or below the diagonal
+    jp = 0;
+    for (i=1; i<=km; ++i) {
+      if (fabs(abj[i])>fabs(abj[jp])) jp = i;
+    }
+    ipiv[j] = j+jp;
+    if (abj[jp]==0) {
+      flag = 1;
+      continue;
+    }
+    // Last column affected by the elimination
+    if (j+ku+jp>ju) ju = j+ku+jp<n-1 ? j+ku+jp : n-1;
+    // Swap rows j and j+jp
+    if (jp!=0) {
+      for (c=j; c<=ju; ++c) {
+        t = ab[kv+j-c + c*ld];
+        ab[kv+j-c + c*ld] = ab[kv+j+jp-c + c*ld];
+        ab[kv+j+jp-c + c*ld] = t;
+      }
+    }
+    // Multipliers, skipping trailing zeros (envelope of the column)
+    while (km>0 && abj[km]==0) km--;
+    for (i=1; i<=km; ++i) abj[i] /= abj[0];
+    // Rank-1 update of the trailing columns
+    for (c=j+1; c<=ju; ++c) {
+      t = ab[kv+j-c + c*ld];
+      if (t!=0) {
+        for (i=1; i<=km; ++i) ab[kv+j+i-c + c*ld] -= abj[i]*t;
+      }
+    }
+  }
+  return flag;
+}
+
+// SYMBOL "band_trs"
+// Solve with a matrix factorized by casadi_band_lu, optionally transposed
+template<typename T1>
+void casadi_band_trs(const T1* ab, casadi_int n, casadi_int kl, casadi_int ku,
+                     const casadi_int* ipiv, T1* x, casadi_int tr) {
+  casadi_int ld, kv, i, j, km, i0;
+  T1 t;
+  const T1* abj;
+  ld = 2*kl+ku+1;
+  kv = kl+ku;
+  if (tr) {
+    // Solve with U'
+    for (j=0; j<n; ++j) {
+      abj = ab + kv + j*ld;
+      i0 = j-kv>0 ? j-kv : 0;
+      for (i=i0; i<j; ++i) x[j] -= abj[i-j]*x[i];
+      x[j] /= abj[0];
+    }
+    // Solve with L', undoing the row interchanges
+    for (j=n-2; j>=0; --j) {
+      abj = ab + kv + j*ld;
+      km = kl<n-1-j ? kl : n-1-j;
+      for (i=1; i<=km; ++i) x[j] -= abj[i]*x[j+i];
+      if (ipiv[j]!=j) {
+        t = x[j];
+        x[j] = x[ipiv[j]];
+        x[ipiv[j]] = t;
+      }
+    }
+  } else {
+    // Solve with L, applying the row interchanges
+    for (j=0; j<n-1; ++j) {
+      abj = ab + kv + j*ld;
+      km = kl<n-1-j ? kl : n-1-j;
+      if (ipiv[j]!=j) {
+        t = x[j];
+        x[j] = x[ipiv[j]];
+        x[ipiv[j]] = t;
+      }
+      for (i=1; i<=km; ++i) x[j+i] -= abj[i]*x[j];
+    }
+    // Solve with U
+    for (j=n-1; j>=0; --j) {
+      abj = ab + kv + j*ld;
+      x[j] /= abj[0];
+      i0 = j-kv>0 ? j-kv : 0;
+      for (i=i0; i<j; ++i) x[i] -= abj[i-j]*x[j];
+    }
+  }
+}
+
+// SYMBOL "band_fact"
+// Factorize a sparse matrix which, after the symmetric permutation pinv, consists of a
+// banded leading block B with bandwidths kl, ku and a dense border of nb rows and columns:
+//   [B E; F C]
+// B is factorized with casadi_band_lu, as is the Schur complement S = C - F*B^{-1}*E,
+// treated as a full band matrix.
+// The structure bp is made up of: n, nb, kl, ku, pinv[n].
+// Returns 1 if the matrix is singular
+// len[iw] >= n, len[w] >= (2*kl+ku+1)*m + 2*m*nb + (3*nb-2)*nb + n with m = n-nb
+template<typename T1>
+int casadi_band_fact(const casadi_int* sp_a, const T1* a, const casadi_int* bp,
+                     casadi_int* iw, T1* w) {
+  casadi_int n, nb, kl, ku, m, ld, lds, kvs, r, c, pr, pc, i, j, k, flag;
+  const casadi_int *a_colind, *a_row, *pinv;
+  T1 *ab, *x, *f, *s;
+  // Extract structure
+  n=bp[0]; nb=bp[1]; kl=bp[2]; ku=bp[3]; pinv=bp+4;
+  m = n-nb;
+  a_colind=sp_a+2; a_row=sp_a+2+n+1;
+  // Partition work vector
+  ld = 2*kl+ku+1;
+  lds = nb>0 ? 3*nb-2 : 0;
+  kvs = nb>0 ? 2*nb-2 : 0;
+  ab=w; x=ab+ld*m; f=x+m*nb; s=f+nb*m;
+  for (i=0; i<ld*m + 2*m*nb + lds*nb; ++i) w[i] = 0;
+  // Scatter nonzeros to the blocks, E is stored in x
+  for (c=0; c<n; ++c) {
+    pc = pinv[c];
+    for (k=a_colind[c]; k<a_colind[c+1]; ++k) {
+      r = a_row[k];
+      pr = pinv[r];
+      if (pc<m) {
+        if (pr<m) {
+          ab[kl+ku+pr-pc + pc*ld] = a[k];
+        } else {
+          f[pr-m + pc*nb] = a[k];
+        }
+      } else {
+        if (pr<m) {
+          x[pr + (pc-m)*m] = a[k];
+        } else {
+          s[kvs+pr-pc + (pc-m)*lds] = a[k];
+        }
+      }
+    }
+  }
+  // Factorize B
+  flag = casadi_band_lu(ab, m, kl, ku, iw);
+  if (nb==0) return flag;
+  // x = B^{-1}*E
+  for (j=0; j<nb; ++j) casadi_band_trs(ab, m, kl, ku, iw, x+j*m, 0);
+  // S = C - F*x
+  for (j=0; j<nb; ++j) {
+    for (k=0; k<m; ++k) {
+      if (x[k+j*m]==0) continue;
+      for (i=0; i<nb; ++i) s[kvs+i-j + j*lds] -= f[i+k*nb]*x[k+j*m];
+    }
+  }
+  // Factorize S
+  if (casadi_band_lu(s, nb, nb-1, nb-1, iw+m)) flag = 1;
+  return flag;
+}
+
+// SYMBOL "band_solve"
+// Linear solve using a matrix factorized with casadi_band_fact
+// The last n entries of w are used as work vector
+template<typename T1>
+void casadi_band_solve(T1* x, casadi_int nrhs, casadi_int tr, const casadi_int* bp,
+                       const casadi_int* iw, T1* w) {
+  casadi_int n, nb, kl, ku, m, ld, lds, i, j, k, r;
+  const casadi_int *pinv;
+  const T1 *ab, *xe, *f, *s;
+  T1 *y;
+  // Extract structure
+  n=bp[0]; nb=bp[1]; kl=bp[2]; ku=bp[3]; pinv=bp+4;
+  m = n-nb;
+  // Partition work vector
+  ld = 2*kl+ku+1;
+  lds = nb>0 ? 3*nb-2 : 0;
+  ab=w; xe=ab+ld*m; f=xe+m*nb; s=f+nb*m;
+  y = w + ld*m + 2*m*nb + lds*nb;
+  for (r=0; r<nrhs; ++r) {
+    // Permute
+    for (i=0; i<n; ++i) y[pinv[i]] = x[i];
+    if (tr) {
+      // [B' F'; E' C'] * [y1; y2] = [b1; b2]
+      for (j=0; j<nb; ++j) {
+        for (k=0; k<m; ++k) y[m+j] -= xe[k+j*m]*y[k];
+      }
+      if (nb>0) casadi_band_trs(s, nb, nb-1, nb-1, iw+m, y+m, 1);
+      for (k=0; k<m; ++k) {
+        for (i=0; i<nb; ++i) y[k] -= f[i+k*nb]*y[m+i];
+      }
+      casadi_band_trs(ab, m, kl, ku, iw, y, 1);
+    } else {
+      // [B E; F C] * [y1; y2] = [b1; b2]
+      casadi_band_trs(ab, m, kl, ku, iw, y, 0);
+      for (k=0; k<m; ++k) {
+        for (i=0; i<nb; ++i) y[m+i] -= f[i+k*nb]*y[k];
+      }
+      if (nb>0) casadi_band_trs(s, nb, nb-1, nb-1, iw+m, y+m, 0);
+      for (j=0; j<nb; ++j) {
+        for (k=0; k<m; ++k) y[k] -= xe[k+j*m]*y[m+j];
+      }
+    }
+    // Permute back
+    for (i=0; i<n; ++i) x[i] = y[pinv[i]];
+    x += n;
+  }
+}
@@ -33,6 +33,59 @@ void casadi_bfgs(const casadi_int* sp_h, T1* h, const T1* dx,
   casadi_rank1(h, sp_h, -phi, qk, qk);
 }
 
+// SYMBOL "bfgs_block"
+// Damped BFGS update, independently for each diagonal block of a block-diagonal H
+// blk[i] is the index of the block containing variable i, nb the number of blocks
+template<typename T1>
+void casadi_bfgs_block(const casadi_int* sp_h, T1* h, const T1* dx,
+                       const T1* glag, const T1* glag_old,
+                       casadi_int nb, const casadi_int* blk, T1* w) {
+  // Local variables
+  casadi_int nx, i, b, c, k;
+  const casadi_int *colind, *row;
+  T1 *yk, *qk, *sBs, *sy, *omega;
+  // Dimension, sparsity
+  nx = sp_h[0];
+  colind = sp_h+2; row = sp_h+nx+3;
+  // Work vectors
+  yk = w; w += nx;
+  qk = w; w += nx;
+  sBs = w; w += nb;
+  sy = w; w += nb;
+  omega = w; w += nb;
+  // yk = glag - glag_old
+  casadi_copy(glag, nx, yk);
+  casadi_axpy(nx, -1., glag_old, yk);
+  // qk = H*dx, which does not couple the blocks
+  casadi_clear(qk, nx);
+  casadi_mv(h, sp_h, dx, qk, 0);
+  // Blockwise dx'*H*dx and dx'*yk
+  casadi_clear(sBs, nb);
+  casadi_clear(sy, nb);
+  for (i=0; i<nx; ++i) {
+    sBs[blk[i]] += dx[i] * qk[i];
+    sy[blk[i]] += dx[i] * yk[i];
+  }
+  // Powell damping of each block
+  for (b=0; b<nb; ++b) {
+    omega[b] = sy[b] < 0.2 * sBs[b] ? 0.8 * sBs[b] / (sBs[b] - sy[b]) : 1;
+  }
+  casadi_clear(sy, nb);
+  for (i=0; i<nx; ++i) {
+    b = blk[i];
+    yk[i] = omega[b] * yk[i] + (1 - omega[b]) * qk[i];
+    sy[b] += dx[i] * yk[i];
+  }
+  // Update H, skipping blocks without a step
+  for (c=0; c<nx; ++c) {
+    b = blk[c];
+    if (!(sBs[b] > 0 && sy[b] > 0)) continue;
+    for (k=colind[c]; k<colind[c+1]; ++k) {
+      h[k] += yk[row[k]] * yk[c] / sy[b] - qk[row[k]] * qk[c] / sBs[b];
+    }
+  }
+}
+
 // SYMBOL "bfgs_reset"
 // Removes off-diagonal entries
 template<typename T1>
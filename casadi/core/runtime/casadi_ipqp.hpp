@@ -23,6 +23,7 @@
 // C-REPLACE "std::numeric_limits<T1>::min()" "casadi_real_min"
 // C-REPLACE "std::numeric_limits<T1>::infinity()" "casadi_inf"
 // C-REPLACE "static_cast<int>" "(int) "
+// C-REPLACE "std::sqrt" "sqrt"
 // SYMBOL "ipqp_prob"
 template<typename T1>
 struct casadi_ipqp_prob {
@@ -34,6 +35,8 @@ struct casadi_ipqp_prob {
   T1 inf;
   // Maximum number of iterations
   casadi_int max_iter;
+  // Maximum number of centrality corrections per iteration
+  casadi_int max_corr;
   // Error tolerance
   T1 pr_tol, du_tol, co_tol, mu_tol;
 };
@@ -48,6 +51,7 @@ void casadi_ipqp_setup(casadi_ipqp_prob<T1>* p, casadi_int nx, casadi_int na) {
   p->dmin = std::numeric_limits<T1>::min();
   p->inf = std::numeric_limits<T1>::infinity();
   p->max_iter = 100;
+  p->max_corr = 0;
   p->pr_tol = 1e-8;
   p->du_tol = 1e-8;
   p->co_tol = 1e-8;
@@ -72,14 +76,15 @@ typedef enum {
   IPQP_FACTOR,
   IPQP_SOLVE} casadi_ipqp_task_t;
 
-// SYMBOL "ipqp_task_t"
+// SYMBOL "ipqp_next_t"
 typedef enum {
   IPQP_RESET,
   IPQP_RESIDUAL,
   IPQP_NEWITER,
   IPQP_PREPARE,
   IPQP_PREDICTOR,
-  IPQP_CORRECTOR} casadi_ipqp_next_t;
+  IPQP_CORRECTOR,
+  IPQP_CENTERING} casadi_ipqp_next_t;
 
 // SYMBOL "ipqp_blocker_t"
 typedef enum {
@@ -113,6 +118,10 @@ struct casadi_ipqp_data {
   T1 mu;
   // Stepsize
   T1 tau;
+  // Centering parameter, maximum step size in the current search direction
+  T1 sigma, alpha;
+  // Number of centrality corrections in the current iteration
+  casadi_int n_corr;
   // Primal and dual error, complementarity error, corresponding index
   T1 pr, du, co;
   casadi_int ipr, idu, ico;
@@ -124,6 +133,8 @@ struct casadi_ipqp_data {
   T1 *z, *lam, *lam_lbz, *lam_ubz;
   // Step
   T1 *dz, *dlam, *dlam_lbz, *dlam_ubz;
+  // Step before the last centrality correction
+  T1 *pdz, *pdlam, *pdlam_lbz, *pdlam_ubz;
   // Residual
   T1 *rz, *rlam, *rlam_lbz, *rlam_ubz;
   // Diagonal entries
@@ -151,6 +162,12 @@ casadi_int casadi_ipqp_sz_w(const casadi_ipqp_prob<T1>* p) {
   sz_w += p->nz; // dlam
   sz_w += p->nz; // dlam_lbz
   sz_w += p->nz; // dlam_ubz
+  if (p->max_corr > 0) {
+    sz_w += p->nz; // pdz
+    sz_w += p->nz; // pdlam
+    sz_w += p->nz; // pdlam_lbz
+    sz_w += p->nz; // pdlam_ubz
+  }
   sz_w += p->nz; // rz
   sz_w += p->nz; // rlam
   sz_w += p->nz; // rlam_lbz
@@ -177,6 +194,14 @@ void casadi_ipqp_init(casadi_ipqp_data<T1>* d, casadi_int** iw, T1** w) {
   d->dlam = *w; *w += p->nz;
   d->dlam_lbz = *w; *w += p->nz;
   d->dlam_ubz = *w; *w += p->nz;
+  if (p->max_corr > 0) {
+    d->pdz = *w; *w += p->nz;
+    d->pdlam = *w; *w += p->nz;
+    d->pdlam_lbz = *w; *w += p->nz;
+    d->pdlam_ubz = *w; *w += p->nz;
+  } else {
+    d->pdz = d->pdlam = d->pdlam_lbz = d->pdlam_ubz = 0;
+  }
   d->rz = *w; *w += p->nz;
   d->rlam = *w; *w += p->nz;
   d->rlam_lbz = *w; *w += p->nz;
@@ -532,47 +557,6 @@ int casadi_ipqp_maxstep(casadi_ipqp_data<T1>* d, T1* alpha, casadi_int* ind) {
   return flag;
 }
 
-// SYMBOL "ipqp_predictor"
-template<typename T1>
-void casadi_ipqp_predictor(casadi_ipqp_data<T1>* d) {
-  // Local variables
-  casadi_int k;
-  T1 t, alpha, sigma;
-  const casadi_ipqp_prob<T1>* p = d->prob;
-  // Scale results
-  for (k=0; k<p->nz; ++k) d->dz[k] *= d->S[k];
-  // Calculate step in z(g), lam(g)
-  for (k=p->nx; k<p->nz; ++k) {
-    if (d->S[k] == 0.) {
-      // Eliminate
-      d->dlam[k] = d->dz[k] = 0;
-    } else {
-      t = d->D[k] / (d->S[k] * d->S[k]) * (d->dz[k] - d->dlam[k]);
-      d->dlam[k] = d->dz[k];
-      d->dz[k] = t;
-    }
-  }
-  // Finish calculation in dlam_lbz, dlam_ubz
-  for (k=0; k<p->nz; ++k) {
-    d->dlam_lbz[k] -= d->lam_lbz[k] * d->dz[k];
-    d->dlam_lbz[k] *= d->dinv_lbz[k];
-  }
-  for (k=0; k<p->nz; ++k) {
-    d->dlam_ubz[k] += d->lam_ubz[k] * d->dz[k];
-    d->dlam_ubz[k] *= d->dinv_ubz[k];
-  }
-  // Finish calculation of dlam(x)
-  for (k=0; k<p->nx; ++k) d->dlam[k] += d->dlam_ubz[k] - d->dlam_lbz[k];
-  // Maximum primal and dual step
-  (void)casadi_ipqp_maxstep(d, &alpha, 0);
-  // Calculate sigma
-  sigma = casadi_ipqp_sigma(d, alpha);
-  // Prepare corrector step
-  casadi_ipqp_corrector_prepare(d, -sigma * d->mu);
-  // Solve to get step
-  d->linsys = d->rz;
-}
-
 // SYMBOL "ipqp_step"
 template<typename T1>
 void casadi_ipqp_step(casadi_ipqp_data<T1>* d, T1 alpha_pr, T1 alpha_du) {
@@ -630,15 +614,12 @@ T1 casadi_ipqp_sigma(casadi_ipqp_data<T1>* d, T1 alpha) {
   return sigma;
 }
 
-// SYMBOL "ipqp_corrector_prepare"
+// SYMBOL "ipqp_corrector_rhs"
 template<typename T1>
-void casadi_ipqp_corrector_prepare(casadi_ipqp_data<T1>* d, T1 shift) {
+void casadi_ipqp_corrector_rhs(casadi_ipqp_data<T1>* d) {
   // Local variables
   casadi_int k;
   const casadi_ipqp_prob<T1>* p = d->prob;
-  // Modified residual in lam_lbz, lam_ubz
-  for (k=0; k<p->nz; ++k) d->rlam_lbz[k] = d->dlam_lbz[k] * d->dz[k] + shift;
-  for (k=0; k<p->nz; ++k) d->rlam_ubz[k] = -d->dlam_ubz[k] * d->dz[k] + shift;
   // Difference in tilde(r)_x, tilde(r)_lamg
   for (k=0; k<p->nz; ++k)
     d->rz[k] = d->dinv_lbz[k] * d->rlam_lbz[k]
@@ -657,13 +638,66 @@ void casadi_ipqp_corrector_prepare(casadi_ipqp_data<T1>* d, T1 shift) {
   for (k=0; k<p->nz; ++k) d->rz[k] *= -d->S[k];
 }
 
-// SYMBOL "ipqp_corrector"
+// SYMBOL "ipqp_corrector_prepare"
 template<typename T1>
-void casadi_ipqp_corrector(casadi_ipqp_data<T1>* d) {
+void casadi_ipqp_corrector_prepare(casadi_ipqp_data<T1>* d, T1 shift) {
   // Local variables
-  T1 t, mu_test, primal_slack, primal_step, dual_slack, dual_step, max_tau;
   casadi_int k;
-  int flag;
+  const casadi_ipqp_prob<T1>* p = d->prob;
+  // Modified residual in lam_lbz, lam_ubz
+  for (k=0; k<p->nz; ++k) d->rlam_lbz[k] = d->dlam_lbz[k] * d->dz[k] + shift;
+  for (k=0; k<p->nz; ++k) d->rlam_ubz[k] = -d->dlam_ubz[k] * d->dz[k] + shift;
+  // Right-hand-side for the correction
+  casadi_ipqp_corrector_rhs(d);
+}
+
+// SYMBOL "ipqp_predictor"
+template<typename T1>
+void casadi_ipqp_predictor(casadi_ipqp_data<T1>* d) {
+  // Local variables
+  casadi_int k;
+  T1 t, alpha, sigma;
+  const casadi_ipqp_prob<T1>* p = d->prob;
+  // Scale results
+  for (k=0; k<p->nz; ++k) d->dz[k] *= d->S[k];
+  // Calculate step in z(g), lam(g)
+  for (k=p->nx; k<p->nz; ++k) {
+    if (d->S[k] == 0.) {
+      // Eliminate
+      d->dlam[k] = d->dz[k] = 0;
+    } else {
+      t = d->D[k] / (d->S[k] * d->S[k]) * (d->dz[k] - d->dlam[k]);
+      d->dlam[k] = d->dz[k];
+      d->dz[k] = t;
+    }
+  }
+  // Finish calculation in dlam_lbz, dlam_ubz
+  for (k=0; k<p->nz; ++k) {
+    d->dlam_lbz[k] -= d->lam_lbz[k] * d->dz[k];
+    d->dlam_lbz[k] *= d->dinv_lbz[k];
+  }
+  for (k=0; k<p->nz; ++k) {
+    d->dlam_ubz[k] += d->lam_ubz[k] * d->dz[k];
+    d->dlam_ubz[k] *= d->dinv_ubz[k];
+  }
+  // Finish calculation of dlam(x)
+  for (k=0; k<p->nx; ++k) d->dlam[k] += d->dlam_ubz[k] - d->dlam_lbz[k];
+  // Maximum primal and dual step
+  (void)casadi_ipqp_maxstep(d, &alpha, 0);
+  // Calculate sigma
+  d->sigma = sigma = casadi_ipqp_sigma(d, alpha);
+  // Prepare corrector step
+  casadi_ipqp_corrector_prepare(d, -sigma * d->mu);
+  // Solve to get step
+  d->linsys = d->rz;
+}
+
+// SYMBOL "ipqp_correct"
+template<typename T1>
+void casadi_ipqp_correct(casadi_ipqp_data<T1>* d) {
+  // Local variables
+  T1 t;
+  casadi_int k;
   const casadi_ipqp_prob<T1>* p = d->prob;
   // Scale results
   for (k=0; k<p->nz; ++k) d->rz[k] *= d->S[k];
@@ -693,6 +727,103 @@ void casadi_ipqp_corrector(casadi_ipqp_data<T1>* d) {
     d->dlam_ubz[k] += t;
     if (k<p->nx) d->dlam[k] += t;
   }
+}
+
+// SYMBOL "ipqp_corrector"
+template<typename T1>
+void casadi_ipqp_corrector(casadi_ipqp_data<T1>* d) {
+  // Add correction to the step
+  casadi_ipqp_correct(d);
+  // Maximum primal and dual step
+  (void)casadi_ipqp_maxstep(d, &d->alpha, 0);
+  // No centrality corrections yet
+  d->n_corr = 0;
+}
+
+// SYMBOL "ipqp_centering_target"
+template<typename T1>
+T1 casadi_ipqp_centering_target(T1 v, T1 mu_target) {
+  // Bring complementarity product into [0.1, 10] * mu_target
+  if (v < 0.1 * mu_target) {
+    return 0.1 * mu_target - v;
+  } else if (v > 10 * mu_target) {
+    return fmax(10 * mu_target - v, -10 * mu_target);
+  } else {
+    return 0;
+  }
+}
+
+// SYMBOL "ipqp_centering_prepare"
+template<typename T1>
+int casadi_ipqp_centering_prepare(casadi_ipqp_data<T1>* d) {
+  // Local variables
+  casadi_int k;
+  T1 alpha, mu_target;
+  const casadi_ipqp_prob<T1>* p = d->prob;
+  // Quick return if no more corrections, full step or no inequalities
+  if (d->n_corr >= p->max_corr || d->alpha >= 1. || d->n_con == 0) return 0;
+  // Enhanced step size and target complementarity, as in Gondzio (1996)
+  alpha = fmin(1.08 * d->alpha + 0.08, 1.);
+  mu_target = d->sigma * d->mu;
+  // Complementarity residual for the enhanced step, projected onto the target region
+  for (k = 0; k < p->nz; ++k) {
+    // Lower bound
+    if (d->lbz[k] > -p->inf && d->ubz[k] > d->lbz[k] + p->dmin) {
+      d->rlam_lbz[k] = -casadi_ipqp_centering_target((d->lam_lbz[k] + alpha * d->dlam_lbz[k])
+        * (d->z[k] - d->lbz[k] + alpha * d->dz[k]), mu_target);
+    } else {
+      d->rlam_lbz[k] = 0;
+    }
+    // Upper bound
+    if (d->ubz[k] < p->inf && d->ubz[k] > d->lbz[k] + p->dmin) {
+      d->rlam_ubz[k] = -casadi_ipqp_centering_target((d->lam_ubz[k] + alpha * d->dlam_ubz[k])
+        * (d->ubz[k] - d->z[k] - alpha * d->dz[k]), mu_target);
+    } else {
+      d->rlam_ubz[k] = 0;
+    }
+  }
+  // Right-hand-side for the correction
+  casadi_ipqp_corrector_rhs(d);
+  // Solve to get correction
+  d->linsys = d->rz;
+  return 1;
+}
+
+// SYMBOL "ipqp_centering"
+template<typename T1>
+int casadi_ipqp_centering(casadi_ipqp_data<T1>* d) {
+  // Local variables
+  T1 alpha;
+  const casadi_ipqp_prob<T1>* p = d->prob;
+  // Keep step in case the correction is rejected
+  casadi_copy(d->dz, p->nz, d->pdz);
+  casadi_copy(d->dlam, p->nz, d->pdlam);
+  casadi_copy(d->dlam_lbz, p->nz, d->pdlam_lbz);
+  casadi_copy(d->dlam_ubz, p->nz, d->pdlam_ubz);
+  // Add correction to the step
+  casadi_ipqp_correct(d);
+  d->n_corr++;
+  // Accept if the step size increases sufficiently
+  alpha = d->alpha;
+  (void)casadi_ipqp_maxstep(d, &d->alpha, 0);
+  if (d->alpha >= 1.01 * alpha) return 1;
+  // Restore step
+  casadi_copy(d->pdz, p->nz, d->dz);
+  casadi_copy(d->pdlam, p->nz, d->dlam);
+  casadi_copy(d->pdlam_lbz, p->nz, d->dlam_lbz);
+  casadi_copy(d->pdlam_ubz, p->nz, d->dlam_ubz);
+  d->alpha = alpha;
+  return 0;
+}
+
+// SYMBOL "ipqp_linesearch"
+template<typename T1>
+void casadi_ipqp_linesearch(casadi_ipqp_data<T1>* d) {
+  // Local variables
+  T1 mu_test, primal_slack, primal_step, dual_slack, dual_step, max_tau;
+  casadi_int k;
+  int flag;
+  const casadi_ipqp_prob<T1>* p = d->prob;
   // Find the largest step size, keeping track of blocking constraints
   flag = casadi_ipqp_maxstep(d, &max_tau, &k);
   // Handle blocking constraints using Mehrotra's heuristic
@@ -768,9 +899,27 @@ int casadi_ipqp(casadi_ipqp_data<T1>* d) {
       d->next = IPQP_CORRECTOR;
       return 1;
     case IPQP_CORRECTOR:
-      // Complete predictor step
+      // Complete corrector step
       if (d->status == IPQP_SOLVE_ERROR) break;
       casadi_ipqp_corrector(d);
+      if (casadi_ipqp_centering_prepare(d)) {
+        d->task = IPQP_SOLVE;
+        d->next = IPQP_CENTERING;
+        return 1;
+      }
+      casadi_ipqp_linesearch(d);
+      d->task = IPQP_MV;
+      d->next = IPQP_RESIDUAL;
+      return 1;
+    case IPQP_CENTERING:
+      // Complete centrality correction
+      if (d->status == IPQP_SOLVE_ERROR) break;
+      if (casadi_ipqp_centering(d) && casadi_ipqp_centering_prepare(d)) {
+        d->task = IPQP_SOLVE;
+        d->next = IPQP_CENTERING;
+        return 1;
+      }
+      casadi_ipqp_linesearch(d);
       d->task = IPQP_MV;
       d->next = IPQP_RESIDUAL;
       return 1;
@@ -17,15 +17,14 @@
 //    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //
 
-// SYMBOL "ldl"
-// Calculate the nonzeros of the transposed L factor (strictly lower entries only)
-// as well as D for an LDL^T factorization
-// len[w] >= n
+// SYMBOL "ldl_copy"
+// Sparse copy of the permuted matrix A to the transposed L factor and D, cf. casadi_ldl
+// len[w] >= n, w is zero on exit
 template<typename T1>
-void casadi_ldl(const casadi_int* sp_a, const T1* a,
-                const casadi_int* sp_lt, T1* lt, T1* d, const casadi_int* p, T1* w) {
+void casadi_ldl_copy(const casadi_int* sp_a, const T1* a,
+                     const casadi_int* sp_lt, T1* lt, T1* d, const casadi_int* p, T1* w) {
   const casadi_int *lt_colind, *lt_row, *a_colind, *a_row;
-  casadi_int n, r, c, c1, k, k2;
+  casadi_int n, r, c, c1, k;
   // Extract sparsities
   n=sp_lt[1];
   lt_colind=sp_lt+2; lt_row=sp_lt+2+n+1;
@@ -40,8 +39,24 @@ void casadi_ldl(const casadi_int* sp_a, const T1* a,
     d[c] = w[p[c]];
     for (k=a_colind[c1]; k<a_colind[c1+1]; ++k) w[a_row[k]] = 0;
   }
+}
+
+// SYMBOL "ldl_cols"
+// Calculate the columns c0, ..., c1-1 of the transposed L factor as well as D,
+// after casadi_ldl_copy and with all preceding columns in the same subtree of the
+// elimination tree calculated. Since only entries of w corresponding to the
+// subtree are accessed, disjoint subtrees can be calculated concurrently.
+// len[w] >= n, w is zero on entry and on exit
+template<typename T1>
+void casadi_ldl_cols(const casadi_int* sp_lt, T1* lt, T1* d, T1* w,
+                     casadi_int c0, casadi_int c1) {
+  const casadi_int *lt_colind, *lt_row;
+  casadi_int n, r, c, k, k2;
+  // Extract sparsity
+  n=sp_lt[1];
+  lt_colind=sp_lt+2; lt_row=sp_lt+2+n+1;
   // Loop over columns of L
-  for (c=0; c<n; ++c) {
+  for (c=c0; c<c1; ++c) {
     for (k=lt_colind[c]; k<lt_colind[c+1]; ++k) {
       r = lt_row[k];
       // Calculate l(r,c) with r<c
@@ -58,6 +73,205 @@ void casadi_ldl(const casadi_int* sp_a, const T1* a,
   }
 }
 
+// SYMBOL "ldl"
+// Calculate the nonzeros of the transposed L factor (strictly lower entries only)
+// as well as D for an LDL^T factorization
+// len[w] >= n
+template<typename T1>
+void casadi_ldl(const casadi_int* sp_a, const T1* a,
+                const casadi_int* sp_lt, T1* lt, T1* d, const casadi_int* p, T1* w) {
+  casadi_ldl_copy(sp_a, a, sp_lt, lt, d, p, w);
+  casadi_ldl_cols(sp_lt, lt, d, w, 0, sp_lt[1]);
+}
+
+// SYMBOL "ldl_super_range"
+// Factorize the supernodes s0, ..., s1-1 for casadi_ldl_super, see there for the
+// structure sn, with all supernodes updating them either in the range or linked in iw.
+// Supernodes in the range are linked to the next supernode they update only if it
+// precedes sl, the others are left for casadi_ldl_super_link. Besides the shared
+// work vectors iw and w of casadi_ldl_super, the private work vectors iw2 and w2
+// are used, such that disjoint subtrees of supernodes can be factorized concurrently.
+// len[iw2] >= n, len[w2] >= 8*n, w2 is zero on entry and on exit
+template<typename T1>
+void casadi_ldl_super_range(const casadi_int* sp_a, const T1* a, const casadi_int* sn,
+                            const casadi_int* p, casadi_int s0, casadi_int s1, casadi_int sl,
+                            casadi_int* iw, T1* w, casadi_int* iw2, T1* w2) {
+  const casadi_int *a_colind, *a_row, *super, *rptr, *pptr, *colsup, *srow;
+  casadi_int n, nsuper, s, t, tnext, f, l, nc, nr, r0, ft, nct, nrt, rt0, i, j, jj, k, q, q1;
+  casadi_int *map, *head, *next, *pos;
+  T1 *panel, *x, *v, *ps, *pt, *ptk, dj, lkj, v0, v1, v2, v3;
+  // Extract sparsities
+  n=sn[0]; nsuper=sn[1];
+  super=sn+2; rptr=super+nsuper+1; pptr=rptr+nsuper+1; colsup=pptr+nsuper+1;
+  srow=colsup+n;
+  a_colind=sp_a+2; a_row=sp_a+2+n+1;
+  // Partition work vectors
+  head=iw; next=head+nsuper; pos=next+nsuper;
+  panel=w;
+  map=iw2;
+  x=w2; v=x+4*n;
+  // Loop over supernodes
+  for (s=s0; s<s1; ++s) {
+    f=super[s]; l=super[s+1]; nc=l-f;
+    r0=rptr[s]; nr=rptr[s+1]-r0;
+    ps=panel+pptr[s];
+    // Local row index in panel
+    for (i=0; i<nr; ++i) map[srow[r0+i]] = i;
+    // Sparse copy of A to the lower trapezoidal panel
+    for (j=0; j<nc; ++j) {
+      for (k=a_colind[p[f+j]]; k<a_colind[p[f+j]+1]; ++k) x[a_row[k]] = a[k];
+      for (i=0; i<j; ++i) ps[i+j*nr] = 0;
+      for (i=j; i<nr; ++i) ps[i+j*nr] = x[p[srow[r0+i]]];
+      for (k=a_colind[p[f+j]]; k<a_colind[p[f+j]+1]; ++k) x[a_row[k]] = 0;
+    }
+    // Left-looking updates from preceding supernodes with rows in f..l-1
+    for (t=head[s]; t>=0; t=tnext) {
+      tnext = next[t];
+      ft=super[t]; nct=super[t+1]-ft;
+      rt0=rptr[t]; nrt=rptr[t+1]-rt0;
+      pt=panel+pptr[t];
+      // Rows q..q1-1 of supernode t fall in supernode s
+      q=pos[t];
+      for (q1=q; q1<nrt && srow[rt0+q1]<l; ++q1) {}
+      for (j=q; j<q1; j+=4) {
+        // v = D_t * L_t(j:j+3, :)', zero-padded beyond q1
+        for (jj=0; jj<4; ++jj) {
+          for (k=0; k<nct; ++k) {
+            v[k+jj*nct] = j+jj<q1 ? pt[k+k*nrt] * pt[j+jj+k*nrt] : 0;
+          }
+        }
+        // x = L_t(j:end, :) * v
+        for (k=0; k<nct; ++k) {
+          ptk = pt+k*nrt;
+          v0 = v[k]; v1 = v[k+nct]; v2 = v[k+2*nct]; v3 = v[k+3*nct];
+          for (i=j; i<nrt; ++i) {
+            x[i] += ptk[i] * v0;
+            x[i+n] += ptk[i] * v1;
+            x[i+2*n] += ptk[i] * v2;
+            x[i+3*n] += ptk[i] * v3;
+          }
+        }
+        // Scatter to columns srow[j:j+3]-f of the panel
+        for (jj=0; jj<4; ++jj) {
+          if (j+jj<q1) {
+            for (i=j+jj; i<nrt; ++i) {
+              ps[map[srow[rt0+i]] + (srow[rt0+j+jj]-f)*nr] -= x[i+jj*n];
+            }
+          }
+          for (i=j; i<nrt; ++i) x[i+jj*n] = 0;
+        }
+      }
+      // Move on to the next supernode that t updates, if any
+      pos[t] = q1;
+      if (q1<nrt) {
+        k = colsup[srow[rt0+q1]];
+        if (k<sl) {
+          next[t] = head[k];
+          head[k] = t;
+        }
+      }
+    }
+    // Dense LDL^T factorization of the panel
+    for (j=0; j<nc; ++j) {
+      dj = ps[j+j*nr];
+      for (i=j+1; i<nr; ++i) ps[i+j*nr] /= dj;
+      for (k=j+1; k<nc; ++k) {
+        lkj = ps[k+j*nr] * dj;
+        for (i=k; i<nr; ++i) ps[i+k*nr] -= ps[i+j*nr] * lkj;
+      }
+    }
+    // Register the first update to a later supernode, if any
+    pos[s] = nc;
+    if (nc<nr) {
+      k = colsup[srow[r0+nc]];
+      if (k<sl) {
+        next[s] = head[k];
+        head[k] = s;
+      }
+    }
+  }
+}
+
+// SYMBOL "ldl_super_link"
+// Link the supernodes s0, ..., s1-1, factorized by casadi_ldl_super_range with sl=s1,
+// to the next supernode they update
+inline
+void casadi_ldl_super_link(const casadi_int* sn, casadi_int s0, casadi_int s1, casadi_int* iw) {
+  const casadi_int *super, *rptr, *colsup, *srow;
+  casadi_int n, nsuper, t, k, *head, *next, *pos;
+  // Extract sparsities
+  n=sn[0]; nsuper=sn[1];
+  super=sn+2; rptr=super+nsuper+1; colsup=rptr+2*(nsuper+1);
+  srow=colsup+n;
+  // Partition work vectors
+  head=iw; next=head+nsuper; pos=next+nsuper;
+  for (t=s0; t<s1; ++t) {
+    if (pos[t]<rptr[t+1]-rptr[t]) {
+      k = colsup[srow[rptr[t]+pos[t]]];
+      next[t] = head[k];
+      head[k] = t;
+    }
+  }
+}
+
+// SYMBOL "ldl_super_copy"
+// Copy the panels factorized by casadi_ldl_super_range to the transposed L factor and D
+// len[iw] >= n
+template<typename T1>
+void casadi_ldl_super_copy(const casadi_int* sn, const casadi_int* sp_lt, T1* lt, T1* d,
+                           const T1* panel, casadi_int* iw) {
+  const casadi_int *lt_colind, *super, *rptr, *pptr, *srow;
+  casadi_int n, nsuper, s, f, nc, r0, nr, i, j, k;
+  const T1* ps;
+  // Extract sparsities
+  n=sn[0]; nsuper=sn[1];
+  super=sn+2; rptr=super+nsuper+1; pptr=rptr+nsuper+1;
+  srow=pptr+nsuper+1+n;
+  lt_colind=sp_lt+2;
+  // Next free entry in each column of Lt
+  for (i=0; i<n; ++i) iw[i] = lt_colind[i];
+  for (s=0; s<nsuper; ++s) {
+    f=super[s]; nc=super[s+1]-f;
+    r0=rptr[s]; nr=rptr[s+1]-r0;
+    ps=panel+pptr[s];
+    for (j=0; j<nc; ++j) d[f+j] = ps[j+j*nr];
+    for (i=1; i<nr; ++i) {
+      k = srow[r0+i];
+      for (j=0; j<nc && j<i; ++j) lt[iw[k]++] = ps[i+j*nr];
+    }
+  }
+}
+
+// SYMBOL "ldl_super"
+// Supernodal variant of casadi_ldl, with the same output
+// The supernodal partition sn is made up of:
+//   n, nsuper, super[nsuper+1], rptr[nsuper+1], pptr[nsuper+1], colsup[n], srow[rptr[nsuper]]
+// where supernode s is made up of the columns super[s], ..., super[s+1]-1 of L,
+// sharing the row indices srow[rptr[s]], ..., srow[rptr[s+1]-1], the first ones
+// being the columns themselves. sp_lt must contain all entries of the supernodes,
+// explicit zeros included. Supernodes are factorized in dense column-major panels
+// starting at pptr[s], with left-looking updates from the preceding supernodes,
+// four columns at a time.
+// len[iw] >= 3*nsuper + n, len[w] >= pptr[nsuper] + 8*n
+template<typename T1>
+void casadi_ldl_super(const casadi_int* sp_a, const T1* a, const casadi_int* sn,
+                      const casadi_int* sp_lt, T1* lt, T1* d, const casadi_int* p,
+                      casadi_int* iw, T1* w) {
+  casadi_int n, nsuper, i, *iw2;
+  T1 *w2;
+  n=sn[0]; nsuper=sn[1];
+  // Private work vectors
+  iw2=iw+3*nsuper;
+  w2=w+sn[2+3*nsuper+2];
+  // Clear work vectors
+  for (i=0; i<8*n; ++i) w2[i] = 0;
+  for (i=0; i<nsuper; ++i) iw[i] = -1;
+  // Factorize
+  casadi_ldl_super_range(sp_a, a, sn, p, 0, nsuper, nsuper, iw, w, iw2, w2);
+  // Copy panels to the transposed L factor and D
+  casadi_ldl_super_copy(sn, sp_lt, lt, d, w, iw2);
+}
+
 // SYMBOL "ldl_trs"
 // Solve for (I+R) with R an optionally transposed strictly upper triangular matrix.
 template<typename T1>
@@ -107,3 +321,71 @@ void casadi_ldl_solve(T1* x, casadi_int nrhs, const casadi_int* sp_lt, const T1*
     x += n;
   }
 }
+
+// SYMBOL "ldl_trs_block"
+// Variant of casadi_ldl_trs for nb right-hand sides at once, stored row by row,
+// i.e. x[i*nb+j] holds element i of right-hand side j
+template<typename T1>
+void casadi_ldl_trs_block(const casadi_int* sp_r, const T1* nz_r, T1* x, casadi_int nb,
+                          casadi_int tr) {
+  casadi_int ncol, c, k, j;
+  const casadi_int *colind, *row;
+  T1 a, *xc;
+  const T1 *xr;
+  // Extract sparsity
+  ncol=sp_r[1];
+  colind=sp_r+2; row=sp_r+2+ncol+1;
+  if (tr) {
+    // Forward substitution
+    for (c=0; c<ncol; ++c) {
+      xc = x+c*nb;
+      for (k=colind[c]; k<colind[c+1]; ++k) {
+        a = nz_r[k];
+        xr = x+row[k]*nb;
+        for (j=0; j<nb; ++j) xc[j] -= a*xr[j];
+      }
+    }
+  } else {
+    // Backward substitution
+    for (c=ncol-1; c>=0; --c) {
+      xr = x+c*nb;
+      for (k=colind[c+1]-1; k>=colind[c]; --k) {
+        a = nz_r[k];
+        xc = x+row[k]*nb;
+        for (j=0; j<nb; ++j) xc[j] -= a*xr[j];
+      }
+    }
+  }
+}
+
+// SYMBOL "ldl_solve_block"
+// Variant of casadi_ldl_solve, solving for up to nb right-hand sides at once,
+// such that the factors are traversed once per block rather than once per right-hand side
+// len[w] >= nb*n
+template<typename T1>
+void casadi_ldl_solve_block(T1* x, casadi_int nrhs, casadi_int nb, const casadi_int* sp_lt,
+                            const T1* lt, const T1* d, const casadi_int* p, T1* w) {
+  casadi_int i, j, nb1;
+  casadi_int n = sp_lt[1];
+  for (; nrhs>0; nrhs-=nb1) {
+    nb1 = nrhs<nb ? nrhs : nb;
+    // Multiply by P, interleaving the right-hand sides
+    for (i=0; i<n; ++i) {
+      for (j=0; j<nb1; ++j) w[i*nb1+j] = x[p[i]+j*n];
+    }
+    //  Solve for L
+    casadi_ldl_trs_block(sp_lt, lt, w, nb1, 1);
+    // Divide by D
+    for (i=0; i<n; ++i) {
+      for (j=0; j<nb1; ++j) w[i*nb1+j] /= d[i];
+    }
+    // Solve for L'
+    casadi_ldl_trs_block(sp_lt, lt, w, nb1, 0);
+    // Multiply by P'
+    for (i=0; i<n; ++i) {
+      for (j=0; j<nb1; ++j) x[p[i]+j*n] = w[i*nb1+j];
+    }
+    // Next block
+    x += nb1*n;
+  }
+}
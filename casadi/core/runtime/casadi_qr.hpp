@@ -40,33 +40,29 @@ T1 casadi_house(T1* v, T1* beta, casadi_int nv) {
   return s;
 }
 
-// SYMBOL "qr"
-// Numeric QR factorization
-// Ref: Chapter 5, Direct Methods for Sparse Linear Systems by Tim Davis
-// len[x] = nrow
-// sp_v = [nrow, ncol, 0, 0, ...] len[3 + ncol + nnz_v]
-// len[v] nnz_v
-// sp_r = [nrow, ncol, 0, 0, ...] len[3 + ncol + nnz_r]
-// len[r] nnz_r
-// len[beta] ncol
+// SYMBOL "qr_cols"
+// Calculate the columns c0, ..., c1-1 of V, R and beta for casadi_qr, with all
+// preceding columns in the same subtree of the column elimination tree calculated.
+// Since only entries of x corresponding to the subtree are accessed, disjoint subtrees
+// can be calculated concurrently.
+// len[x] = nrow, x is zero on entry and on exit
 template<typename T1>
-void casadi_qr(const casadi_int* sp_a, const T1* nz_a, T1* x,
-               const casadi_int* sp_v, T1* nz_v, const casadi_int* sp_r, T1* nz_r, T1* beta,
-               const casadi_int* prinv, const casadi_int* pc) {
+void casadi_qr_cols(const casadi_int* sp_a, const T1* nz_a, T1* x,
+                    const casadi_int* sp_v, T1* nz_v, const casadi_int* sp_r, T1* nz_r, T1* beta,
+                    const casadi_int* prinv, const casadi_int* pc, casadi_int c0, casadi_int c1) {
    // Local variables
-   casadi_int ncol, nrow, r, c, k, k1;
+   casadi_int ncol, r, c, k, k1;
    T1 alpha;
    const casadi_int *a_colind, *a_row, *v_colind, *v_row, *r_colind, *r_row;
    // Extract sparsities
    ncol = sp_a[1];
    a_colind=sp_a+2; a_row=sp_a+2+ncol+1;
-   nrow = sp_v[0];
    v_colind=sp_v+2; v_row=sp_v+2+ncol+1;
    r_colind=sp_r+2; r_row=sp_r+2+ncol+1;
-   // Clear work vector
-   for (r=0; r<nrow; ++r) x[r] = 0;
+   // First entry of R to be calculated
+   nz_r += r_colind[c0];
    // Loop over columns of R, A and V
-   for (c=0; c<ncol; ++c) {
+   for (c=c0; c<c1; ++c) {
      // Copy (permuted) column of A to x
      for (k=a_colind[pc[c]]; k<a_colind[pc[c]+1]; ++k) x[prinv[a_row[k]]] = nz_a[k];
      // Use the equality R = (I-betan*vn*vn')*...*(I-beta1*v1*v1')*A to get
@@ -94,6 +90,28 @@ void casadi_qr(const casadi_int* sp_a, const T1* nz_a, T1* x,
    }
  }
 
+// SYMBOL "qr"
+// Numeric QR factorization
+// Ref: Chapter 5, Direct Methods for Sparse Linear Systems by Tim Davis
+// len[x] = nrow
+// sp_v = [nrow, ncol, 0, 0, ...] len[3 + ncol + nnz_v]
+// len[v] nnz_v
+// sp_r = [nrow, ncol, 0, 0, ...] len[3 + ncol + nnz_r]
+// len[r] nnz_r
+// len[beta] ncol
+template<typename T1>
+void casadi_qr(const casadi_int* sp_a, const T1* nz_a, T1* x,
+               const casadi_int* sp_v, T1* nz_v, const casadi_int* sp_r, T1* nz_r, T1* beta,
+               const casadi_int* prinv, const casadi_int* pc) {
+   // Local variables
+   casadi_int nrow, r;
+   // Clear work vector
+   nrow = sp_v[0];
+   for (r=0; r<nrow; ++r) x[r] = 0;
+   // Calculate all columns
+   casadi_qr_cols(sp_a, nz_a, x, sp_v, nz_v, sp_r, nz_r, beta, prinv, pc, 0, sp_a[1]);
+ }
+
 // SYMBOL "qr_mv"
 // Multiply QR Q matrix from the right with a vector, with Q represented
 // by the Householder vectors V and beta
@@ -196,6 +214,134 @@ void casadi_qr_solve(T1* x, casadi_int nrhs, casadi_int tr,
   }
 }
 
+// SYMBOL "qr_mv_block"
+// Variant of casadi_qr_mv for nb vectors at once, stored row by row,
+// i.e. x[i*nb+j] holds element i of vector j
+// len[x] >= nb*nrow_ext, len[alpha] >= nb
+template<typename T1>
+void casadi_qr_mv_block(const casadi_int* sp_v, const T1* v, const T1* beta, T1* x,
+                        casadi_int nb, casadi_int tr, T1* alpha) {
+  // Local variables
+  casadi_int ncol, c, c1, k, j;
+  T1 vk, *xr;
+  const casadi_int *colind, *row;
+  // Extract sparsity
+  ncol=sp_v[1];
+  colind=sp_v+2; row=sp_v+2+ncol+1;
+  // Loop over vectors
+  for (c1=0; c1<ncol; ++c1) {
+    // Forward order for transpose, otherwise backwards
+    c = tr ? c1 : ncol-1-c1;
+    // Calculate scalar factors alpha = beta(c)*v(:,c)'*x
+    for (j=0; j<nb; ++j) alpha[j] = 0;
+    for (k=colind[c]; k<colind[c+1]; ++k) {
+      vk = v[k];
+      xr = x+row[k]*nb;
+      for (j=0; j<nb; ++j) alpha[j] += vk*xr[j];
+    }
+    for (j=0; j<nb; ++j) alpha[j] *= beta[c];
+    // x -= v(:,c)*alpha
+    for (k=colind[c]; k<colind[c+1]; ++k) {
+      vk = v[k];
+      xr = x+row[k]*nb;
+      for (j=0; j<nb; ++j) xr[j] -= alpha[j]*vk;
+    }
+  }
+}
+
+// SYMBOL "qr_trs_block"
+// Variant of casadi_qr_trs for nb right-hand sides at once, stored as in casadi_qr_mv_block
+template<typename T1>
+void casadi_qr_trs_block(const casadi_int* sp_r, const T1* nz_r, T1* x, casadi_int nb,
+                         casadi_int tr) {
+  // Local variables
+  casadi_int ncol, r, c, k, j;
+  T1 a, *xc, *xr;
+  const casadi_int *colind, *row;
+  // Extract sparsity
+  ncol=sp_r[1];
+  colind=sp_r+2; row=sp_r+2+ncol+1;
+  if (tr) {
+    // Forward substitution
+    for (c=0; c<ncol; ++c) {
+      xc = x+c*nb;
+      for (k=colind[c]; k<colind[c+1]; ++k) {
+        r = row[k];
+        a = nz_r[k];
+        if (r==c) {
+          for (j=0; j<nb; ++j) xc[j] /= a;
+        } else {
+          xr = x+r*nb;
+          for (j=0; j<nb; ++j) xc[j] -= a*xr[j];
+        }
+      }
+    }
+  } else {
+    // Backward substitution
+    for (c=ncol-1; c>=0; --c) {
+      xc = x+c*nb;
+      for (k=colind[c+1]-1; k>=colind[c]; --k) {
+        r = row[k];
+        a = nz_r[k];
+        if (r==c) {
+          for (j=0; j<nb; ++j) xc[j] /= a;
+        } else {
+          xr = x+r*nb;
+          for (j=0; j<nb; ++j) xr[j] -= a*xc[j];
+        }
+      }
+    }
+  }
+}
+
+// SYMBOL "qr_solve_block"
+// Variant of casadi_qr_solve, solving for up to nb right-hand sides at once,
+// such that the factors are traversed once per block rather than once per right-hand side
+// len[w] >= nb*(nrow_ext+1)
+template<typename T1>
+void casadi_qr_solve_block(T1* x, casadi_int nrhs, casadi_int nb, casadi_int tr,
+                           const casadi_int* sp_v, const T1* v, const casadi_int* sp_r,
+                           const T1* r, const T1* beta, const casadi_int* prinv,
+                           const casadi_int* pc, T1* w) {
+  casadi_int c, j, nb1, nrow_ext, ncol;
+  T1 *alpha;
+  nrow_ext = sp_v[0]; ncol = sp_v[1];
+  alpha = w + nb*nrow_ext;
+  for (; nrhs>0; nrhs-=nb1) {
+    nb1 = nrhs<nb ? nrhs : nb;
+    for (c=0; c<nb1*nrow_ext; ++c) w[c] = 0;
+    if (tr) {
+      // Multiply by PC, interleaving the right-hand sides
+      for (c=0; c<ncol; ++c) {
+        for (j=0; j<nb1; ++j) w[c*nb1+j] = x[pc[c]+j*ncol];
+      }
+      //  Solve for R'
+      casadi_qr_trs_block(sp_r, r, w, nb1, 1);
+      // Multiply by Q
+      casadi_qr_mv_block(sp_v, v, beta, w, nb1, 0, alpha);
+      // Multiply by PR'
+      for (c=0; c<ncol; ++c) {
+        for (j=0; j<nb1; ++j) x[c+j*ncol] = w[prinv[c]*nb1+j];
+      }
+    } else {
+      // Multiply with PR, interleaving the right-hand sides
+      for (c=0; c<ncol; ++c) {
+        for (j=0; j<nb1; ++j) w[prinv[c]*nb1+j] = x[c+j*ncol];
+      }
+      // Multiply with Q'
+      casadi_qr_mv_block(sp_v, v, beta, w, nb1, 1, alpha);
+      //  Solve for R
+      casadi_qr_trs_block(sp_r, r, w, nb1, 0);
+      // Multiply with PC'
+      for (c=0; c<ncol; ++c) {
+        for (j=0; j<nb1; ++j) x[pc[c]+j*ncol] = w[c*nb1+j];
+      }
+    }
+    // Next block
+    x += nb1*ncol;
+  }
+}
+
 // SYMBOL "qr_singular"
 // Check if QR factorization corresponds to a singular matrix
 template<typename T1>
@@ -105,6 +105,10 @@ struct casadi_qrqp_data {
   casadi_int r_index, r_sign;
   // Iteration
   casadi_int iter;
+  // Factorization of the KKT matrix at a previous solution, reused if unchanged (optional)
+  const T1 *prev_kkt, *prev_vr, *prev_beta;
+  // Number of QR factorizations calculated and reused
+  casadi_int n_fact, n_reuse;
 };
 // C-REPLACE "casadi_qrqp_data<T1>" "struct casadi_qrqp_data"
 
@@ -177,6 +181,8 @@ void casadi_qrqp_init(casadi_qrqp_data<T1>* d, casadi_int** iw, T1** w) {
   d->iw = *iw;
 
   d->nz_r = d->nz_v + nnz_v;
+  // No factorization to reuse by default
+  d->prev_kkt = d->prev_vr = d->prev_beta = 0;
 }
 
 // SYMBOL "qrqp_reset"
@@ -218,6 +224,8 @@ int casadi_qrqp_reset(casadi_qrqp_data<T1>* d) {
   d->r_sign = 0;
   // Reset iteration counter
   d->iter = 0;
+  // Reset factorization counters
+  d->n_fact = d->n_reuse = 0;
   return 0;
 }
 
@@ -697,6 +705,8 @@ int casadi_qrqp_flip_check(casadi_qrqp_data<T1>* d) {
 // SYMBOL "qrqp_factorize"
 template<typename T1>
 void casadi_qrqp_factorize(casadi_qrqp_data<T1>* d) {
+  // Local variables
+  casadi_int k, nnz_kkt;
   const casadi_qrqp_prob<T1>* p = d->prob;
   // Do we already have a search direction due to lost singularity?
   if (d->has_search_dir) {
@@ -705,9 +715,23 @@ void casadi_qrqp_factorize(casadi_qrqp_data<T1>* d) {
   }
   // Construct the KKT matrix
   casadi_qrqp_kkt(d);
-  // QR factorization
-  casadi_qr(p->sp_kkt, d->nz_kkt, d->w, p->sp_v, d->nz_v, p->sp_r,
-            d->nz_r, d->beta, p->prinv, p->pc);
+  // Is it the KKT matrix of a previous solution?
+  nnz_kkt = p->sp_kkt[2+p->qp->nz];
+  k = nnz_kkt;
+  if (d->prev_kkt) {
+    for (k=0; k<nnz_kkt; ++k) if (d->nz_kkt[k]!=d->prev_kkt[k]) break;
+  }
+  if (k==nnz_kkt && d->prev_kkt) {
+    // Reuse its QR factorization
+    casadi_copy(d->prev_vr, p->sp_v[2+p->qp->nz] + p->sp_r[2+p->qp->nz], d->nz_v);
+    casadi_copy(d->prev_beta, p->qp->nz, d->beta);
+    d->n_reuse++;
+  } else {
+    // QR factorization
+    casadi_qr(p->sp_kkt, d->nz_kkt, d->w, p->sp_v, d->nz_v, p->sp_r,
+              d->nz_r, d->beta, p->prinv, p->pc);
+    d->n_fact++;
+  }
   // Check singularity
   d->sing = casadi_qr_singular(&d->mina, &d->imina, d->nz_r, p->sp_r, p->pc, 1e-12);
 }
@@ -287,6 +287,7 @@ namespace casadi {
   #include "casadi_finite_diff.hpp"
   #include "casadi_file_slurp.hpp"
   #include "casadi_ldl.hpp"
+  #include "casadi_band.hpp"
   #include "casadi_qr.hpp"
   #include "casadi_qp.hpp"
   #include "casadi_qrqp.hpp"
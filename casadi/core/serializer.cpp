@@ -32,8 +32,70 @@
 #include "generic_type.hpp"
 #include <iomanip>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif // _WIN32
+
 namespace casadi {
 
+#ifndef _WIN32
+    /** \brief Read-only stream buffer over a memory-mapped file
+     *
+     * Reads are served directly from the page cache, avoiding the buffering
+     * of std::ifstream and a second copy of the file contents in memory
+     */
+    class MappedFileBuffer : public std::streambuf {
+    public:
+      explicit MappedFileBuffer(const std::string& fname) : data_(nullptr), size_(0) {
+        int fd = open(fname.c_str(), O_RDONLY);
+        if (fd<0) return;
+        struct stat st;
+        if (fstat(fd, &st)==0 && st.st_size>0) {
+          void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+          if (p!=MAP_FAILED) {
+            // Objects are decoded front to back
+            madvise(p, st.st_size, MADV_SEQUENTIAL);
+            data_ = static_cast<char*>(p);
+            size_ = st.st_size;
+            setg(data_, data_, data_ + size_);
+          }
+        }
+        // The mapping remains valid after closing the file descriptor
+        close(fd);
+      }
+      ~MappedFileBuffer() override {
+        if (data_) munmap(data_, size_);
+      }
+      bool is_open() const { return data_!=nullptr;}
+    private:
+      char* data_;
+      size_t size_;
+    };
+
+    /** \brief Input stream owning a MappedFileBuffer */
+    class MappedFileStream : private MappedFileBuffer, public std::istream {
+    public:
+      explicit MappedFileStream(const std::string& fname) :
+        MappedFileBuffer(fname), std::istream(static_cast<MappedFileBuffer*>(this)) {
+      }
+      using MappedFileBuffer::is_open;
+    };
+#endif // _WIN32
+
+    static std::unique_ptr<std::istream> open_input_file(const std::string& fname) {
+#ifndef _WIN32
+      // Memory map the file if possible
+      std::unique_ptr<MappedFileStream> mapped(new MappedFileStream(fname));
+      if (mapped->is_open()) return std::move(mapped);
+#endif // _WIN32
+      // Fall back to a regular file stream, e.g. for empty files or pipes
+      return std::unique_ptr<std::istream>(
+        new std::ifstream(fname, std::ios_base::binary | std::ios::in));
+    }
+
     StringSerializer::StringSerializer(const Dict& opts) :
         SerializerBase(std::unique_ptr<std::ostream>(new std::stringstream()), opts) {
     }
@@ -104,8 +166,7 @@ namespace casadi {
     }
 
     FileDeserializer::FileDeserializer(const std::string& fname) :
-        DeserializerBase(std::unique_ptr<std::istream>(
-          new std::ifstream(fname, std::ios_base::binary | std::ios::in))) {
+        DeserializerBase(open_input_file(fname)) {
       if ((dstream_->rdstate() & std::ifstream::failbit) != 0) {
         casadi_error("Could not open file '" + fname + "' for reading.");
       }
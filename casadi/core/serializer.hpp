@@ -214,6 +214,9 @@ namespace casadi {
   class CASADI_EXPORT FileSerializer : public SerializerBase {
   public:
     /** \brief Advanced serialization of CasADi objects
+     * 
+     * Pass the option binary=true to write raw bytes, which halves the file size
+     * and allows bulk arrays to be read without decoding.
      * 
      * \see StringSerializer, FileDeserializer
 
@@ -244,6 +247,8 @@ namespace casadi {
   public:
      /** \brief Advanced deserialization of CasADi objects
      * 
+     * Where supported, the file is memory-mapped rather than buffered.
+     * 
      * \see FileSerializer
 
          \identifier{7t} */
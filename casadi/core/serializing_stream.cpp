@@ -41,9 +41,14 @@
 namespace casadi {
 
     static casadi_int serialization_protocol_version = 3;
+    static casadi_int serialization_protocol_version_binary = 4;
     static casadi_int serialization_check = 123456789012345;
 
-    DeserializingStream::DeserializingStream(std::istream& in_s) : in(in_s), debug_(false) {
+    // Alignment of bulk arrays in binary streams
+    static const size_t serialization_alignment = 8;
+
+    DeserializingStream::DeserializingStream(std::istream& in_s) : in(in_s), debug_(false),
+        binary_(false) {
 
       casadi_assert(in_s.good(), "Invalid input stream. If you specified an input file, "
         "make sure it exists relative to the current directory.");
@@ -58,10 +63,15 @@ namespace casadi {
       // API version check
       casadi_int v;
       unpack(v);
-      casadi_assert(v==serialization_protocol_version,
+      casadi_assert(v==serialization_protocol_version ||
+        v==serialization_protocol_version_binary,
         "Serialization protocol is not compatible. "
         "Got version " + str(v) + ", while " +
-        str(serialization_protocol_version) + " was expected.");
+        str(serialization_protocol_version) + " or " +
+        str(serialization_protocol_version_binary) + " was expected.");
+
+      // Everything after the header is binary encoded in the latest version
+      binary_ = v==serialization_protocol_version_binary;
 
       bool debug;
       unpack(debug);
@@ -74,27 +84,99 @@ namespace casadi {
     }
 
     SerializingStream::SerializingStream(std::ostream& out_s, const Dict& opts) :
-        out(out_s), debug_(false) {
-      // Sanity check
-      pack(serialization_check);
-      // API version check
-      pack(casadi_int(serialization_protocol_version));
-
+        out(out_s), debug_(false), binary_(false), offset_(0) {
       bool debug = false;
+      bool binary = false;
 
       // Read options
       for (auto&& op : opts) {
         if (op.first=="debug") {
           debug = op.second;
+        } else if (op.first=="binary") {
+          binary = op.second;
         } else {
           casadi_error("Unknown option: '" + op.first + "'.");
         }
       }
 
+      // Sanity check
+      pack(serialization_check);
+      // API version check
+      pack(binary ? serialization_protocol_version_binary : serialization_protocol_version);
+
+      binary_ = binary;
       pack(debug);
       debug_ = debug;
     }
 
+    void SerializingStream::write(const char* c, size_t n) {
+      if (binary_) {
+        out.write(c, n);
+        offset_ += n;
+        return;
+      }
+      // Note: outputstreams work neatly with std::hex,
+      // but inputstreams don't
+      const unsigned char ref = 'a';
+      char buffer[1024];
+      while (n>0) {
+        size_t m = std::min(n, sizeof(buffer)/2);
+        for (size_t j=0;j<m;++j) {
+          unsigned char b = static_cast<unsigned char>(c[j]);
+          buffer[2*j] = ref + (b % 16);
+          buffer[2*j+1] = ref + (b >> 4);
+        }
+        out.write(buffer, 2*m);
+        offset_ += 2*m;
+        c += m;
+        n -= m;
+      }
+    }
+
+    void DeserializingStream::read(char* c, size_t n) {
+      if (binary_) {
+        in.read(c, n);
+        casadi_assert(static_cast<size_t>(in.gcount())==n,
+          "DeserializingStream error: unexpected end of stream.");
+        return;
+      }
+      const unsigned char ref = 'a';
+      char buffer[1024];
+      while (n>0) {
+        size_t m = std::min(n, sizeof(buffer)/2);
+        in.read(buffer, 2*m);
+        casadi_assert(static_cast<size_t>(in.gcount())==2*m,
+          "DeserializingStream error: unexpected end of stream.");
+        for (size_t j=0;j<m;++j) {
+          c[j] = static_cast<char>(
+            (static_cast<unsigned char>(buffer[2*j])-ref) +
+            ((static_cast<unsigned char>(buffer[2*j+1])-ref) << 4));
+        }
+        c += m;
+        n -= m;
+      }
+    }
+
+    void SerializingStream::pad() {
+      if (!binary_) return;
+      // Number of padding bytes, written in front of the padding itself
+      char p = static_cast<char>((serialization_alignment -
+        (offset_+1) % serialization_alignment) % serialization_alignment);
+      char zeros[serialization_alignment] = {0};
+      write(&p, 1);
+      write(zeros, p);
+    }
+
+    void DeserializingStream::skip_padding() {
+      if (!binary_) return;
+      char p;
+      read(&p, 1);
+      casadi_assert(p>=0 && p<static_cast<char>(serialization_alignment),
+        "DeserializingStream error: invalid padding.");
+      char zeros[serialization_alignment];
+      read(zeros, p);
+    }
+
     void SerializingStream::decorate(char e) {
       if (debug_) pack(e);
     }
@@ -112,7 +194,7 @@ namespace casadi {
       int64_t n;
       char* c = reinterpret_cast<char*>(&n);
 
-      for (int j=0;j<8;++j) unpack(c[j]);
+      read(c, 8);
       e = n;
     }
 
@@ -120,14 +202,14 @@ namespace casadi {
       decorate('J');
       int64_t n = e;
       const char* c = reinterpret_cast<const char*>(&n);
-      for (int j=0;j<8;++j) pack(c[j]);
+      write(c, 8);
     }
 
     void SerializingStream::pack(size_t e) {
       decorate('K');
       uint64_t n = e;
       const char* c = reinterpret_cast<const char*>(&n);
-      for (int j=0;j<8;++j) pack(c[j]);
+      write(c, 8);
     }
 
     void DeserializingStream::unpack(size_t& e) {
@@ -135,7 +217,7 @@ namespace casadi {
       uint64_t n;
       char* c = reinterpret_cast<char*>(&n);
 
-      for (int j=0;j<8;++j) unpack(c[j]);
+      read(c, 8);
       e = n;
     }
 
@@ -144,7 +226,7 @@ namespace casadi {
       int32_t n;
       char* c = reinterpret_cast<char*>(&n);
 
-      for (int j=0;j<4;++j) unpack(c[j]);
+      read(c, 4);
       e = n;
     }
 
@@ -152,7 +234,7 @@ namespace casadi {
       decorate('i');
       int32_t n = e;
       const char* c = reinterpret_cast<const char*>(&n);
-      for (int j=0;j<4;++j) pack(c[j]);
+      write(c, 4);
     }
 
 #if SIZE_MAX != UINT_MAX
@@ -161,7 +243,7 @@ namespace casadi {
       uint32_t n;
       char* c = reinterpret_cast<char*>(&n);
 
-      for (int j=0;j<4;++j) unpack(c[j]);
+      read(c, 4);
       e = n;
     }
 
@@ -169,7 +251,7 @@ namespace casadi {
       decorate('u');
       uint32_t n = e;
       const char* c = reinterpret_cast<const char*>(&n);
-      for (int j=0;j<4;++j) pack(c[j]);
+      write(c, 4);
     }
 #endif
 
@@ -186,28 +268,18 @@ namespace casadi {
     }
 
     void DeserializingStream::unpack(char& e) {
-      unsigned char ref = 'a';
-      in.get(e);
-      char t;
-      in.get(t);
-      e = (reinterpret_cast<unsigned char&>(e)-ref) +
-          ((reinterpret_cast<unsigned char&>(t)-ref) << 4);
+      read(&e, 1);
     }
 
     void SerializingStream::pack(char e) {
-      unsigned char ref = 'a';
-      // Note: outputstreams work neatly with std::hex,
-      // but inputstreams don't
-      out.put(ref + (reinterpret_cast<unsigned char&>(e) % 16));
-      out.put(ref + (reinterpret_cast<unsigned char&>(e) >> 4));
+      write(&e, 1);
     }
 
     void SerializingStream::pack(const std::string& e) {
       decorate('s');
       int s = static_cast<int>(e.size());
       pack(s);
-      const char* c = e.c_str();
-      for (int j = 0; j < s; ++j) pack(c[j]);
+      write(e.c_str(), s);
     }
 
     void DeserializingStream::unpack(std::string& e) {
@@ -215,19 +287,18 @@ namespace casadi {
       int s;
       unpack(s);
       e.resize(s);
-      for (int j=0;j<s;++j) unpack(e[j]);
+      if (s>0) read(&e[0], s);
     }
 
     void DeserializingStream::unpack(double& e) {
       assert_decoration('d');
-      char* c = reinterpret_cast<char*>(&e);
-      for (int j=0;j<8;++j) unpack(c[j]);
+      read(reinterpret_cast<char*>(&e), 8);
     }
 
     void SerializingStream::pack(double e) {
       decorate('d');
       const char* c = reinterpret_cast<const char*>(&e);
-      for (int j=0;j<8;++j) pack(c[j]);
+      write(c, 8);
     }
 
     void SerializingStream::pack(const Sparsity& e) {
@@ -309,10 +380,7 @@ namespace casadi {
       char buffer[1024];
       for (size_t i=0;i<len;++i) {
         s.read(buffer, 1024);
-        size_t c = s.gcount();
-        for (size_t j=0;j<c;++j) {
-          pack(buffer[j]);
-        }
+        write(buffer, s.gcount());
         if (s.rdstate() & std::ifstream::eofbit) break;
       }
     }
@@ -321,10 +389,12 @@ namespace casadi {
       assert_decoration('B');
       size_t len;
       unpack(len);
-      for (size_t i=0;i<len;++i) {
-        char c;
-        unpack(c);
-        s.put(c);
+      char buffer[1024];
+      while (len>0) {
+        size_t c = std::min(len, sizeof(buffer));
+        read(buffer, c);
+        s.write(buffer, c);
+        len -= c;
       }
     }
 
@@ -361,6 +431,59 @@ namespace casadi {
     }
   }
 
+  template<>
+  void DeserializingStream::unpack(std::vector<casadi_int>& e) {
+    assert_decoration('V');
+    casadi_int s;
+    unpack(s);
+    e.resize(s);
+    if (debug_ || sizeof(casadi_int)!=sizeof(int64_t)) {
+      for (casadi_int& i : e) unpack(i);
+      return;
+    }
+    // Bulk read, little-endian int64_t just like the scalar case
+    skip_padding();
+    if (s>0) read(reinterpret_cast<char*>(e.data()), s*sizeof(int64_t));
+  }
+
+  template<>
+  void SerializingStream::pack(const std::vector<casadi_int>& e) {
+    decorate('V');
+    pack(static_cast<casadi_int>(e.size()));
+    if (debug_ || sizeof(casadi_int)!=sizeof(int64_t)) {
+      for (casadi_int i : e) pack(i);
+      return;
+    }
+    pad();
+    if (!e.empty()) write(reinterpret_cast<const char*>(e.data()), e.size()*sizeof(int64_t));
+  }
+
+  template<>
+  void DeserializingStream::unpack(std::vector<double>& e) {
+    assert_decoration('V');
+    casadi_int s;
+    unpack(s);
+    e.resize(s);
+    if (debug_) {
+      for (double& i : e) unpack(i);
+      return;
+    }
+    skip_padding();
+    if (s>0) read(reinterpret_cast<char*>(e.data()), s*sizeof(double));
+  }
+
+  template<>
+  void SerializingStream::pack(const std::vector<double>& e) {
+    decorate('V');
+    pack(static_cast<casadi_int>(e.size()));
+    if (debug_) {
+      for (double i : e) pack(i);
+      return;
+    }
+    pad();
+    if (!e.empty()) write(reinterpret_cast<const char*>(e.data()), e.size()*sizeof(double));
+  }
+
   int DeserializingStream::version(const std::string& name) {
     int load_version;
     unpack(name+"::serialization::version", load_version);
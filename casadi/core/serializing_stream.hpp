@@ -194,6 +194,20 @@ namespace casadi {
         \identifier{an} */
     void assert_decoration(char e);
 
+    /** \brief Read a block of raw bytes from the input stream
+     *
+     * Decodes the hexadecimal text encoding unless the stream is binary
+
+        \identifier{28i} */
+    void read(char* c, size_t n);
+
+    /** \brief Skip the padding in front of a bulk array
+     *
+     * No-op unless the stream is binary
+
+        \identifier{28j} */
+    void skip_padding();
+
     /// Collection of all shared pointer deserialized so far
     std::vector<UniversalNodeOwner> nodes_;
     std::unordered_map<void*, casadi_int>* shared_map_ = nullptr;
@@ -201,6 +215,8 @@ namespace casadi {
     std::istream& in;
     /// Debug mode?
     bool debug_;
+    /// Binary (as opposed to text) encoding?
+    bool binary_;
   };
 
   /** \brief Helper class for Serialization
@@ -291,6 +307,20 @@ namespace casadi {
         \identifier{aq} */
     void decorate(char e);
 
+    /** \brief Write a block of raw bytes to the output stream
+     *
+     * Uses a hexadecimal text encoding unless the stream is binary
+
+        \identifier{28k} */
+    void write(const char* c, size_t n);
+
+    /** \brief Pad such that a bulk array that follows is 8-byte aligned
+     *
+     * No-op unless the stream is binary
+
+        \identifier{28l} */
+    void pad();
+
     /** \brief Packs a shared object
     *
     * Also treats SXNode, which is not actually a SharedObjectInternal
@@ -319,10 +349,22 @@ namespace casadi {
     std::ostream& out;
     /// Debug mode?
     bool debug_;
+    /// Binary (as opposed to text) encoding?
+    bool binary_;
+    /// Number of characters written so far
+    size_t offset_;
   };
 
   template <>
   CASADI_EXPORT void DeserializingStream::unpack(std::vector<bool>& e);
+  template <>
+  CASADI_EXPORT void DeserializingStream::unpack(std::vector<casadi_int>& e);
+  template <>
+  CASADI_EXPORT void DeserializingStream::unpack(std::vector<double>& e);
+  template <>
+  CASADI_EXPORT void SerializingStream::pack(const std::vector<casadi_int>& e);
+  template <>
+  CASADI_EXPORT void SerializingStream::pack(const std::vector<double>& e);
 
 } // namespace casadi
 
@@ -135,14 +135,23 @@ namespace casadi {
   }
 
   bool WeakRef::alive() const {
-    return !is_null() && (*this)->raw_ != nullptr;
+    if (is_null()) return false;
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(SharedObjectInternal::weak_ref_mutex());
+#endif // CASADI_WITH_THREAD
+    const SharedObjectInternal* raw = (*this)->raw_;
+    return raw != nullptr && raw->count > 0;
   }
 
   SharedObject WeakRef::shared() {
     SharedObject ret;
-    if (alive()) {
-      ret.own((*this)->raw_);
-    }
+    if (is_null()) return ret;
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(SharedObjectInternal::weak_ref_mutex());
+#endif // CASADI_WITH_THREAD
+    // An object whose count has dropped to zero is being destroyed in another thread
+    SharedObjectInternal* raw = (*this)->raw_;
+    if (raw != nullptr && raw->count_up_alive()) ret.assign(raw);
     return ret;
   }
 
@@ -50,7 +50,12 @@ namespace casadi {
     }
     #endif // WITH_REFCOUNT_WARNINGS
     if (weak_ref_!=nullptr) {
-      weak_ref_->kill();
+      {
+#ifdef CASADI_WITH_THREAD
+        std::lock_guard<std::mutex> lock(weak_ref_mutex());
+#endif // CASADI_WITH_THREAD
+        weak_ref_->kill();
+      }
       delete weak_ref_;
     }
   }
@@ -60,12 +65,36 @@ namespace casadi {
   }
 
   WeakRef* SharedObjectInternal::weak() {
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(weak_ref_mutex());
+#endif // CASADI_WITH_THREAD
     if (weak_ref_==nullptr) {
       weak_ref_ = new WeakRef(this);
     }
     return weak_ref_;
   }
 
+  bool SharedObjectInternal::count_up_alive() {
+#ifdef CASADI_WITH_THREAD
+    casadi_int c = count.load();
+    while (c>0) {
+      if (count.compare_exchange_weak(c, c+1)) return true;
+    }
+    return false;
+#else // CASADI_WITH_THREAD
+    if (count==0) return false;
+    count++;
+    return true;
+#endif // CASADI_WITH_THREAD
+  }
+
+#ifdef CASADI_WITH_THREAD
+  std::mutex& SharedObjectInternal::weak_ref_mutex() {
+    static std::mutex m;
+    return m;
+  }
+#endif // CASADI_WITH_THREAD
+
   WeakRefInternal::WeakRefInternal(SharedObjectInternal* raw) : raw_(raw) {
   }
 
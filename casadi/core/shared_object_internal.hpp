@@ -30,6 +30,11 @@
 
 #ifdef CASADI_WITH_THREAD
 #include <atomic>
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.mutex.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <mutex>
+#endif // CASADI_WITH_THREAD_MINGW
 #endif // CASADI_WITH_THREAD
 
 namespace casadi {
@@ -38,6 +43,7 @@ namespace casadi {
   /// Internal class for the reference counting framework, see comments on the public class.
   class CASADI_EXPORT SharedObjectInternal {
     friend class SharedObject;
+    friend class WeakRef;
     friend class Memory;
     friend class UniversalNodeOwner;
   public:
@@ -89,6 +95,18 @@ namespace casadi {
     const B shared_from_this() const;
 
   private:
+    /** \brief Increase the reference count, unless the object is being destroyed
+
+        Fails if the count has already dropped to zero.
+
+        \identifier{293} */
+    bool count_up_alive();
+
+#ifdef CASADI_WITH_THREAD
+    /// Protects the link between objects and their weak references
+    static std::mutex& weak_ref_mutex();
+#endif // CASADI_WITH_THREAD
+
     /// Number of references pointing to the object
 #ifdef CASADI_WITH_THREAD
     std::atomic<casadi_int> count;
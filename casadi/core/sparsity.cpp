@@ -525,6 +525,14 @@ namespace casadi {
     return ret;
   }
 
+#ifdef CASADI_WITH_THREAD
+  // Protects the cache of sparsity patterns
+  static std::mutex& cache_mutex() {
+    static std::mutex m;
+    return m;
+  }
+#endif // CASADI_WITH_THREAD
+
   const Sparsity& Sparsity::getScalar() {
     static ScalarSparsity ret;
     return ret;
@@ -872,6 +880,10 @@ namespace casadi {
     // Hash the pattern
     std::size_t h = hash_sparsity(nrow, ncol, colind, row);
 
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(cache_mutex());
+#endif // CASADI_WITH_THREAD
+
     // Get a reference to the cache
     CachingMap& cache = getCache();
 
@@ -890,11 +902,11 @@ namespace casadi {
         // Get a weak reference to the cached sparsity pattern
         WeakRef& wref = i->second;
 
-        // Check if the pattern still exists
-        if (wref.alive()) {
+        // Get an owning reference to the cached pattern, if it still exists
+        Sparsity ref = shared_cast<Sparsity>(wref.shared());
 
-          // Get an owning reference to the cached pattern
-          Sparsity ref = shared_cast<Sparsity>(wref.shared());
+        // Check if the pattern still exists
+        if (!ref.is_null()) {
 
           // Check if the pattern matches
           if (ref.is_equal(nrow, ncol, colind, row)) {
@@ -913,16 +925,13 @@ namespace casadi {
           CachingMap::iterator j=i;
           j++; // Start at the next matching key
           for (; j!=eq.second; ++j) {
-            if (j->second.alive()) {
-
-              // Recover cached sparsity
-              Sparsity ref = shared_cast<Sparsity>(j->second.shared());
+            // Recover cached sparsity
+            Sparsity ref = shared_cast<Sparsity>(j->second.shared());
 
-              // Match found if sparsity matches
-              if (ref.is_equal(nrow, ncol, colind, row)) {
-                own(ref.get());
-                return;
-              }
+            // Match found if sparsity matches
+            if (!ref.is_null() && ref.is_equal(nrow, ncol, colind, row)) {
+              own(ref.get());
+              return;
             }
           }
 
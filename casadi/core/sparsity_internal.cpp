@@ -27,11 +27,15 @@
 #include "sparsity_internal.hpp"
 #include "casadi_misc.hpp"
 #include "global_options.hpp"
+#include "thread_pool.hpp"
 #include <climits>
 #include <cstdlib>
 #include <cmath>
 
 namespace casadi {
+  // Minimum number of nonzeros for graph coloring to use multiple threads
+  static const casadi_int coloring_parallel_min_nnz = 100000;
+
   void SparsityInternal::etree(const casadi_int* sp, casadi_int* parent,
       casadi_int *w, casadi_int ata) {
     /*
@@ -461,6 +465,11 @@ namespace casadi {
   }
 
   const SparsityInternal::Btf& SparsityInternal::btf() const {
+#ifdef CASADI_WITH_THREAD
+    // Patterns are shared between threads through the cache
+    static std::mutex btf_mutex;
+    std::lock_guard<std::mutex> lock(btf_mutex);
+#endif // CASADI_WITH_THREAD
     if (!btf_) {
       btf_ = new SparsityInternal::Btf();
       btf_->nb = btf(btf_->rowperm, btf_->colperm, btf_->rowblock, btf_->colblock,
@@ -2315,7 +2324,7 @@ namespace casadi {
 
   Sparsity SparsityInternal::combine(const Sparsity& y, bool f0x_is_zero,
                                             bool function0_is_zero) const {
-    static std::vector<unsigned char> mapping;
+    std::vector<unsigned char> mapping;
     return combineGen1<false>(y, f0x_is_zero, function0_is_zero, mapping);
   }
 
@@ -2957,48 +2966,87 @@ namespace casadi {
     const casadi_int* colind = this->colind();
     const casadi_int* row = this->row();
 
-    // Loop over columns
-    for (casadi_int i=0; i<size2(); ++i) {
+    // For large patterns, the previous columns sharing a row with a column are
+    // found in parallel, for a block of columns at a time. The colors are then
+    // assigned serially, in the same order, giving the same result.
+    casadi_int n_threads = ThreadPool::num_threads();
+    bool parallel = n_threads>1 && nnz()>=coloring_parallel_min_nnz;
+    casadi_int block_size = parallel ? 256*n_threads : size2();
+    std::vector<std::vector<casadi_int> > neighbors;
+
+    // Loop over blocks of columns
+    for (casadi_int i0=0; i0<size2(); i0+=block_size) {
+      casadi_int i1 = std::min(i0+block_size, size2());
+
+      // Previous columns that have an element in common with each col in the block
+      if (parallel) {
+        neighbors.resize(i1-i0);
+        ThreadPool::instance().run(i1-i0, [&](casadi_int k) {
+          casadi_int i = i0 + k;
+          std::vector<casadi_int>& nb = neighbors[k];
+          nb.clear();
+          for (casadi_int el=colind[i]; el<colind[i+1]; ++el) {
+            casadi_int c = row[el];
+            for (casadi_int el_prev=AT_colind[c]; el_prev<AT_colind[c+1]; ++el_prev) {
+              casadi_int i_prev = AT_row[el_prev];
+              if (i_prev>=i) break;
+              nb.push_back(i_prev);
+            }
+          }
+          std::sort(nb.begin(), nb.end());
+          nb.erase(std::unique(nb.begin(), nb.end()), nb.end());
+          return 0;
+        });
+      }
 
-      // Loop over nonzero elements
-      for (casadi_int el=colind[i]; el<colind[i+1]; ++el) {
+      // Loop over columns
+      for (casadi_int i=i0; i<i1; ++i) {
 
-        // Get row
-        casadi_int c = row[el];
+        if (parallel) {
+          // Mark the colors of the previous cols as forbidden for the current col
+          for (casadi_int i_prev : neighbors[i-i0]) forbiddenColors[color[i_prev]] = i;
+        } else {
+          // Loop over nonzero elements
+          for (casadi_int el=colind[i]; el<colind[i+1]; ++el) {
 
-        // Loop over previous columns that have an element in row c
-        for (casadi_int el_prev=AT_colind[c]; el_prev<AT_colind[c+1]; ++el_prev) {
+            // Get row
+            casadi_int c = row[el];
 
-          // Get the col
-          casadi_int i_prev = AT_row[el_prev];
+            // Loop over previous columns that have an element in row c
+            for (casadi_int el_prev=AT_colind[c]; el_prev<AT_colind[c+1]; ++el_prev) {
 
-          // Escape loop if we have arrived at the current col
-          if (i_prev>=i)
-            break;
+              // Get the col
+              casadi_int i_prev = AT_row[el_prev];
 
-          // Get the color of the col
-          casadi_int color_prev = color[i_prev];
+              // Escape loop if we have arrived at the current col
+              if (i_prev>=i)
+                break;
 
-          // Mark the color as forbidden for the current col
-          forbiddenColors[color_prev] = i;
+              // Get the color of the col
+              casadi_int color_prev = color[i_prev];
+
+              // Mark the color as forbidden for the current col
+              forbiddenColors[color_prev] = i;
+            }
+          }
         }
-      }
 
-      // Get the first nonforbidden color
-      casadi_int color_i;
-      for (color_i=0; color_i<forbiddenColors.size(); ++color_i) {
-        // Break if color is ok
-        if (forbiddenColors[color_i]!=i) break;
-      }
-      color[i] = color_i;
+        // Get the first nonforbidden color
+        casadi_int color_i;
+        for (color_i=0; color_i<forbiddenColors.size(); ++color_i) {
+          // Break if color is ok
+          if (forbiddenColors[color_i]!=i) break;
+        }
+        color[i] = color_i;
 
-      // Add color if reached end
-      if (color_i==forbiddenColors.size()) {
-        forbiddenColors.push_back(0);
+        // Add color if reached end
+        if (color_i==forbiddenColors.size()) {
+          forbiddenColors.push_back(0);
 
-        // Cutoff if too many colors
-        if (forbiddenColors.size()>cutoff) {
-          return Sparsity();
+          // Cutoff if too many colors
+          if (forbiddenColors.size()>cutoff) {
+            return Sparsity();
+          }
         }
       }
     }
@@ -42,6 +42,16 @@ namespace casadi {
   // Allocate storage for the caching
   CACHING_MAP<casadi_int, IntegerSX*> IntegerSX::cached_constants_;
   CACHING_MAP<double, RealtypeSX*> RealtypeSX::cached_constants_;
+#ifdef CASADI_WITH_THREAD
+  std::mutex ConstantSX::cache_mutex_;
+#endif // CASADI_WITH_THREAD
+
+  // Wrap a node holding a reference owned by the caller
+  static SXElem adopt(SXNode* n) {
+    SXElem ret = SXElem::create(n);
+    n->count--;
+    return ret;
+  }
 
   SXElem::SXElem() {
     node = casadi_limits<SXElem>::nan.node;
@@ -69,14 +79,24 @@ namespace casadi {
       else if (intval == 1)        node = casadi_limits<SXElem>::one.node;
       else if (intval == 2)        node = casadi_limits<SXElem>::two.node;
       else if (intval == -1)       node = casadi_limits<SXElem>::minus_one.node;
-      else                        node = IntegerSX::create(intval);
-      node->count++;
+      else                        node = nullptr;
+      // Cached constants come with a reference already
+      if (node) {
+        node->count++;
+      } else {
+        node = IntegerSX::create(intval);
+      }
     } else {
       if (isnan(val))              node = casadi_limits<SXElem>::nan.node;
       else if (isinf(val))         node = val > 0 ? casadi_limits<SXElem>::inf.node :
                                       casadi_limits<SXElem>::minus_inf.node;
-      else                        node = RealtypeSX::create(val);
-      node->count++;
+      else                        node = nullptr;
+      // Cached constants come with a reference already
+      if (node) {
+        node->count++;
+      } else {
+        node = RealtypeSX::create(val);
+      }
     }
   }
 
@@ -109,20 +129,17 @@ namespace casadi {
   }
 
   SXNode* SXElem::assignNoDelete(const SXElem& scalar) {
-    // Return value
-    SXNode* ret = node;
-
     // quick return if the old and new pointers point to the same object
-    if (node == scalar.node) return ret;
+    if (node == scalar.node) return nullptr;
 
     // decrease the counter but do not delete if this was the last pointer
-    --node->count;
+    SXNode* ret = --node->count == 0 ? node : nullptr;
 
     // save the new pointer
     node = scalar.node;
     node->count++;
 
-    // Return a pointer to the old node
+    // Return the old node if it is no longer referenced
     return ret;
   }
 
@@ -541,7 +558,7 @@ namespace casadi {
   // node corresponding to a constant 1
   const SXElem casadi_limits<SXElem>::one(OneSX::singleton(), false);
   // node corresponding to a constant 2
-  const SXElem casadi_limits<SXElem>::two(IntegerSX::create(2), false);
+  const SXElem casadi_limits<SXElem>::two = adopt(IntegerSX::create(2));
   // node corresponding to a constant -1
   const SXElem casadi_limits<SXElem>::minus_one(MinusOneSX::singleton(), false);
   const SXElem casadi_limits<SXElem>::nan(NanSX::singleton(), false);
@@ -621,7 +638,7 @@ namespace casadi {
   }
 
   SXElem SXElem::deserialize(DeserializingStream& s) {
-    return SXElem::create(SXNode::deserialize(s));
+    return adopt(SXNode::deserialize(s));
   }
 
 } // namespace casadi
@@ -227,16 +227,16 @@ namespace casadi {
     static bool is_equal(const SXElem& x, const SXElem& y, casadi_int depth=0);
 
     /// \cond INTERNAL
-    /// Get the temporary variable
+    /// Get the temporary variable, not thread-safe
     int get_temp() const;
 
-    /// Set the temporary variable
+    /// Set the temporary variable, not thread-safe
     void set_temp(int t) const;
 
-    /// Check if marked (i.e. temporary is negative)
+    /// Check if marked (i.e. temporary is negative), not thread-safe
     bool marked() const;
 
-    /// Mark by flipping the sign of the temporary and decreasing by one
+    /// Mark by flipping the sign of the temporary and decreasing by one, not thread-safe
     void mark() const;
 
     /** \brief Assign to another expression, if a duplicate.
@@ -248,7 +248,7 @@ namespace casadi {
 
     /** \brief Assign the node to something, without invoking the deletion of the node,
 
-     * if the count reaches 0
+     * if the count reaches 0. Returns the old node if its count reached 0, null otherwise.
 
         \identifier{111} */
     SXNode* assignNoDelete(const SXElem& scalar);
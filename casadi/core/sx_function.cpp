@@ -24,9 +24,12 @@
 
 
 #include "sx_function.hpp"
+#include <cmath>
 #include <limits>
 #include <stack>
 #include <deque>
+#include <map>
+#include <set>
 #include <sstream>
 #include <iomanip>
 #include "sx_node.hpp"
@@ -47,6 +50,8 @@ namespace casadi {
     // Default (persistent) options
     just_in_time_opencl_ = false;
     just_in_time_sparsity_ = false;
+    compact_tape_ = false;
+    specialized_ = false;
   }
 
   SXFunction::~SXFunction() {
@@ -65,6 +70,12 @@ namespace casadi {
                    + str(free_vars_) + " are free.");
     }
 
+    // Evaluate the compact tape, if available
+    if (!tape_.empty()) {
+      eval_tape(arg, res, w);
+      return 0;
+    }
+
     // NOTE: The implementation of this function is very delicate. Small changes in the
     // class structure can cause large performance losses. For this reason,
     // the preprocessor macros are used below
@@ -84,6 +95,250 @@ namespace casadi {
     return 0;
   }
 
+  // Instructions of the compact tape, followed by their operands
+#define CASADI_TAPE_OPS(X) \
+  X(STOP)          /* end of tape */ \
+  X(CONST)         /* i0, constant index */ \
+  X(INPUT)         /* i0, i1, i2 */ \
+  X(INPUT_RUN)     /* n, followed by n times i0, i1, i2 */ \
+  X(OUTPUT)        /* i0, i1, i2 */ \
+  X(OUTPUT_RUN)    /* n, followed by n times i0, i1, i2 */ \
+  X(ASSIGN)        /* i0, i1 */ \
+  X(NEG)           /* i0, i1 */ \
+  X(SQ)            /* i0, i1 */ \
+  X(ADD)           /* i0, i1, i2 */ \
+  X(SUB)           /* i0, i1, i2 */ \
+  X(MUL)           /* i0, i1, i2 */ \
+  X(DIV)           /* i0, i1, i2 */ \
+  X(MUL_ADD)       /* i0, i1, i2 of OP_MUL, followed by i0, i1, i2 of OP_ADD */ \
+  X(ADD_OUTPUT)    /* i0, i1, i2 of OP_ADD, followed by i0, i2 of OP_OUTPUT */ \
+  X(SUB_OUTPUT)    /* i0, i1, i2 of OP_SUB, followed by i0, i2 of OP_OUTPUT */ \
+  X(MUL_OUTPUT)    /* i0, i1, i2 of OP_MUL, followed by i0, i2 of OP_OUTPUT */ \
+  X(DIV_OUTPUT)    /* i0, i1, i2 of OP_DIV, followed by i0, i2 of OP_OUTPUT */ \
+  X(UNARY)         /* op, i0, i1 */ \
+  X(BINARY)        /* op, i0, i1, i2 */
+
+  enum TapeOp {
+#define CASADI_TAPE_ENUM(NAME) TAPE_##NAME,
+    CASADI_TAPE_OPS(CASADI_TAPE_ENUM)
+#undef CASADI_TAPE_ENUM
+  };
+
+  void SXFunction::init_tape() {
+    tape_.clear();
+    tape_const_.clear();
+    // Free variables cannot be evaluated numerically
+    if (!free_vars_.empty()) return;
+    casadi_int n = algorithm_.size();
+    for (casadi_int k=0; k<n; ++k) {
+      const AlgEl& e = algorithm_[k];
+      // Next instruction, if any
+      const AlgEl* e2 = k+1<n ? &algorithm_[k+1] : nullptr;
+      // Does the next instruction output the result of this one?
+      bool fuse_output = e2 && e2->op==OP_OUTPUT && e2->i1==e.i0;
+      switch (e.op) {
+      case OP_CONST:
+        tape_.push_back(TAPE_CONST);
+        tape_.push_back(e.i0);
+        tape_.push_back(tape_const_.size());
+        tape_const_.push_back(e.d);
+        break;
+      case OP_INPUT:
+      case OP_OUTPUT:
+        {
+          // Merge consecutive inputs or outputs
+          casadi_int m = 1;
+          while (k+m<n && algorithm_[k+m].op==e.op) m++;
+          if (m==1) {
+            tape_.push_back(e.op==OP_INPUT ? TAPE_INPUT : TAPE_OUTPUT);
+          } else {
+            tape_.push_back(e.op==OP_INPUT ? TAPE_INPUT_RUN : TAPE_OUTPUT_RUN);
+            tape_.push_back(m);
+          }
+          for (casadi_int j=k; j<k+m; ++j) {
+            tape_.push_back(algorithm_[j].i0);
+            tape_.push_back(algorithm_[j].i1);
+            tape_.push_back(algorithm_[j].i2);
+          }
+          k += m-1;
+        }
+        break;
+      case OP_ASSIGN:
+      case OP_NEG:
+      case OP_SQ:
+        tape_.push_back(e.op==OP_ASSIGN ? TAPE_ASSIGN : e.op==OP_NEG ? TAPE_NEG : TAPE_SQ);
+        tape_.push_back(e.i0);
+        tape_.push_back(e.i1);
+        break;
+      case OP_ADD:
+      case OP_SUB:
+      case OP_MUL:
+      case OP_DIV:
+        if (e.op==OP_MUL && e2 && e2->op==OP_ADD && (e2->i1==e.i0 || e2->i2==e.i0)) {
+          // Multiply-add
+          tape_.push_back(TAPE_MUL_ADD);
+          tape_.insert(tape_.end(), {e.i0, e.i1, e.i2, e2->i0, e2->i1, e2->i2});
+          k++;
+        } else if (fuse_output) {
+          // Operation followed by an output of the result
+          tape_.push_back(e.op==OP_ADD ? TAPE_ADD_OUTPUT : e.op==OP_SUB ? TAPE_SUB_OUTPUT
+                          : e.op==OP_MUL ? TAPE_MUL_OUTPUT : TAPE_DIV_OUTPUT);
+          tape_.insert(tape_.end(), {e.i0, e.i1, e.i2, e2->i0, e2->i2});
+          k++;
+        } else {
+          tape_.push_back(e.op==OP_ADD ? TAPE_ADD : e.op==OP_SUB ? TAPE_SUB
+                          : e.op==OP_MUL ? TAPE_MUL : TAPE_DIV);
+          tape_.insert(tape_.end(), {e.i0, e.i1, e.i2});
+        }
+        break;
+      default:
+        casadi_assert(e.op>=0 && e.op<NUM_BUILT_IN_OPS,
+                      "Compact tape: unknown operation " + str(e.op));
+        if (casadi_math<double>::ndeps(e.op)==2) {
+          tape_.insert(tape_.end(), {TAPE_BINARY, e.op, e.i0, e.i1, e.i2});
+        } else {
+          tape_.insert(tape_.end(), {TAPE_UNARY, e.op, e.i0, e.i1});
+        }
+      }
+    }
+    tape_.push_back(TAPE_STOP);
+  }
+
+  void SXFunction::eval_tape(const double** arg, double** res, double* w) const {
+    const int* p = get_ptr(tape_);
+    const double* c = get_ptr(tape_const_);
+    casadi_int m;
+    // Dispatch using computed goto where available, otherwise with a switch
+#ifdef __GNUC__
+#define CASADI_TAPE_LABEL(NAME) &&tape_##NAME,
+    static void* const labels[] = {CASADI_TAPE_OPS(CASADI_TAPE_LABEL)};
+#undef CASADI_TAPE_LABEL
+#define TAPE_CASE(NAME) tape_##NAME
+#define TAPE_NEXT goto *labels[*p++]
+    TAPE_NEXT;
+#else // __GNUC__
+#define TAPE_CASE(NAME) case TAPE_##NAME
+#define TAPE_NEXT continue
+    for (;;) switch (*p++) {
+#endif // __GNUC__
+    TAPE_CASE(CONST):
+      w[p[0]] = c[p[1]]; p += 2; TAPE_NEXT;
+    TAPE_CASE(INPUT):
+      w[p[0]] = arg[p[1]]==nullptr ? 0 : arg[p[1]][p[2]]; p += 3; TAPE_NEXT;
+    TAPE_CASE(INPUT_RUN):
+      for (m = *p++; m>0; --m, p+=3) w[p[0]] = arg[p[1]]==nullptr ? 0 : arg[p[1]][p[2]];
+      TAPE_NEXT;
+    TAPE_CASE(OUTPUT):
+      if (res[p[0]]!=nullptr) res[p[0]][p[2]] = w[p[1]];
+      p += 3; TAPE_NEXT;
+    TAPE_CASE(OUTPUT_RUN):
+      for (m = *p++; m>0; --m, p+=3) if (res[p[0]]!=nullptr) res[p[0]][p[2]] = w[p[1]];
+      TAPE_NEXT;
+    TAPE_CASE(ASSIGN): w[p[0]] = w[p[1]]; p += 2; TAPE_NEXT;
+    TAPE_CASE(NEG): w[p[0]] = -w[p[1]]; p += 2; TAPE_NEXT;
+    TAPE_CASE(SQ): w[p[0]] = w[p[1]]*w[p[1]]; p += 2; TAPE_NEXT;
+    TAPE_CASE(ADD): w[p[0]] = w[p[1]] + w[p[2]]; p += 3; TAPE_NEXT;
+    TAPE_CASE(SUB): w[p[0]] = w[p[1]] - w[p[2]]; p += 3; TAPE_NEXT;
+    TAPE_CASE(MUL): w[p[0]] = w[p[1]] * w[p[2]]; p += 3; TAPE_NEXT;
+    TAPE_CASE(DIV): w[p[0]] = w[p[1]] / w[p[2]]; p += 3; TAPE_NEXT;
+    TAPE_CASE(MUL_ADD):
+      w[p[0]] = w[p[1]] * w[p[2]];
+      w[p[3]] = w[p[4]] + w[p[5]];
+      p += 6; TAPE_NEXT;
+    TAPE_CASE(ADD_OUTPUT):
+      w[p[0]] = w[p[1]] + w[p[2]];
+      if (res[p[3]]!=nullptr) res[p[3]][p[4]] = w[p[0]];
+      p += 5; TAPE_NEXT;
+    TAPE_CASE(SUB_OUTPUT):
+      w[p[0]] = w[p[1]] - w[p[2]];
+      if (res[p[3]]!=nullptr) res[p[3]][p[4]] = w[p[0]];
+      p += 5; TAPE_NEXT;
+    TAPE_CASE(MUL_OUTPUT):
+      w[p[0]] = w[p[1]] * w[p[2]];
+      if (res[p[3]]!=nullptr) res[p[3]][p[4]] = w[p[0]];
+      p += 5; TAPE_NEXT;
+    TAPE_CASE(DIV_OUTPUT):
+      w[p[0]] = w[p[1]] / w[p[2]];
+      if (res[p[3]]!=nullptr) res[p[3]][p[4]] = w[p[0]];
+      p += 5; TAPE_NEXT;
+    TAPE_CASE(UNARY):
+      casadi_math<double>::fun(p[0], w[p[2]], w[p[2]], w[p[1]]);
+      p += 3; TAPE_NEXT;
+    TAPE_CASE(BINARY):
+      casadi_math<double>::fun(p[0], w[p[2]], w[p[3]], w[p[1]]);
+      p += 4; TAPE_NEXT;
+    TAPE_CASE(STOP):
+      return;
+#ifndef __GNUC__
+    }
+#endif // __GNUC__
+#undef TAPE_CASE
+#undef TAPE_NEXT
+  }
+
+#undef CASADI_TAPE_OPS
+
+  bool SXFunction::has_eval_batch() const {
+    return free_vars_.empty() && eval_==nullptr && !verbose_
+      && !print_in_ && !print_out_ && !dump_in_ && !dump_out_ && !dump_
+      && !record_time_ && !print_time_ && !regularity_check_;
+  }
+
+  template<casadi_int W>
+  void SXFunction::eval_block(const double** arg, double** res, double* w, casadi_int k,
+                              const casadi_int* nnz_in, const casadi_int* nnz_out) const {
+    // Lanes of work vector element i are stored in w[i*W], ..., w[i*W+W-1]
+    for (auto&& e : algorithm_) {
+      switch (e.op) {
+        CASADI_MATH_FUN_BUILTIN_GEN(BinaryOperationVV, w + e.i1*W, w + e.i2*W, w + e.i0*W, W)
+
+      case OP_CONST:
+        std::fill_n(w + e.i0*W, W, e.d);
+        break;
+      case OP_INPUT:
+        if (arg[e.i1]==nullptr) {
+          std::fill_n(w + e.i0*W, W, 0.);
+        } else {
+          for (casadi_int l=0; l<W; ++l) w[e.i0*W + l] = arg[e.i1][(k+l)*nnz_in[e.i1] + e.i2];
+        }
+        break;
+      case OP_OUTPUT:
+        if (res[e.i0]!=nullptr) {
+          for (casadi_int l=0; l<W; ++l) res[e.i0][(k+l)*nnz_out[e.i0] + e.i2] = w[e.i1*W + l];
+        }
+        break;
+      default:
+        casadi_error("Unknown operation" + str(e.op));
+      }
+    }
+  }
+
+  int SXFunction::eval_batch(const double** arg, double** res, casadi_int* iw, double* w,
+                             casadi_int n) const {
+    // Make sure no free parameters
+    casadi_assert(free_vars_.empty(), "Cannot evaluate \"" + name_ + "\" since variables "
+                  + str(free_vars_) + " are free.");
+
+    // Nonzero offsets between consecutive evaluations
+    std::vector<casadi_int> nnz_in(n_in_), nnz_out(n_out_);
+    for (casadi_int i=0; i<n_in_; ++i) nnz_in[i] = this->nnz_in(i);
+    for (casadi_int i=0; i<n_out_; ++i) nnz_out[i] = this->nnz_out(i);
+
+    // Full blocks, followed by a half block and single evaluations
+    casadi_int k = 0;
+    for (; k+batch_width<=n; k+=batch_width) {
+      eval_block<batch_width>(arg, res, w, k, get_ptr(nnz_in), get_ptr(nnz_out));
+    }
+    if (k+batch_width/2<=n) {
+      eval_block<batch_width/2>(arg, res, w, k, get_ptr(nnz_in), get_ptr(nnz_out));
+      k += batch_width/2;
+    }
+    for (; k<n; ++k) {
+      eval_block<1>(arg, res, w, k, get_ptr(nnz_in), get_ptr(nnz_out));
+    }
+    return 0;
+  }
+
   bool SXFunction::is_smooth() const {
     // Go through all nodes and check if any node is non-smooth
     for (auto&& a : algorithm_) {
@@ -145,6 +400,11 @@ namespace casadi {
   }
 
   void SXFunction::codegen_body(CodeGenerator& g) const {
+    // Split into parts, to be compiled separately
+    if (g.split(algorithm_.size())) {
+      codegen_split(g);
+      return;
+    }
 
     // Run the algorithm
     for (auto&& a : algorithm_) {
@@ -172,6 +432,112 @@ namespace casadi {
     }
   }
 
+  void SXFunction::codegen_split(CodeGenerator& g) const {
+    casadi_int n = algorithm_.size();
+    casadi_int n_parts = (n + g.split_size - 1) / g.split_size;
+
+    // Work vector elements read by an instruction
+    auto reads = [](const AlgEl& a, casadi_int* r) -> casadi_int {
+      if (a.op==OP_OUTPUT) {
+        r[0] = a.i1;
+        return 1;
+      } else if (a.op==OP_CONST || a.op==OP_INPUT) {
+        return 0;
+      } else {
+        casadi_int ndep = casadi_math<double>::ndeps(a.op);
+        r[0] = a.i1;
+        r[1] = a.i2;
+        return ndep;
+      }
+    };
+
+    // Work vector elements live at the end of the current part
+    std::vector<bool> live(worksize_, false);
+    // Last part that wrote/read a work vector element
+    std::vector<casadi_int> written(worksize_, -1), read(worksize_, -1);
+    // Work vector elements passed between parts via w, for each part
+    std::vector<std::vector<casadi_int> > shared(n_parts);
+    casadi_int r[2];
+    for (casadi_int p=n_parts-1; p>=0; --p) {
+      casadi_int k0 = p*g.split_size, k1 = std::min(k0 + g.split_size, n);
+      // Elements read before written (live at the beginning of the part)
+      std::vector<casadi_int> live_in;
+      for (casadi_int k=k0; k<k1; ++k) {
+        const AlgEl& a = algorithm_[k];
+        casadi_int nr = reads(a, r);
+        for (casadi_int j=0; j<nr; ++j) {
+          if (written[r[j]]!=p && read[r[j]]!=p) live_in.push_back(r[j]);
+          read[r[j]] = p;
+        }
+        if (a.op!=OP_OUTPUT) written[a.i0] = p;
+      }
+      // Elements written and live at the end of the part
+      std::vector<casadi_int>& sh = shared[p];
+      for (casadi_int k=k0; k<k1; ++k) {
+        const AlgEl& a = algorithm_[k];
+        if (a.op!=OP_OUTPUT && live[a.i0]) {
+          sh.push_back(a.i0);
+          live[a.i0] = false;
+        }
+      }
+      // Elements written in the part are not live at its beginning, unless read first
+      for (casadi_int k=k0; k<k1; ++k) {
+        const AlgEl& a = algorithm_[k];
+        if (a.op!=OP_OUTPUT) live[a.i0] = false;
+      }
+      for (casadi_int i : live_in) {
+        live[i] = true;
+        sh.push_back(i);
+      }
+    }
+
+    // Generate parts
+    std::vector<bool> is_shared(worksize_, false);
+    std::vector<casadi_int> declared(worksize_, -1);
+    for (casadi_int p=0; p<n_parts; ++p) {
+      casadi_int k0 = p*g.split_size, k1 = std::min(k0 + g.split_size, n);
+      for (casadi_int i : shared[p]) is_shared[i] = true;
+      // Local variables for elements not shared with other parts
+      std::stringstream decl;
+      auto work = [&](casadi_int i) -> std::string {
+        if (is_shared[i]) return "w[" + str(i) + "]";
+        if (declared[i]!=p) {
+          decl << (decl.tellp()==0 ? "  casadi_real " : ", ") << "a" << i;
+          declared[i] = p;
+        }
+        return "a" + str(i);
+      };
+      std::stringstream body;
+      for (casadi_int k=k0; k<k1; ++k) {
+        const AlgEl& a = algorithm_[k];
+        if (a.op==OP_OUTPUT) {
+          std::string x = work(a.i1);
+          body << "  if (res[" << a.i0 << "]!=0) " << g.res(a.i0) << "[" << a.i2 << "]=" << x;
+        } else {
+          // Operands before result, for a deterministic order of declarations
+          std::string rhs;
+          if (a.op==OP_CONST) {
+            rhs = g.constant(a.d);
+          } else if (a.op==OP_INPUT) {
+            rhs = g.arg(a.i1) + "? " + g.arg(a.i1) + "[" + str(a.i2) + "] : 0";
+          } else {
+            casadi_int ndep = casadi_math<double>::ndeps(a.op);
+            casadi_assert_dev(ndep>0);
+            std::string x = work(a.i1);
+            rhs = ndep==1 ? g.print_op(a.op, x) : g.print_op(a.op, x, work(a.i2));
+          }
+          std::string z = work(a.i0);
+          body << "  " << z << "=" << rhs;
+        }
+        body << ";\n";
+      }
+      if (decl.tellp()!=0) decl << ";\n";
+      for (casadi_int i : shared[p]) is_shared[i] = false;
+      // Call from the function body
+      g << g.add_part(decl.str() + body.str()) << "(arg, res, w);\n";
+    }
+  }
+
   const Options SXFunction::options_
   = {{&FunctionInternal::options_},
      {{"default_in",
@@ -195,7 +561,13 @@ namespace casadi {
         "Allow construction with free variables (Default: false)"}},
       {"allow_duplicate_io_names",
        {OT_BOOL,
-        "Allow construction with duplicate io names (Default: false)"}}
+        "Allow construction with duplicate io names (Default: false)"}},
+      {"compact_tape",
+       {OT_BOOL,
+        "Evaluate numerically using a compact tape with fused instructions, "
+        "built at initialization. Only numerical evaluation uses the tape: symbolic "
+        "evaluation, forward/reverse mode AD and sparsity propagation still "
+        "interpret the algorithm (Default: false)"}}
      }
   };
 
@@ -205,6 +577,7 @@ namespace casadi {
     opts["live_variables"] = live_variables_;
     opts["just_in_time_sparsity"] = just_in_time_sparsity_;
     opts["just_in_time_opencl"] = just_in_time_opencl_;
+    opts["compact_tape"] = compact_tape_;
     return opts;
   }
 
@@ -233,6 +606,8 @@ namespace casadi {
         cse_opt = op.second;
       } else if (op.first=="allow_free") {
         allow_free = op.second;
+      } else if (op.first=="compact_tape") {
+        compact_tape_ = op.second;
       }
     }
 
@@ -246,12 +621,46 @@ namespace casadi {
                             "Option 'default_in' has incorrect length");
     }
 
+    // Sort the graph and assign the work vector, unless inherited
+    if (!specialized_) init_algorithm();
+
+    // Allocate work vectors (symbolic/numeric)
+    alloc_w(worksize_);
+
+    if (!allow_free && has_free()) {
+      casadi_error(name_ + "::init: Initialization failed since variables [" +
+      join(get_free(), "") + "] are free. These symbols occur in the output expressions "
+      "but you forgot to declare these as inputs. "
+      "Set option 'allow_free' to allow free variables.");
+    }
+
+    // Initialize just-in-time compilation for numeric evaluation using OpenCL
+    if (just_in_time_opencl_) {
+      casadi_error("OpenCL is not supported in this version of CasADi");
+    }
+
+    // Initialize just-in-time compilation for sparsity propagation using OpenCL
+    if (just_in_time_sparsity_) {
+      casadi_error("OpenCL is not supported in this version of CasADi");
+    }
+
+    // Translate the algorithm into the compact tape
+    if (compact_tape_) init_tape();
+
+    // Print
+    if (verbose_) casadi_message(str(algorithm_.size()) + " elementary operations");
+  }
+
+  void SXFunction::init_algorithm() {
     // Stack used to sort the computational graph
     std::stack<SXNode*> s;
 
     // All nodes
     std::vector<SXNode*> nodes;
 
+    // Place of each node in the sorted graph
+    NodeIndex<SXNode> node_ind;
+
     // Add the list of nodes
     casadi_int ind=0;
     for (auto it = out_.begin(); it != out_.end(); ++it, ++ind) {
@@ -259,7 +668,7 @@ namespace casadi {
       for (auto itc = (*it)->begin(); itc != (*it)->end(); ++itc, ++nz) {
         // Add outputs to the list
         s.push(itc->get());
-        sort_depth_first(s, nodes);
+        sort_depth_first(s, nodes, node_ind);
 
         // A null pointer means an output instruction
         nodes.push_back(static_cast<SXNode*>(nullptr));
@@ -267,12 +676,8 @@ namespace casadi {
     }
 
     casadi_assert(nodes.size() <= std::numeric_limits<int>::max(), "Integer overflow");
-    // Set the temporary variables to be the corresponding place in the sorted graph
-    for (casadi_int i=0; i<nodes.size(); ++i) {
-      if (nodes[i]) {
-        nodes[i]->temp = static_cast<int>(i);
-      }
-    }
+    // Place of a node in the sorted graph
+    auto place_of = [&](const SXNode* n) { return static_cast<int>(node_ind.get(n));};
 
     // Sort the nodes by type
     constants_.clear();
@@ -305,9 +710,9 @@ namespace casadi {
     // Get the sequence of instructions for the virtual machine
     algorithm_.resize(0);
     algorithm_.reserve(nodes.size());
-    for (std::vector<SXNode*>::iterator it=nodes.begin(); it!=nodes.end(); ++it) {
+    for (casadi_int k=0; k<nodes.size(); ++k) {
       // Current node
-      SXNode* n = *it;
+      SXNode* n = nodes[k];
 
       // New element in the algorithm
       AlgEl ae;
@@ -319,16 +724,16 @@ namespace casadi {
       switch (ae.op) {
       case OP_CONST: // constant
         ae.d = n->to_double();
-        ae.i0 = n->temp;
+        ae.i0 = static_cast<int>(k);
         break;
       case OP_PARAMETER: // a parameter or input
         symb_loc.push_back(std::make_pair(algorithm_.size(), n));
-        ae.i0 = n->temp;
+        ae.i0 = static_cast<int>(k);
         ae.d = 0; // value not used, but set here to avoid uninitialized data in serialization
         break;
       case OP_OUTPUT: // output instruction
         ae.i0 = curr_oind;
-        ae.i1 = out_[curr_oind]->at(curr_nz)->temp;
+        ae.i1 = place_of(out_[curr_oind]->at(curr_nz).get());
         ae.i2 = curr_nz;
 
         // Go to the next nonzero
@@ -346,9 +751,9 @@ namespace casadi {
         }
         break;
       default:       // Unary or binary operation
-        ae.i0 = n->temp;
-        ae.i1 = n->dep(0).get()->temp;
-        ae.i2 = n->dep(1).get()->temp;
+        ae.i0 = static_cast<int>(k);
+        ae.i1 = place_of(n->dep(0).get());
+        ae.i2 = place_of(n->dep(1).get());
       }
 
       // Number of dependencies
@@ -424,19 +829,10 @@ namespace casadi {
       }
     }
 
-    // Allocate work vectors (symbolic/numeric)
-    alloc_w(worksize_);
-
-    // Reset the temporary variables
-    for (casadi_int i=0; i<nodes.size(); ++i) {
-      if (nodes[i]) {
-        nodes[i]->temp = 0;
-      }
-    }
-
-    // Now mark each input's place in the algorithm
+    // Now record each input's place in the algorithm
+    std::unordered_map<const SXNode*, int> symb_ind;
     for (auto it=symb_loc.begin(); it!=symb_loc.end(); ++it) {
-      it->second->temp = it->first+1;
+      symb_ind[it->second] = it->first;
     }
 
     // Add input instructions
@@ -444,8 +840,10 @@ namespace casadi {
     for (int ind=0; ind<in_.size(); ++ind) {
       int nz=0;
       for (auto itc = in_[ind]->begin(); itc != in_[ind]->end(); ++itc, ++nz) {
-        int i = itc->get_temp()-1;
-        if (i>=0) {
+        auto it = symb_ind.find(itc->get());
+        if (it!=symb_ind.end() && it->second>=0) {
+          int i = it->second;
+
           // Mark as input
           algorithm_[i].op = OP_INPUT;
 
@@ -454,7 +852,7 @@ namespace casadi {
           algorithm_[i].i2 = nz;
 
           // Mark input as read
-          itc->set_temp(0);
+          it->second = -1;
         }
       }
     }
@@ -463,34 +861,214 @@ namespace casadi {
     free_vars_.clear();
     for (std::vector<std::pair<int, SXNode*> >::const_iterator it=symb_loc.begin();
          it!=symb_loc.end(); ++it) {
-      if (it->second->temp!=0) {
+      if (symb_ind[it->second]>=0) {
         // Save to list of free parameters
         free_vars_.push_back(SXElem::create(it->second));
+      }
+    }
+  }
 
-        // Remove marker
-        it->second->temp=0;
+  const SXFunction::InstructionGraph& SXFunction::instruction_graph() const {
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::recursive_mutex> lock(cache_mtx_);
+#endif // CASADI_WITH_THREAD
+    if (graph_) return *graph_;
+    auto g = std::make_shared<InstructionGraph>();
+    casadi_int n = algorithm_.size();
+    g->dep0.resize(n, -1);
+    g->dep1.resize(n, -1);
+    g->op_ind.resize(n, -1);
+    // Instruction that last wrote to each element of the work vector
+    std::vector<casadi_int> writer(worksize_, -1);
+    // Number of users of each instruction
+    std::vector<casadi_int> n_user(n, 0);
+    casadi_int n_op = 0;
+    for (casadi_int k=0; k<n; ++k) {
+      const AlgEl& a = algorithm_[k];
+      casadi_int ndeps = casadi_math<double>::ndeps(a.op);
+      if (ndeps>=1) n_user[g->dep0[k] = writer[a.i1]]++;
+      if (ndeps==2) {
+        g->dep1[k] = writer[a.i2];
+        if (g->dep1[k]!=g->dep0[k]) n_user[g->dep1[k]]++;
       }
+      switch (a.op) {
+      case OP_CONST:
+      case OP_PARAMETER:
+        g->leaves.push_back(k);
+        break;
+      case OP_INPUT:
+      case OP_OUTPUT:
+        break;
+      default:
+        g->op_ind[k] = n_op++;
+      }
+      if (a.op!=OP_OUTPUT) writer[a.i0] = k;
+    }
+    // Users of each instruction, in order of execution
+    g->user_offset.resize(n+1, 0);
+    for (casadi_int k=0; k<n; ++k) g->user_offset[k+1] = g->user_offset[k] + n_user[k];
+    g->user.resize(g->user_offset.back());
+    std::vector<casadi_int> pos(g->user_offset.begin(), g->user_offset.end()-1);
+    for (casadi_int k=0; k<n; ++k) {
+      if (g->dep0[k]>=0) g->user[pos[g->dep0[k]]++] = k;
+      if (g->dep1[k]>=0 && g->dep1[k]!=g->dep0[k]) g->user[pos[g->dep1[k]]++] = k;
     }
+    graph_ = g;
+    return *graph_;
+  }
 
-    if (!allow_free && has_free()) {
-      casadi_error(name_ + "::init: Initialization failed since variables [" +
-      join(get_free(), "") + "] are free. These symbols occur in the output expressions "
-      "but you forgot to declare these as inputs. "
-      "Set option 'allow_free' to allow free variables.");
+  Function SXFunction::specialize(const std::string& fname, const SX& v, const SX& vdef,
+      const Dict& opts) const {
+    casadi_assert(v.nnz()==vdef.nnz(), "Dimension mismatch: v has " + str(v.nnz())
+      + " nonzeros, vdef has " + str(vdef.nnz()));
+
+    // Nodes of the inputs, which cannot be replaced or introduced
+    std::vector<const SXNode*> in_nodes;
+    for (auto&& e : in_) input_nodes(e, in_nodes);
+    std::unordered_set<const SXNode*> is_input(in_nodes.begin(), in_nodes.end());
+
+    // Replacements of free variables and constants
+    std::unordered_map<const SXNode*, SXElem> symb_def;
+    std::map<double, SXElem> const_def;
+    for (casadi_int k=0; k<v.nnz(); ++k) {
+      const SXElem& x = v->at(k);
+      const SXElem& xdef = vdef->at(k);
+      casadi_assert(xdef.is_constant() || xdef.is_symbolic(),
+        "Replacement " + str(xdef) + " is neither a constant nor a symbol");
+      casadi_assert(!is_input.count(xdef.get()),
+        "Replacement " + str(xdef) + " is an input of " + name_);
+      if (x.is_symbolic()) {
+        casadi_assert(!is_input.count(x.get()),
+          "Cannot replace " + str(x) + ", which is an input of " + name_);
+        symb_def[x.get()] = xdef;
+      } else {
+        casadi_assert(x.is_constant() && !std::isnan(static_cast<double>(x)),
+          "Can only replace constants and free variables, got " + str(x));
+        const_def[static_cast<double>(x)] = xdef;
+      }
     }
 
-    // Initialize just-in-time compilation for numeric evaluation using OpenCL
-    if (just_in_time_opencl_) {
-      casadi_error("OpenCL is not supported in this version of CasADi");
+    // Leaves of the algorithm, new and current values
+    const InstructionGraph& g = instruction_graph();
+    std::vector<SXElem> constants, free_vars;
+    std::map<casadi_int, SXElem> val;
+    std::unordered_map<casadi_int, SXElem> leaf_val;
+    auto c_it = constants_.begin();
+    auto p_it = free_vars_.begin();
+    for (casadi_int k : g.leaves) {
+      const SXElem& x = algorithm_[k].op==OP_CONST ? *c_it++ : *p_it++;
+      leaf_val[k] = x;
+      SXElem xdef = x;
+      if (x.is_constant()) {
+        double d = static_cast<double>(x);
+        if (!std::isnan(d)) {
+          auto it = const_def.find(d);
+          if (it!=const_def.end()) xdef = it->second;
+        }
+      } else {
+        auto it = symb_def.find(x.get());
+        if (it!=symb_def.end()) xdef = it->second;
+      }
+      // Constants with the same value need not be the same node
+      bool same = xdef.get()==x.get() || (xdef.is_constant() && x.is_constant()
+        && static_cast<double>(xdef)==static_cast<double>(x));
+      if (!same) val[k] = xdef;
+      (xdef.is_constant() ? constants : free_vars).push_back(xdef);
     }
 
-    // Initialize just-in-time compilation for sparsity propagation using OpenCL
-    if (just_in_time_sparsity_) {
-      casadi_error("OpenCL is not supported in this version of CasADi");
+    // Current value of an instruction
+    auto value = [&](casadi_int k) -> SXElem {
+      const AlgEl& a = algorithm_[k];
+      switch (a.op) {
+      case OP_INPUT: return in_[a.i1]->at(a.i2);
+      case OP_CONST:
+      case OP_PARAMETER: return leaf_val.at(k);
+      default: return operations_[g.op_ind[k]];
+      }
+    };
+
+    // Regenerate the instructions depending on the replaced leaves, in order of execution
+    std::vector<SXElem> operations = operations_;
+    std::vector<SX> out = out_;
+    bool simplified = false;
+    std::set<casadi_int> cone;
+    for (auto&& e : val) {
+      cone.insert(g.user.begin() + g.user_offset[e.first],
+                  g.user.begin() + g.user_offset[e.first+1]);
+    }
+    while (!cone.empty()) {
+      casadi_int k = *cone.begin();
+      cone.erase(cone.begin());
+      const AlgEl& a = algorithm_[k];
+      auto it0 = val.find(g.dep0[k]);
+      SXElem x = it0==val.end() ? value(g.dep0[k]) : it0->second;
+      if (a.op==OP_OUTPUT) {
+        out[a.i0]->at(a.i2) = x;
+        continue;
+      }
+      SXElem y = x;
+      if (g.dep1[k]>=0) {
+        auto it1 = val.find(g.dep1[k]);
+        y = it1==val.end() ? value(g.dep1[k]) : it1->second;
+      }
+      SXElem f;
+      switch (a.op) {
+        CASADI_MATH_FUN_BUILTIN(x, y, f)
+      }
+      // The new values may have allowed the operation to be simplified away
+      if (f.op()!=a.op || !SXElem::is_equal(f.dep(0), x)
+          || (casadi_math<double>::ndeps(a.op)==2 && !SXElem::is_equal(f.dep(1), y))) {
+        simplified = true;
+      }
+      val[k] = operations[g.op_ind[k]] = f;
+      cone.insert(g.user.begin() + g.user_offset[k], g.user.begin() + g.user_offset[k+1]);
     }
 
-    // Print
-    if (verbose_) casadi_message(str(algorithm_.size()) + " elementary operations");
+    // Options of the new function
+    Dict my_opts = generate_options("clone");
+    if (!free_vars.empty()) my_opts["allow_free"] = true;
+    update_dict(my_opts, opts);
+
+    // Options that change the algorithm
+    for (auto&& op : opts) {
+      if ((op.first=="cse" && op.second.to_bool())
+          || (op.first=="live_variables" && op.second.to_bool()!=live_variables_)) {
+        simplified = true;
+      }
+    }
+
+    // The algorithm no longer matches the expressions, sort the graph again
+    if (simplified) return Function(fname, in_, out, name_in_, name_out_, my_opts);
+
+    // Same algorithm, with the leaves updated
+    std::vector<AlgEl> algorithm = algorithm_;
+    for (casadi_int k : g.leaves) {
+      auto it = val.find(k);
+      if (it==val.end()) continue;
+      AlgEl& a = algorithm[k];
+      if (it->second.is_constant()) {
+        a.op = OP_CONST;
+        a.d = static_cast<double>(it->second);
+      } else {
+        a.op = OP_PARAMETER;
+        a.d = 0;
+      }
+    }
+
+    // Create the function, skipping the sorting in init
+    SXFunction* n = new SXFunction(fname, in_, out, name_in_, name_out_);
+    Function ret;
+    ret.own(n);
+    n->algorithm_ = std::move(algorithm);
+    n->worksize_ = worksize_;
+    n->operations_ = std::move(operations);
+    n->constants_ = std::move(constants);
+    n->free_vars_ = std::move(free_vars);
+    n->default_in_ = default_in_;
+    n->graph_ = graph_;
+    n->specialized_ = true;
+    ret->construct(my_opts);
+    return ret;
   }
 
   SX SXFunction::instructions_sx() const {
@@ -975,7 +1553,7 @@ namespace casadi {
 
   SXFunction::SXFunction(DeserializingStream& s) :
     XFunction<SXFunction, SX, SXNode>(s) {
-    s.version("SXFunction", 1);
+    int version = s.version("SXFunction", 1, 2);
     size_t n_instructions;
     s.unpack("SXFunction::n_instr", n_instructions);
 
@@ -997,15 +1575,24 @@ namespace casadi {
     // Default (persistent) options
     just_in_time_opencl_ = false;
     just_in_time_sparsity_ = false;
+    specialized_ = false;
 
     s.unpack("SXFunction::live_variables", live_variables_);
 
+    if (version >= 2) {
+      s.unpack("SXFunction::compact_tape", compact_tape_);
+    } else {
+      compact_tape_ = false;
+    }
+
     XFunction<SXFunction, SX, SXNode>::delayed_deserialize_members(s);
+
+    if (compact_tape_) init_tape();
   }
 
   void SXFunction::serialize_body(SerializingStream &s) const {
     XFunction<SXFunction, SX, SXNode>::serialize_body(s);
-    s.version("SXFunction", 1);
+    s.version("SXFunction", 2);
     s.pack("SXFunction::n_instr", algorithm_.size());
 
     s.pack("SXFunction::worksize", worksize_);
@@ -1023,6 +1610,7 @@ namespace casadi {
     }
 
     s.pack("SXFunction::live_variables", live_variables_);
+    s.pack("SXFunction::compact_tape", compact_tape_);
 
     XFunction<SXFunction, SX, SXNode>::delayed_serialize_members(s);
   }
@@ -27,6 +27,7 @@
 #define CASADI_SX_FUNCTION_HPP
 
 #include "x_function.hpp"
+#include <memory>
 
 /// \cond INTERNAL
 
@@ -72,6 +73,31 @@ class CASADI_EXPORT SXFunction :
       \identifier{ue} */
   int eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const override;
 
+  /** \brief  Evaluate numerically for a batch of independent inputs
+
+      The function is evaluated n times, with the inputs and outputs of consecutive
+      evaluations stored one after the other, as in Map. Each instruction is executed
+      for a block of up to batch_width evaluations, stored as a structure of arrays
+      in w, which must have length sz_w_batch().
+
+      \identifier{281} */
+  int eval_batch(const double** arg, double** res, casadi_int* iw, double* w,
+                 casadi_int n) const;
+
+  /** \brief  Can eval_batch be used in place of repeated calls?
+
+      Not the case for functions with free variables, JIT compilation or options
+      acting on individual calls, such as printing, dumping or timing.
+
+      \identifier{282} */
+  bool has_eval_batch() const;
+
+  /// Number of evaluations processed together by eval_batch
+  static const casadi_int batch_width = 8;
+
+  /// Work vector length for eval_batch
+  size_t sz_w_batch() const { return worksize_ * batch_width;}
+
   /** \brief  evaluate symbolically while also propagating directional derivatives
 
       \identifier{uf} */
@@ -144,6 +170,15 @@ class CASADI_EXPORT SXFunction :
     return ret;
   }
 
+  /** \brief Derive a function with constants or free variables replaced
+
+      Reuses the algorithm and the work vector assignment,
+      see Function::specialize
+
+      \identifier{299} */
+  Function specialize(const std::string& name, const SX& v, const SX& vdef,
+                      const Dict& opts) const override;
+
   /** \brief Hessian (forward over adjoint) via source code transformation
 
       \identifier{up} */
@@ -270,6 +305,9 @@ class CASADI_EXPORT SXFunction :
       \identifier{v5} */
   void codegen_body(CodeGenerator& g) const override;
 
+  /// Generate code for the body, split into parts
+  void codegen_split(CodeGenerator& g) const;
+
   /** \brief  Propagate sparsity forward
 
       \identifier{v6} */
@@ -306,11 +344,60 @@ class CASADI_EXPORT SXFunction :
   /// Live variables?
   bool live_variables_;
 
+  /// Evaluate numerically using the compact tape? Not used by eval_sx, AD, sparsity
+  bool compact_tape_;
+
+  /// Compact tape: opcodes, each followed by its 32-bit operands
+  std::vector<int> tape_;
+
+  /// Constants referenced by the compact tape
+  std::vector<double> tape_const_;
+
+  /** \brief Dependencies between the instructions of the algorithm
+
+      Independent of the values of the constants and free variables, hence
+      shared with the functions derived with specialize
+
+      \identifier{29a} */
+  struct InstructionGraph {
+    /// Instructions computing the operands of each instruction, -1 if none
+    std::vector<casadi_int> dep0, dep1;
+    /// Instructions using the result of each instruction, in compressed form
+    std::vector<casadi_int> user_offset, user;
+    /// Position of each operation in operations_, -1 for other instructions
+    std::vector<casadi_int> op_ind;
+    /// Instructions loading a constant or a free variable
+    std::vector<casadi_int> leaves;
+  };
+
+  /// Get the dependencies between the instructions, built on first use
+  const InstructionGraph& instruction_graph() const;
+
+  /// Dependencies between the instructions, if built
+  mutable std::shared_ptr<const InstructionGraph> graph_;
+
+  /// Algorithm inherited from the function this one was derived from?
+  bool specialized_;
+
 protected:
   /** \brief Deserializing constructor
 
       \identifier{vb} */
   explicit SXFunction(DeserializingStream& s);
+
+  /// Sort the expression graph into the algorithm and assign the work vector
+  void init_algorithm();
+
+  /// Translate the algorithm into the compact tape
+  void init_tape();
+
+  /// Evaluate the compact tape
+  void eval_tape(const double** arg, double** res, double* w) const;
+
+  /// Evaluate a block of W evaluations, starting with evaluation k
+  template<casadi_int W>
+  void eval_block(const double** arg, double** res, double* w, casadi_int k,
+                  const casadi_int* nnz_in, const casadi_int* nnz_out) const;
 };
 
 
@@ -27,6 +27,9 @@
 
 #include "sx_function.hpp"
 
+#include <cstring>
+#include <unordered_map>
+
 namespace casadi {
 
   template<>
@@ -564,30 +567,49 @@ namespace casadi {
     return false;
   }
 
-  class IncrementalSerializer {
-    public:
-
-    IncrementalSerializer() : serializer(ss) {
+  /** \brief Structural key of an SXElem for hash-consing
+
+      Children are compared by node identity, which suffices when
+      the children have already been made unique. */
+  struct SXConsKey {
+    casadi_int op;
+    const SXNode* dep0;
+    const SXNode* dep1;
+    uint64_t bits;
+
+    explicit SXConsKey(const SXElem& e) : dep0(nullptr), dep1(nullptr), bits(0) {
+      if (e.is_constant()) {
+        op = OP_CONST;
+        double v = static_cast<double>(e);
+        std::memcpy(&bits, &v, sizeof(v));
+      } else if (e.is_symbolic()) {
+        op = OP_PARAMETER;
+        dep0 = e.get();
+      } else {
+        op = e.op();
+        dep0 = e.dep(0).get();
+        if (e.n_dep()==2) dep1 = e.dep(1).get();
+      }
     }
 
-    std::string pack(const SXElem& a) {
-      serializer.pack(a);
-      // Serialization goes wrong if serialized SXNodes get destroyed
-      ref.push_back(a);
-      std::string ret = ss.str();
-      ss.str("");
-      ss.clear();
-      //uout() << a << ":" << ret << std::endl;
-      return ret;
-    }
+    SXConsKey(casadi_int op, const SXNode* dep0, const SXNode* dep1)
+      : op(op), dep0(dep0), dep1(dep1), bits(0) {}
 
-    private:
-      std::stringstream ss;
-      // List of references to keep alive
-      std::vector<SXElem> ref;
-      SerializingStream serializer;
+    bool operator==(const SXConsKey& k) const {
+      return op==k.op && dep0==k.dep0 && dep1==k.dep1 && bits==k.bits;
+    }
   };
 
+  struct SXConsHash {
+    std::size_t operator()(const SXConsKey& k) const {
+      std::size_t seed = 0;
+      hash_combine(seed, k.op);
+      hash_combine(seed, reinterpret_cast<std::uintptr_t>(k.dep0));
+      hash_combine(seed, reinterpret_cast<std::uintptr_t>(k.dep1));
+      hash_combine(seed, k.bits);
+      return seed;
+    }
+  };
 
   template<>
   std::vector<SX> CASADI_EXPORT SX::cse(const std::vector<SX>& e) {
@@ -616,8 +638,9 @@ namespace casadi {
       res[i] = get_ptr(ret.at(i).nonzeros());
     }
 
-    std::unordered_map<std::string, SXElem > cache;
-    IncrementalSerializer s;
+    // Unique nodes, the values keep the nodes in the keys alive
+    std::unordered_map<SXConsKey, SXElem, SXConsHash> cache;
+    cache.reserve(ff->algorithm_.size());
 
     // Iterator to stack of constants
     std::vector<SXElem>::const_iterator c_it = ff->constants_.begin();
@@ -630,22 +653,31 @@ namespace casadi {
       switch (a.op) {
       case OP_INPUT:
         w[a.i0] = arg[a.i1]==nullptr ? 0 : arg[a.i1][a.i2];
-        if (arg[a.i1]!=nullptr) cache[s.pack(w[a.i0])] = w[a.i0];
+        w[a.i0] = cache.emplace(SXConsKey(w[a.i0]), w[a.i0]).first->second;
         break;
       case OP_OUTPUT:
         if (res[a.i0]!=nullptr) res[a.i0][a.i2] = w[a.i1];
         break;
       case OP_CONST:
         w[a.i0] = *c_it++;
-        cache[s.pack(w[a.i0])] = w[a.i0];
+        w[a.i0] = cache.emplace(SXConsKey(w[a.i0]), w[a.i0]).first->second;
         break;
       case OP_PARAMETER:
         w[a.i0] = *p_it++;
-        cache[s.pack(w[a.i0])] = w[a.i0];
+        cache.emplace(SXConsKey(w[a.i0]), w[a.i0]);
         break;
       default:
         {
 
+          // Operation applied to unique children
+          SXConsKey key(a.op, w[a.i1].get(),
+            casadi_math<double>::ndeps(a.op)==2 ? w[a.i2].get() : nullptr);
+          auto itk = cache.find(key);
+          if (itk!=cache.end()) {
+            w[a.i0] = itk->second;
+            break;
+          }
+
           // Evaluate the function to a temporary value
           // (as it might overwrite the children in the work vector)
           SXElem f;
@@ -654,14 +686,9 @@ namespace casadi {
             CASADI_MATH_FUN_BUILTIN(w[a.i1], w[a.i2], f)
           }
 
-          std::string key = s.pack(f);
-
-          auto itk = cache.find(key);
-          if (itk==cache.end()) {
-            cache[key] = f;
-          } else {
-            f = itk->second;
-          }
+          // The result may have been simplified to an existing node
+          f = cache.emplace(SXConsKey(f), f).first->second;
+          cache.emplace(key, f);
 
           // Finally save the function value
           w[a.i0] = f;
@@ -939,12 +966,13 @@ namespace casadi {
     }
     // Consistency check
     casadi_assert(vdef.size() < std::numeric_limits<int>::max(), "Integer overflow");
-    // Mark the above expressions
+    // Record the above expressions
+    std::unordered_map<const SXNode*, casadi_int> vdef_ind;
     for (casadi_int i=0; i<vdef.size(); ++i) {
-      vdef[i].set_temp(static_cast<int>(i)+1);
+      vdef_ind[vdef[i].get()] = i;
     }
-    // Save the marked nodes for later cleanup
-    std::vector<SXElem> marked = vdef;
+    // Keep the recorded nodes alive while vdef is being overwritten
+    std::vector<SXElem> recorded = vdef;
     // Reset iterator
     b_it=ff->operations_.begin();
     // Evaluate the algorithm
@@ -960,18 +988,14 @@ namespace casadi {
               }
           work2[it->i0] = *b_it++;
           // Replace with intermediate variables
-          casadi_int ind = work2[it->i0].get_temp()-1;
-          if (ind>=0) {
-            vdef.at(ind) = work[it->i0];
-            work[it->i0] = v.at(ind);
+          auto vit = vdef_ind.find(work2[it->i0].get());
+          if (vit!=vdef_ind.end()) {
+            vdef.at(vit->second) = work[it->i0];
+            work[it->i0] = v.at(vit->second);
           }
         }
       }
     }
-    // Unmark the expressions
-    for (std::vector<SXElem>::iterator it=marked.begin(); it!=marked.end(); ++it) {
-      it->set_temp(0);
-    }
     // Save v, vdef
     v_sx.resize(v.size());
     std::copy(v.begin(), v.end(), v_sx.begin());
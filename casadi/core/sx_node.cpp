@@ -154,7 +154,7 @@ namespace casadi {
 
   void SXNode::safe_delete(SXNode* n) {
     // Quick return if more owners
-    if (n->count>0) return;
+    if (n==nullptr) return;
     // Delete straight away if it doesn't have any dependencies
     if (!n->n_dep()) {
       delete n;
@@ -174,8 +174,8 @@ namespace casadi {
         // Get the node of the dependency of the top element
         // and remove it from the smart pointer
         SXNode *n2 = t->dep(c2).assignNoDelete(casadi_limits<SXElem>::nan);
-        // Check if this is the only reference to the element
-        if (n2->count == 0) {
+        // Check if this was the only reference to the element
+        if (n2) {
           // Check if unary or binary
           if (!n2->n_dep()) {
             // Delete straight away if not binary
@@ -210,18 +210,22 @@ namespace casadi {
     casadi_int op;
     s.unpack("SXNode::op", op);
 
+    SXNode* n;
     if (casadi_math<MX>::is_binary(op)) {
-      return BinarySX::deserialize(s, op);
+      n = BinarySX::deserialize(s, op);
     } else if (casadi_math<MX>::is_unary(op)) {
-      return UnarySX::deserialize(s, op);
-    }
-
-    auto it = SXNode::deserialize_map.find(op);
-    if (it==SXNode::deserialize_map.end()) {
-      casadi_error("Not implemented op " + str(casadi_int(op)));
+      n = UnarySX::deserialize(s, op);
     } else {
-      return it->second(s);
+      auto it = SXNode::deserialize_map.find(op);
+      if (it==SXNode::deserialize_map.end()) {
+        casadi_error("Not implemented op " + str(casadi_int(op)));
+      }
+      // Constants are shared and come with a reference already
+      if (op==OP_CONST) return it->second(s);
+      n = it->second(s);
     }
+    n->count++;
+    return n;
   }
 
 
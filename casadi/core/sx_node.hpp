@@ -31,10 +31,15 @@
 #include <sstream>
 #include <string>
 
+#ifdef CASADI_WITH_THREAD
+#include <atomic>
+#endif // CASADI_WITH_THREAD
+
 /** \brief  Scalar expression (which also works as a smart pointer class to this class)
 
     \identifier{9s} */
 #include "sx_elem.hpp"
+#include "node_pool.hpp"
 
 
 /// \cond INTERNAL
@@ -62,6 +67,14 @@ namespace casadi {
         \identifier{9v} */
     virtual ~SXNode();
 
+    ///@{
+    /** \brief Nodes are allocated from size-class pools, cf. NodePool
+
+        \identifier{292} */
+    static void* operator new(size_t sz) { return NodePool::allocate(sz);}
+    static void operator delete(void* p, size_t sz) { NodePool::deallocate(p, sz);}
+    ///@}
+
     ///@{
     /** \brief  check properties of a node
 
@@ -154,6 +167,8 @@ namespace casadi {
 
     /** \brief Non-recursive delete
 
+        Takes a node released with SXElem::assignNoDelete, null if still referenced.
+
         \identifier{a9} */
     static void safe_delete(SXNode* n);
 
@@ -162,12 +177,17 @@ namespace casadi {
 
     /** Temporary variables to be used in user algorithms like sorting,
         the user is responsible of making sure that use is thread-safe
-        The variable is initialized to zero
+        The variable is initialized to zero. Function construction only uses it
+        when CasADi is built without WITH_THREAD, see NodeIndex.
     */
     mutable int temp;
 
     // Reference counter -- counts the number of parents of the node
+#ifdef CASADI_WITH_THREAD
+    std::atomic<unsigned int> count;
+#else // CASADI_WITH_THREAD
     unsigned int count;
+#endif // CASADI_WITH_THREAD
 
     /** \brief Serialize an object
 
@@ -176,6 +196,7 @@ namespace casadi {
 
     virtual void serialize_node(SerializingStream& s) const;
 
+    /// Deserialize a node, the returned node holds a reference owned by the caller
     static SXNode* deserialize(DeserializingStream& s);
 
     static std::map<casadi_int, SXNode* (*)(DeserializingStream&)> deserialize_map;
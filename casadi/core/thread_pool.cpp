@@ -0,0 +1,211 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "thread_pool.hpp"
+#include "global_options.hpp"
+
+#ifdef CASADI_WITH_THREAD
+#include <atomic>
+#include <exception>
+#include <memory>
+#endif // CASADI_WITH_THREAD
+
+namespace casadi {
+
+#ifdef CASADI_WITH_THREAD
+  // Set for worker threads and for a thread that is running a parallel loop
+  static thread_local bool in_parallel_loop = false;
+
+  struct ThreadPool::Job {
+    // Task to be evaluated
+    const std::function<int(casadi_int)>* task;
+    // Number of indices and chunk size
+    casadi_int n, chunk;
+    // Chunks [next[p], end[p]) have not yet been claimed, one range per participant
+    std::vector<casadi_int> end;
+    std::unique_ptr<std::atomic<casadi_int>[]> next;
+    // Combined return flag
+    std::atomic<int> flag;
+    // First exception raised by a task
+    std::mutex ex_mtx;
+    std::exception_ptr ex;
+  };
+#endif // CASADI_WITH_THREAD
+
+  ThreadPool& ThreadPool::instance() {
+    static ThreadPool pool;
+    return pool;
+  }
+
+  casadi_int ThreadPool::num_threads() {
+    casadi_int n = GlobalOptions::thread_pool_size;
+#ifdef CASADI_WITH_THREAD
+    if (n <= 0) n = std::thread::hardware_concurrency();
+#endif // CASADI_WITH_THREAD
+    return std::max(n, static_cast<casadi_int>(1));
+  }
+
+  ThreadPool::~ThreadPool() {
+#ifdef CASADI_WITH_THREAD
+    stop();
+#endif // CASADI_WITH_THREAD
+  }
+
+  int ThreadPool::run_serial(casadi_int n, const std::function<int(casadi_int)>& task) {
+    int flag = 0;
+    for (casadi_int i = 0; i < n; ++i) {
+      if (task(i)) flag = 1;
+    }
+    return flag;
+  }
+
+  int ThreadPool::run(casadi_int n, const std::function<int(casadi_int)>& task,
+      casadi_int chunk) {
+#ifndef CASADI_WITH_THREAD
+    return run_serial(n, task);
+#else // CASADI_WITH_THREAD
+    // Nested parallelism is evaluated serially
+    if (n <= 1 || in_parallel_loop) return run_serial(n, task);
+    // Another thread is using the pool
+    std::unique_lock<std::mutex> run_lock(run_mtx_, std::try_to_lock);
+    if (!run_lock.owns_lock()) return run_serial(n, task);
+
+    // (Re)start workers, if needed
+    casadi_int n_threads = num_threads();
+    if (static_cast<casadi_int>(workers_.size()) != n_threads - 1) {
+      stop();
+      start(n_threads - 1);
+    }
+    if (n_threads == 1) return run_serial(n, task);
+
+    // Chunk size
+    if (chunk <= 0) chunk = GlobalOptions::thread_pool_chunk_size;
+    if (chunk <= 0) chunk = std::max(n / (4 * n_threads), static_cast<casadi_int>(1));
+
+    // Distribute chunks evenly over the participants
+    casadi_int n_chunks = (n + chunk - 1) / chunk;
+    casadi_int n_part = std::min(n_chunks, n_threads);
+    Job job;
+    job.task = &task;
+    job.n = n;
+    job.chunk = chunk;
+    job.end.resize(n_part);
+    job.next.reset(new std::atomic<casadi_int>[n_part]);
+    for (casadi_int p = 0; p < n_part; ++p) {
+      job.next[p] = (p * n_chunks) / n_part;
+      job.end[p] = ((p + 1) * n_chunks) / n_part;
+    }
+    job.flag = 0;
+
+    // Wake up workers
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      job_ = &job;
+      generation_++;
+    }
+    cv_work_.notify_all();
+
+    // The calling thread participates
+    in_parallel_loop = true;
+    work(job, 0);
+    in_parallel_loop = false;
+
+    // All chunks have been claimed, wait for the workers to finish theirs
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      job_ = nullptr;
+      cv_done_.wait(lock, [this] { return busy_ == 0; });
+    }
+
+    // Propagate exceptions
+    if (job.ex) std::rethrow_exception(job.ex);
+    return job.flag;
+#endif // CASADI_WITH_THREAD
+  }
+
+#ifdef CASADI_WITH_THREAD
+  void ThreadPool::start(casadi_int n_workers) {
+    workers_.reserve(n_workers);
+    for (casadi_int id = 1; id <= n_workers; ++id) {
+      workers_.emplace_back([this, id]() { worker(id); });
+    }
+  }
+
+  void ThreadPool::stop() {
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      stop_ = true;
+    }
+    cv_work_.notify_all();
+    for (auto&& th : workers_) th.join();
+    workers_.clear();
+    stop_ = false;
+  }
+
+  void ThreadPool::worker(casadi_int id) {
+    in_parallel_loop = true;
+    casadi_int seen = 0;
+    while (true) {
+      Job* job;
+      {
+        std::unique_lock<std::mutex> lock(mtx_);
+        cv_work_.wait(lock, [&] { return stop_ || (job_ && generation_ != seen); });
+        if (stop_) return;
+        seen = generation_;
+        job = job_;
+        busy_++;
+      }
+      work(*job, id);
+      {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (--busy_ == 0) cv_done_.notify_all();
+      }
+    }
+  }
+
+  void ThreadPool::work(Job& job, casadi_int id) {
+    casadi_int n_part = job.end.size();
+    // Own range first, then steal from the others
+    for (casadi_int k = 0; k < n_part; ++k) {
+      casadi_int p = (id + k) % n_part;
+      while (true) {
+        casadi_int c = job.next[p]++;
+        if (c >= job.end[p]) break;
+        casadi_int i_end = std::min((c + 1) * job.chunk, job.n);
+        for (casadi_int i = c * job.chunk; i < i_end; ++i) {
+          try {
+            if ((*job.task)(i)) job.flag = 1;
+          } catch (...) {
+            job.flag = 1;
+            std::lock_guard<std::mutex> lock(job.ex_mtx);
+            if (!job.ex) job.ex = std::current_exception();
+          }
+        }
+      }
+    }
+  }
+#endif // CASADI_WITH_THREAD
+
+} // namespace casadi
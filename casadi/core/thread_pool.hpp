@@ -0,0 +1,140 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_THREAD_POOL_HPP
+#define CASADI_THREAD_POOL_HPP
+
+#include "casadi_common.hpp"
+#include <functional>
+
+#ifdef CASADI_WITH_THREAD
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.thread.h>
+#include <mingw.mutex.h>
+#include <mingw.condition_variable.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif // CASADI_WITH_THREAD
+
+/// \cond INTERNAL
+namespace casadi {
+
+  /** \brief Process-wide pool of persistent worker threads
+
+      The worker threads are started on first use and stay alive until the pool
+      is resized or the process exits. A parallel loop is split into chunks of
+      consecutive indices which are distributed evenly over the participating
+      threads, the calling thread included. A thread that runs out of chunks
+      steals unclaimed chunks from the other threads.
+
+      Only one parallel loop is processed at a time. Nested loops, i.e. loops
+      started from within a task, and loops started while the pool is busy are
+      evaluated serially by the calling thread.
+
+      The number of threads is set with GlobalOptions::setThreadPoolSize.
+      Without WITH_THREAD=ON, all loops are evaluated serially.
+
+      \identifier{27v} */
+  class CASADI_EXPORT ThreadPool {
+  public:
+    /** \brief Access the process-wide instance
+
+        \identifier{27w} */
+    static ThreadPool& instance();
+
+    /** \brief Number of threads taking part in a parallel loop, including the caller
+
+        \identifier{27x} */
+    static casadi_int num_threads();
+
+    /** \brief Evaluate task(i) for i = 0, ..., n-1 in parallel
+
+        \param chunk Number of consecutive indices handed out at a time,
+                     zero or negative for the GlobalOptions default
+        \return Zero if all tasks returned zero
+
+        Exceptions raised by a task are rethrown in the calling thread
+        after all tasks have finished.
+
+        \identifier{27y} */
+    int run(casadi_int n, const std::function<int(casadi_int)>& task, casadi_int chunk=0);
+
+    /** \brief Destructor, joins all worker threads
+
+        \identifier{27z} */
+    ~ThreadPool();
+
+  private:
+    // Use instance()
+    ThreadPool() = default;
+
+    // Evaluate serially in the calling thread
+    static int run_serial(casadi_int n, const std::function<int(casadi_int)>& task);
+
+#ifdef CASADI_WITH_THREAD
+    // A parallel loop that is being processed
+    struct Job;
+
+    // Start/stop worker threads
+    void start(casadi_int n_workers);
+    void stop();
+
+    // Main loop of a worker thread
+    void worker(casadi_int id);
+
+    // Claim and evaluate chunks, starting with the range of participant id
+    static void work(Job& job, casadi_int id);
+
+    // Worker threads
+    std::vector<std::thread> workers_;
+
+    // Only one parallel loop at a time
+    std::mutex run_mtx_;
+
+    // Protects the members below
+    std::mutex mtx_;
+    std::condition_variable cv_work_, cv_done_;
+
+    // Current job, null if none
+    Job* job_ = nullptr;
+
+    // Incremented for every new job
+    casadi_int generation_ = 0;
+
+    // Number of workers currently processing a job
+    casadi_int busy_ = 0;
+
+    // Ask workers to exit
+    bool stop_ = false;
+#endif // CASADI_WITH_THREAD
+  };
+
+} // namespace casadi
+/// \endcond
+
+#endif // CASADI_THREAD_POOL_HPP
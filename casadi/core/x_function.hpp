@@ -35,6 +35,8 @@
 #include <unordered_map>
 #define SPARSITY_MAP std::unordered_map
 
+#include <unordered_set>
+
 // Throw informative error message
 #define CASADI_THROW_ERROR(FNAME, WHAT) \
 throw CasadiException("Error in XFunction::" FNAME " for '" + this->name_ + "' "\
@@ -45,6 +47,58 @@ throw CasadiException("Error in XFunction::" FNAME " for '" + this->name_ + "' "
 
 namespace casadi {
 
+  /// Nodes of the symbolic primitives of a function input
+  inline void input_nodes(const SX& x, std::vector<const SXNode*>& nodes) {
+    for (const SXElem& e : x.nonzeros()) nodes.push_back(e.get());
+  }
+
+  /// Nodes of the symbolic primitives of a function input
+  inline void input_nodes(const MX& x, std::vector<const MXNode*>& nodes) {
+    for (const MX& p : x.primitives()) {
+      if (p.is_symbolic()) nodes.push_back(p.get());
+    }
+  }
+
+  /** \brief Position of nodes during a graph traversal
+
+      Unvisited nodes have position -1. With WITH_THREAD, positions are kept in a
+      hash map owned by the traversal, so that graphs sharing nodes can be sorted
+      concurrently. Otherwise they are kept in the temp field of the nodes, offset
+      by one, and the touched nodes are reset on destruction.
+  */
+  template<typename NodeType>
+  class NodeIndex {
+  public:
+#ifdef CASADI_WITH_THREAD
+    /// Position of a node
+    casadi_int get(const NodeType* n) const {
+      auto it = ind_.find(n);
+      return it==ind_.end() ? -1 : it->second;
+    }
+
+    /// Set the position of a node
+    void set(const NodeType* n, casadi_int i) { ind_[n] = i;}
+  private:
+    std::unordered_map<const NodeType*, casadi_int> ind_;
+#else // CASADI_WITH_THREAD
+    /// Destructor, resets the temp fields
+    ~NodeIndex() {
+      for (const NodeType* n : touched_) n->temp = 0;
+    }
+
+    /// Position of a node
+    casadi_int get(const NodeType* n) const { return n->temp - 1;}
+
+    /// Set the position of a node
+    void set(const NodeType* n, casadi_int i) {
+      if (n->temp==0) touched_.push_back(n);
+      n->temp = i + 1;
+    }
+  private:
+    std::vector<const NodeType*> touched_;
+#endif // CASADI_WITH_THREAD
+  };
+
   /** \brief  Internal node class for the base class of SXFunction and MXFunction
 
       (lacks a public counterpart)
@@ -85,8 +139,11 @@ namespace casadi {
 
     /** \brief  Topological sorting of the nodes based on Depth-First Search (DFS)
 
+        On return, \a visited holds the position of each sorted node in \a nodes.
+
         \identifier{xr} */
-    static void sort_depth_first(std::stack<NodeType*>& s, std::vector<NodeType*>& nodes);
+    static void sort_depth_first(std::stack<NodeType*>& s, std::vector<NodeType*>& nodes,
+      NodeIndex<NodeType>& visited);
 
     /** \brief  Construct a complete Jacobian by compression
 
@@ -334,14 +391,18 @@ namespace casadi {
     }
     // Check for duplicate entries among the input expressions
     bool has_duplicates = false;
-    for (auto&& i : in_) {
-      if (i.has_duplicates()) {
-        has_duplicates = true;
-        break;
+    std::vector<const NodeType*> prim;
+    std::unordered_set<const NodeType*> visited;
+    for (casadi_int i=0; i<n_in_; ++i) {
+      prim.clear();
+      input_nodes(in_[i], prim);
+      for (const NodeType* n : prim) {
+        if (!visited.insert(n).second) {
+          casadi_warning("Duplicate expression in input " + str(i) + " (" + name_in_[i] + ")");
+          has_duplicates = true;
+        }
       }
     }
-    // Reset temporaries
-    for (auto&& i : in_) i.reset_input();
     // Generate error
     if (has_duplicates) {
       std::stringstream s;
@@ -385,23 +446,28 @@ namespace casadi {
 
   template<typename DerivedType, typename MatType, typename NodeType>
   void XFunction<DerivedType, MatType, NodeType>::sort_depth_first(
-      std::stack<NodeType*>& s, std::vector<NodeType*>& nodes) {
+      std::stack<NodeType*>& s, std::vector<NodeType*>& nodes,
+      NodeIndex<NodeType>& visited) {
     while (!s.empty()) {
       // Get the topmost element
       NodeType* t = s.top();
+      // Nodes on the stack map to -1 minus the index of the next dependency,
+      // nodes already added to their position in the algorithm
+      casadi_int state = t ? visited.get(t) : 0;
       // If the last element on the stack has not yet been added
-      if (t && t->temp>=0) {
+      if (state<0) {
         // Get the index of the next dependency
-        casadi_int next_dep = t->temp++;
+        casadi_int next_dep = -1 - state;
+        visited.set(t, state-1);
         // If there is any dependency which has not yet been added
         if (next_dep < t->n_dep()) {
           // Add dependency to stack
           s.push(static_cast<NodeType*>(t->dep(next_dep).get()));
         } else {
+          // Mark the node as found
+          visited.set(t, nodes.size());
           // if no dependencies need to be added, we can add the node to the algorithm
           nodes.push_back(t);
-          // Mark the node as found
-          t->temp = -1;
           // Remove from stack
           s.pop();
         }
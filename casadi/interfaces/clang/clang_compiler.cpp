@@ -97,6 +97,21 @@ namespace casadi {
       }
     }
 
+    casadi_assert(units().empty(),
+      "Multiple translation units are not supported by the clang plugin, use 'n_units': 1.");
+
+    // Look up the module, as LLVM bitcode, in the cache
+    std::string key;
+#if LLVM_VERSION_MAJOR >= 7
+    if (!cache_directory_.empty()) {
+      std::stringstream config;
+      config << join(flags_, " ") << "\n" << include_path_ << "\n" << LLVM_VERSION_STRING;
+      key = cache_key(config.str());
+      std::string cached;
+      if (cache_get(key, ".bc", cached) && load_cached(cached)) return;
+    }
+#endif
+
     // Arguments to pass to the clang frontend
     std::vector<const char *> args(1, name_.c_str());
     for (auto&& f : flags_) {
@@ -220,6 +235,22 @@ namespace casadi {
     module_ = module;
     #endif
 
+#if LLVM_VERSION_MAJOR >= 7
+    // Publish the module in the cache
+    if (!key.empty()) {
+      llvm::SmallVector<char, 0> buffer;
+      llvm::raw_svector_ostream bitcode(buffer);
+      llvm::WriteBitcodeToFile(*module, bitcode);
+      std::string bc_name = temporary_file(name_ + "_", ".bc");
+      {
+        std::ofstream bc_file(bc_name, std::ios_base::binary);
+        bc_file.write(buffer.data(), buffer.size());
+      }
+      cache_put(key, ".bc", bc_name);
+      remove(bc_name.c_str());
+    }
+#endif
+
     llvm::InitializeNativeTarget();
     llvm::InitializeNativeTargetAsmPrinter();
 
@@ -235,6 +266,39 @@ namespace casadi {
     executionEngine_->finalizeObject();
   }
 
+  bool ClangCompiler::load_cached(const std::string& cached) {
+#if LLVM_VERSION_MAJOR >= 7
+    auto buffer = llvm::MemoryBuffer::getFile(cached);
+    if (!buffer) return false;
+    context_ = new llvm::LLVMContext();
+    auto module = llvm::parseBitcodeFile((*buffer)->getMemBufferRef(), *context_);
+    if (!module) {
+      llvm::consumeError(module.takeError());
+      delete context_;
+      context_ = nullptr;
+      return false;
+    }
+    module_ = module->get();
+
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+
+    // Create the JIT.  This takes ownership of the module.
+    std::string ErrStr;
+    executionEngine_ =
+      llvm::EngineBuilder(std::move(*module)).setEngineKind(llvm::EngineKind::JIT)
+      .setErrorStr(&ErrStr).create();
+    if (!executionEngine_) {
+      casadi_error("Could not create ExecutionEngine: " + ErrStr);
+    }
+
+    executionEngine_->finalizeObject();
+    return true;
+#else
+    return false;
+#endif
+  }
+
   signal_t ClangCompiler::get_function(const std::string& symname) {
     llvm::Function* f = module_->getFunction(symname);
     if (f) {
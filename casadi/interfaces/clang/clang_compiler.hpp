@@ -58,6 +58,11 @@
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Support/raw_ostream.h>
 #include <llvm/Support/raw_os_ostream.h>
+#if LLVM_VERSION_MAJOR >= 7
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Support/MemoryBuffer.h>
+#endif
 //#include <llvm/ExecutionEngine/ExecutionEngine.h>
 
 /** \defgroup plugin_Importer_clang Title
@@ -124,6 +129,9 @@ namespace casadi {
     std::vector<std::string> flags_;
 
   protected:
+    // Load a module from bitcode in the cache and create the JIT, false if failed
+    bool load_cached(const std::string& cached);
+
     clang::EmitLLVMOnlyAction* act_;
     llvm::ExecutionEngine* executionEngine_;
     llvm::LLVMContext* context_;
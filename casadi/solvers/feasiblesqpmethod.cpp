@@ -98,6 +98,11 @@ namespace casadi {
       {"lbfgs_memory",
        {OT_INT,
         "Size of L-BFGS memory."}},
+      {"block_bfgs",
+       {OT_BOOL,
+        "With hessian_approximation=limited-memory, detect the block-diagonal structure "
+        "of the Lagrangian Hessian and apply an independent damped BFGS update to each "
+        "diagonal block, without the periodic reset of the dense update [false]."}},
       {"print_header",
        {OT_BOOL,
         "Print the header with problem statistics"}},
@@ -202,6 +207,7 @@ namespace casadi {
     min_iter_ = 0;
     max_iter_ = 50;
     lbfgs_memory_ = 10;
+    block_bfgs_ = false;
     tol_pr_ = 1e-6;
     tol_du_ = 1e-6;
     std::string hessian_approximation = "exact";
@@ -253,6 +259,8 @@ namespace casadi {
 
       } else if (op.first=="lbfgs_memory") {
         lbfgs_memory_ = op.second;
+      } else if (op.first=="block_bfgs") {
+        block_bfgs_ = op.second;
       } else if (op.first=="tol_pr") {
         tol_pr_ = op.second;
       } else if (op.first=="tol_du") {
@@ -348,6 +356,8 @@ namespace casadi {
 
     // Use exact Hessian?
     exact_hessian_ = hessian_approximation =="exact";
+    casadi_assert(!(exact_hessian_ && block_bfgs_),
+      "Option 'block_bfgs' requires hessian_approximation=limited-memory.");
     uout() << "print solve type" << solve_type << std::endl;
     use_sqp_ = solve_type=="SQP";
 
@@ -399,6 +409,10 @@ namespace casadi {
           opts["verbose"] = verbose_;
           Hsp_ = Convexify::setup(convexify_data_, Hsp_, opts);
         }
+      } else if (block_bfgs_) {
+        Hsp_ = hess_l_blocks(bfgs_block_);
+        bfgs_nblocks_ = bfgs_block_.empty() ? 0
+          : *std::max_element(bfgs_block_.begin(), bfgs_block_.end()) + 1;
       } else {
         Hsp_ = Sparsity::dense(nx_, nx_);
       }
@@ -435,7 +449,11 @@ namespace casadi {
 
     // BFGS?
     if (!exact_hessian_) {
-      alloc_w(2*nx_); // casadi_bfgs
+      if (block_bfgs_) {
+        alloc_w(2*nx_ + 3*bfgs_nblocks_); // casadi_bfgs_block
+      } else {
+        alloc_w(2*nx_); // casadi_bfgs
+      }
     }
 
     // Header
@@ -1080,10 +1098,16 @@ int Feasiblesqpmethod::solve(void* mem) const {
             casadi_bfgs_reset(Hsp_, d->Bk);
           } else {
             ScopedTiming tic(m->fstats.at("BFGS"));
-            // Update BFGS
-            if (m->iter_count % lbfgs_memory_ == 0) casadi_bfgs_reset(Hsp_, d->Bk);
             // Update the Hessian approximation
-            casadi_bfgs(Hsp_, d->Bk, d->dx, d->gLag, d->gLag_old, m->w);
+            if (block_bfgs_) {
+              // Damped blockwise updates, no periodic reset
+              casadi_bfgs_block(Hsp_, d->Bk, d->dx, d->gLag, d->gLag_old,
+                bfgs_nblocks_, get_ptr(bfgs_block_), m->w);
+            } else {
+              // Update BFGS
+              if (m->iter_count % lbfgs_memory_ == 0) casadi_bfgs_reset(Hsp_, d->Bk);
+              casadi_bfgs(Hsp_, d->Bk, d->dx, d->gLag, d->gLag_old, m->w);
+            }
           }
 
           // test if initialization is feasible
@@ -1145,10 +1169,16 @@ int Feasiblesqpmethod::solve(void* mem) const {
             casadi_bfgs_reset(Hsp_, d->Bk);
           } else {
             ScopedTiming tic(m->fstats.at("BFGS"));
-            // Update BFGS
-            if (m->iter_count % lbfgs_memory_ == 0) casadi_bfgs_reset(Hsp_, d->Bk);
             // Update the Hessian approximation
-            casadi_bfgs(Hsp_, d->Bk, d->dx, d->gLag, d->gLag_old, m->w);
+            if (block_bfgs_) {
+              // Damped blockwise updates, no periodic reset
+              casadi_bfgs_block(Hsp_, d->Bk, d->dx, d->gLag, d->gLag_old,
+                bfgs_nblocks_, get_ptr(bfgs_block_), m->w);
+            } else {
+              // Update BFGS
+              if (m->iter_count % lbfgs_memory_ == 0) casadi_bfgs_reset(Hsp_, d->Bk);
+              casadi_bfgs(Hsp_, d->Bk, d->dx, d->gLag, d->gLag_old, m->w);
+            }
           }
         }
       }
@@ -2338,7 +2368,7 @@ void Feasiblesqpmethod::codegen_declarations(CodeGenerator& g) const {
   }
 
   Feasiblesqpmethod::Feasiblesqpmethod(DeserializingStream& s) : Nlpsol(s) {
-    int version = s.version("Feasiblesqpmethod", 1, 3);
+    int version = s.version("Feasiblesqpmethod", 1, 4);
     s.unpack("Feasiblesqpmethod::qpsol", qpsol_);
     if (version>=3) {
       s.unpack("Feasiblesqpmethod::qpsol_ela", qpsol_ela_);
@@ -2347,6 +2377,14 @@ void Feasiblesqpmethod::codegen_declarations(CodeGenerator& g) const {
     s.unpack("Feasiblesqpmethod::max_iter", max_iter_);
     s.unpack("Feasiblesqpmethod::min_iter", min_iter_);
     s.unpack("Feasiblesqpmethod::lbfgs_memory", lbfgs_memory_);
+    if (version>=4) {
+      s.unpack("Feasiblesqpmethod::block_bfgs", block_bfgs_);
+      s.unpack("Feasiblesqpmethod::bfgs_block", bfgs_block_);
+      s.unpack("Feasiblesqpmethod::bfgs_nblocks", bfgs_nblocks_);
+    } else {
+      block_bfgs_ = false;
+      bfgs_nblocks_ = 0;
+    }
     s.unpack("Feasiblesqpmethod::tol_pr_", tol_pr_);
     s.unpack("Feasiblesqpmethod::tol_du_", tol_du_);
     s.unpack("Feasiblesqpmethod::print_header", print_header_);
@@ -2406,13 +2444,16 @@ void Feasiblesqpmethod::codegen_declarations(CodeGenerator& g) const {
 
   void Feasiblesqpmethod::serialize_body(SerializingStream &s) const {
     Nlpsol::serialize_body(s);
-    s.version("Feasiblesqpmethod", 3);
+    s.version("Feasiblesqpmethod", 4);
     s.pack("Feasiblesqpmethod::qpsol", qpsol_);
     // s.pack("Feasiblesqpmethod::qpsol_ela", qpsol_ela_);
     s.pack("Feasiblesqpmethod::exact_hessian", exact_hessian_);
     s.pack("Feasiblesqpmethod::max_iter", max_iter_);
     s.pack("Feasiblesqpmethod::min_iter", min_iter_);
     s.pack("Feasiblesqpmethod::lbfgs_memory", lbfgs_memory_);
+    s.pack("Feasiblesqpmethod::block_bfgs", block_bfgs_);
+    s.pack("Feasiblesqpmethod::bfgs_block", bfgs_block_);
+    s.pack("Feasiblesqpmethod::bfgs_nblocks", bfgs_nblocks_);
     s.pack("Feasiblesqpmethod::tol_pr_", tol_pr_);
     s.pack("Feasiblesqpmethod::tol_du_", tol_du_);
     s.pack("Feasiblesqpmethod::print_header", print_header_);
@@ -150,6 +150,13 @@ namespace casadi {
     /// Memory size of L-BFGS method
     casadi_int lbfgs_memory_;
 
+    /// Blockwise BFGS updates
+    bool block_bfgs_;
+
+    /// Block index of each variable, number of blocks for blockwise BFGS
+    std::vector<casadi_int> bfgs_block_;
+    casadi_int bfgs_nblocks_;
+
     // Memory size of Anderson acceleration
     casadi_int sz_anderson_memory_;
 
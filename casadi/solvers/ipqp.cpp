@@ -64,6 +64,10 @@ namespace casadi {
      {{"max_iter",
        {OT_INT,
         "Maximum number of iterations [1000]."}},
+      {"max_corrections",
+       {OT_INT,
+        "Maximum number of Gondzio centrality corrections per iteration, "
+        "each reusing the KKT factorization for an additional solve [0]."}},
       {"constr_viol_tol",
        {OT_DOUBLE,
         "Constraint violation tolerance [1e-8]."}},
@@ -107,6 +111,8 @@ namespace casadi {
     for (auto&& op : opts) {
       if (op.first=="max_iter") {
         p_.max_iter = op.second;
+      } else if (op.first=="max_corrections") {
+        p_.max_corr = op.second;
       } else if (op.first=="pr_tol") {
         p_.pr_tol = op.second;
       } else if (op.first=="du_tol") {
@@ -131,7 +137,7 @@ namespace casadi {
     alloc_w(casadi_ipqp_sz_w(&p_), true);
     // Memory for KKT formation
     alloc_w(kkt_.nnz(), true);
-    alloc_iw(A_.size2());
+    alloc_iw(na_);
     alloc_w(nx_ + na_);
     // KKT solver
     linsol_ = Linsol("linsol", linear_solver_, kkt_, linear_solver_options_);
@@ -156,6 +162,7 @@ namespace casadi {
     if (Conic::init_mem(mem)) return 1;
     auto m = static_cast<IpqpMemory*>(mem);
     m->return_status = "";
+    m->n_fact = m->n_solve = 0;
     return 0;
   }
 
@@ -175,6 +182,7 @@ namespace casadi {
     casadi_ipqp_bounds(&d, arg[CONIC_G],
       arg[CONIC_LBX], arg[CONIC_UBX], arg[CONIC_LBA], arg[CONIC_UBA]);
     casadi_ipqp_guess(&d, arg[CONIC_X0], arg[CONIC_LAM_X0], arg[CONIC_LAM_A0]);
+    m->n_fact = m->n_solve = 0;
     // Reverse communication loop
     while (casadi_ipqp(&d)) {
       switch (d.task) {
@@ -204,11 +212,13 @@ namespace casadi {
         casadi_kkt(kkt_, nz_kkt, H_, arg[CONIC_H], A_, arg[CONIC_A],
           d.S, d.D, w, iw);
         // Factorize KKT
+        m->n_fact++;
         if (linsol_.nfact(nz_kkt, linsol_mem))
           d.status = IPQP_FACTOR_ERROR;
         break;
       case IPQP_SOLVE:
         // Solve KKT
+        m->n_solve++;
         if (linsol_.solve(nz_kkt, d.linsys, 1, false, linsol_mem))
           d.status = IPQP_SOLVE_ERROR;
         break;
@@ -226,6 +236,7 @@ namespace casadi {
       *res[CONIC_COST] = .5 * casadi_bilin(arg[CONIC_H], H_, d.z, d.z)
         + casadi_dot(p_.nx, d.z, d.g);
     }
+    m->d_qp.iter_count = d.iter;
     // Return
     if (verbose_) casadi_warning(m->return_status);
     m->d_qp.success = d.status == IPQP_SUCCESS;
@@ -236,11 +247,13 @@ namespace casadi {
     Dict stats = Conic::get_stats(mem);
     auto m = static_cast<IpqpMemory*>(mem);
     stats["return_status"] = m->return_status;
+    stats["n_factorizations"] = m->n_fact;
+    stats["n_solves"] = m->n_solve;
     return stats;
   }
 
   Ipqp::Ipqp(DeserializingStream& s) : Conic(s) {
-    s.version("Ipqp", 1);
+    int version = s.version("Ipqp", 1, 2);
     s.unpack("Ipqp::kkt", kkt_);
     s.unpack("Ipqp::print_iter", print_iter_);
     s.unpack("Ipqp::print_header", print_header_);
@@ -253,12 +266,13 @@ namespace casadi {
     s.unpack("Ipqp::du_tol", p_.du_tol);
     s.unpack("Ipqp::co_tol", p_.co_tol);
     s.unpack("Ipqp::mu_tol", p_.mu_tol);
+    if (version >= 2) s.unpack("Ipqp::max_corr", p_.max_corr);
   }
 
   void Ipqp::serialize_body(SerializingStream &s) const {
     Conic::serialize_body(s);
 
-    s.version("Ipqp", 1);
+    s.version("Ipqp", 2);
     s.pack("Ipqp::kkt", kkt_);
     s.pack("Ipqp::print_iter", print_iter_);
     s.pack("Ipqp::print_header", print_header_);
@@ -270,6 +284,7 @@ namespace casadi {
     s.pack("Ipqp::du_tol", p_.du_tol);
     s.pack("Ipqp::co_tol", p_.co_tol);
     s.pack("Ipqp::mu_tol", p_.mu_tol);
+    s.pack("Ipqp::max_corr", p_.max_corr);
   }
 
 } // namespace casadi
@@ -43,6 +43,8 @@
 namespace casadi {
   struct CASADI_CONIC_IPQP_EXPORT IpqpMemory : public ConicMemory {
     const char* return_status;
+    // Number of KKT factorizations and solves
+    casadi_int n_fact, n_solve;
   };
 
   /** \brief \pluginbrief{Conic,ipqp}
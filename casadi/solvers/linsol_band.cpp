@@ -0,0 +1,296 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#include "linsol_band.hpp"
+#include "casadi/core/global_options.hpp"
+
+namespace casadi {
+
+  extern "C"
+  int CASADI_LINSOL_BAND_EXPORT
+  casadi_register_linsol_band(LinsolInternal::Plugin* plugin) {
+    plugin->creator = LinsolBand::creator;
+    plugin->name = "band";
+    plugin->doc = LinsolBand::meta_doc.c_str();
+    plugin->version = CASADI_VERSION;
+    plugin->options = &LinsolBand::options_;
+    plugin->deserialize = &LinsolBand::deserialize;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_LINSOL_BAND_EXPORT casadi_load_linsol_band() {
+    LinsolInternal::registerPlugin(casadi_register_linsol_band);
+  }
+
+  LinsolBand::LinsolBand(const std::string& name, const Sparsity& sp)
+    : LinsolInternal(name, sp) {
+  }
+
+  LinsolBand::~LinsolBand() {
+    clear_mem();
+  }
+
+  const Options LinsolBand::options_
+  = {{&ProtoFunction::options_},
+     {{"border_degree",
+      {OT_INT,
+       "Rows and columns with more off-diagonal entries than this are moved to the "
+       "dense border. Default: 3*sqrt(n)"}}
+     }
+  };
+
+  void LinsolBand::init(const Dict& opts) {
+    // Call the init method of the base class
+    LinsolInternal::init(opts);
+
+    // Default options
+    casadi_int border_degree = static_cast<casadi_int>(3*std::sqrt(nrow()));
+
+    // Read user options
+    for (auto&& op : opts) {
+      if (op.first=="border_degree") {
+        border_degree = op.second;
+      }
+    }
+
+    // Symbolic factorization, shared with other instances if possible
+    bp_ = static_cast<const LinsolBandSymbolic&>(symbolic_cached(str(border_degree), [&]() {
+      auto sym = new LinsolBandSymbolic();
+      sym->bp = band_structure(sp_, border_degree);
+      return sym;
+    })).bp;
+    if (verbose_) {
+      casadi_message("Band structure: " + str(bp_[1]) + " border rows, "
+        + str(bp_[2]) + " subdiagonals, " + str(bp_[3]) + " superdiagonals");
+    }
+  }
+
+  std::vector<casadi_int> LinsolBand::band_structure(const Sparsity& sp,
+      casadi_int border_degree) {
+    casadi_assert(sp.is_square(), "Matrix must be square");
+    casadi_int n = sp.size2();
+    // Symmetrized pattern
+    Sparsity sp_sym = sp + sp.T();
+    const casadi_int *colind = sp_sym.colind(), *row = sp_sym.row();
+    // Rows and columns with few off-diagonal entries form the banded part
+    std::vector<bool> keep(n);
+    for (casadi_int c=0; c<n; ++c) {
+      casadi_int deg = 0;
+      for (casadi_int k=colind[c]; k<colind[c+1]; ++k) if (row[k]!=c) deg++;
+      keep[c] = deg <= border_degree;
+    }
+    // Bandwidths of the banded part for a given ordering
+    const casadi_int *a_colind = sp.colind(), *a_row = sp.row();
+    std::vector<casadi_int> pinv(n, -1);
+    auto bandwidths = [&](const std::vector<casadi_int>& order,
+                          casadi_int& kl, casadi_int& ku) {
+      for (casadi_int i=0; i<order.size(); ++i) pinv[order[i]] = i;
+      kl = ku = 0;
+      for (casadi_int c : order) {
+        for (casadi_int k=a_colind[c]; k<a_colind[c+1]; ++k) {
+          if (!keep[a_row[k]]) continue;
+          casadi_int d = pinv[a_row[k]] - pinv[c];
+          kl = std::max(kl, d);
+          ku = std::max(ku, -d);
+        }
+      }
+    };
+    // Natural ordering
+    std::vector<casadi_int> order;
+    for (casadi_int c=0; c<n; ++c) if (keep[c]) order.push_back(c);
+    casadi_int kl, ku;
+    bandwidths(order, kl, ku);
+    // Reverse Cuthill-McKee ordering, if it reduces the storage
+    std::vector<casadi_int> order_rcm = rcm(sp_sym, keep);
+    casadi_int kl_rcm, ku_rcm;
+    bandwidths(order_rcm, kl_rcm, ku_rcm);
+    if (2*kl_rcm+ku_rcm < 2*kl+ku) {
+      order = order_rcm;
+      kl = kl_rcm;
+      ku = ku_rcm;
+    }
+    // Border last
+    casadi_int m = order.size();
+    for (casadi_int c=0; c<n; ++c) if (!keep[c]) order.push_back(c);
+    for (casadi_int i=0; i<n; ++i) pinv[order[i]] = i;
+    // Assemble
+    std::vector<casadi_int> ret = {n, n-m, kl, ku};
+    ret.insert(ret.end(), pinv.begin(), pinv.end());
+    return ret;
+  }
+
+  std::vector<casadi_int> LinsolBand::rcm(const Sparsity& sp, const std::vector<bool>& keep) {
+    casadi_int n = sp.size2();
+    const casadi_int *colind = sp.colind(), *row = sp.row();
+    // Degrees in the subgraph
+    std::vector<casadi_int> deg(n, 0);
+    for (casadi_int c=0; c<n; ++c) {
+      if (!keep[c]) continue;
+      for (casadi_int k=colind[c]; k<colind[c+1]; ++k) {
+        if (row[k]!=c && keep[row[k]]) deg[c]++;
+      }
+    }
+    auto by_degree = [&](casadi_int i, casadi_int j) { return deg[i]<deg[j];};
+    // Breadth-first search, returns the number of levels
+    std::vector<casadi_int> q, mark(n, -1);
+    casadi_int stamp = 0;
+    auto bfs = [&](casadi_int start, casadi_int& last_level) {
+      q.clear();
+      q.push_back(start);
+      mark[start] = stamp;
+      casadi_int nlevel = 0, head = 0;
+      while (head<q.size()) {
+        last_level = head;
+        casadi_int tail = q.size();
+        for (; head<tail; ++head) {
+          casadi_int c = q[head];
+          for (casadi_int k=colind[c]; k<colind[c+1]; ++k) {
+            casadi_int r = row[k];
+            if (keep[r] && mark[r]!=stamp) {
+              mark[r] = stamp;
+              q.push_back(r);
+            }
+          }
+        }
+        nlevel++;
+      }
+      stamp++;
+      return nlevel;
+    };
+    // Start each connected component from a node of minimal degree
+    std::vector<casadi_int> nodes;
+    for (casadi_int c=0; c<n; ++c) if (keep[c]) nodes.push_back(c);
+    std::stable_sort(nodes.begin(), nodes.end(), by_degree);
+    std::vector<bool> visited(n, false);
+    std::vector<casadi_int> order, nbr;
+    for (casadi_int s : nodes) {
+      if (visited[s]) continue;
+      // Pseudo-peripheral node (George and Liu)
+      casadi_int start = s, last_level, nlevel = bfs(start, last_level);
+      for (casadi_int iter=0; iter<8; ++iter) {
+        casadi_int cand = *std::min_element(q.begin()+last_level, q.end(), by_degree);
+        casadi_int cand_last_level, cand_nlevel = bfs(cand, cand_last_level);
+        if (cand_nlevel<=nlevel) break;
+        start = cand;
+        nlevel = cand_nlevel;
+        last_level = cand_last_level;
+      }
+      // Cuthill-McKee: neighbors in order of increasing degree
+      casadi_int head = order.size();
+      order.push_back(start);
+      visited[start] = true;
+      for (; head<order.size(); ++head) {
+        casadi_int c = order[head];
+        nbr.clear();
+        for (casadi_int k=colind[c]; k<colind[c+1]; ++k) {
+          casadi_int r = row[k];
+          if (keep[r] && !visited[r]) {
+            visited[r] = true;
+            nbr.push_back(r);
+          }
+        }
+        std::stable_sort(nbr.begin(), nbr.end(), by_degree);
+        order.insert(order.end(), nbr.begin(), nbr.end());
+      }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+  }
+
+  casadi_int LinsolBand::sz_iw() const {
+    return nrow();
+  }
+
+  casadi_int LinsolBand::sz_w() const {
+    casadi_int n = bp_[0], nb = bp_[1], kl = bp_[2], ku = bp_[3], m = n-nb;
+    // Band of the leading block, border blocks, Schur complement and a permuted vector
+    return (2*kl+ku+1)*m + 2*m*nb + (nb>0 ? 3*nb-2 : 0)*nb + n;
+  }
+
+  int LinsolBand::init_mem(void* mem) const {
+    if (LinsolInternal::init_mem(mem)) return 1;
+    auto m = static_cast<LinsolBandMemory*>(mem);
+
+    // Work vectors
+    m->w.resize(sz_w());
+    m->iw.resize(sz_iw());
+    return 0;
+  }
+
+  int LinsolBand::sfact(void* mem, const double* A) const {
+    return 0;
+  }
+
+  int LinsolBand::nfact(void* mem, const double* A) const {
+    auto m = static_cast<LinsolBandMemory*>(mem);
+    if (casadi_band_fact(sp_, A, get_ptr(bp_), get_ptr(m->iw), get_ptr(m->w))) {
+      if (verbose_) casadi_message("Singular matrix");
+      return 1;
+    }
+    return 0;
+  }
+
+  int LinsolBand::solve(void* mem, const double* A, double* x, casadi_int nrhs, bool tr) const {
+    auto m = static_cast<LinsolBandMemory*>(mem);
+    casadi_band_solve(x, nrhs, tr, get_ptr(bp_), get_ptr(m->iw), get_ptr(m->w));
+    return 0;
+  }
+
+  void LinsolBand::generate(CodeGenerator& g, const std::string& A, const std::string& x,
+                          casadi_int nrhs, bool tr) const {
+    // Codegen the integer vectors
+    std::string sp = g.sparsity(sp_);
+    std::string bp = g.constant(bp_);
+
+    // Place in block to avoid conflicts caused by local variables
+    g << "{\n";
+    g.comment("FIXME(@jaeandersson): Memory allocation can be avoided");
+    g << "casadi_real w[" << sz_w() << "];\n";
+    g << "casadi_int iw[" << sz_iw() << "];\n";
+
+    // Factorize
+    g << g.band_fact(sp, A, bp, "iw", "w") << "\n";
+
+    // Solve
+    g << g.band_solve(x, nrhs, tr, bp, "iw", "w") << "\n";
+
+    // End of block
+    g << "}\n";
+  }
+
+  LinsolBand::LinsolBand(DeserializingStream& s) : LinsolInternal(s) {
+    s.version("LinsolBand", 1);
+    s.unpack("LinsolBand::bp", bp_);
+  }
+
+  void LinsolBand::serialize_body(SerializingStream &s) const {
+    LinsolInternal::serialize_body(s);
+    s.version("LinsolBand", 1);
+    s.pack("LinsolBand::bp", bp_);
+  }
+
+} // namespace casadi
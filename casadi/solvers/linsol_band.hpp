@@ -0,0 +1,152 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#ifndef CASADI_LINSOL_BAND_HPP
+#define CASADI_LINSOL_BAND_HPP
+
+/** \defgroup plugin_Linsol_band Title
+    \par
+
+  * Linear solver for banded matrices with a dense border, as arising from
+  * multiple shooting and collocation discretizations of optimal control problems.
+  * The matrix is reordered to a band (reverse Cuthill-McKee) with rows and columns
+  * coupling to many others, e.g. parameters or a free end time, moved to a border.
+  * The band is factorized stage by stage with partial pivoting, the border with
+  * a dense Schur complement.
+
+    \identifier{28n} */
+
+/** \pluginsection{Linsol,band} */
+
+/// \cond INTERNAL
+#include "casadi/core/linsol_internal.hpp"
+#include <casadi/solvers/casadi_linsol_band_export.h>
+
+namespace casadi {
+  struct CASADI_LINSOL_BAND_EXPORT LinsolBandMemory : public LinsolMemory {
+    std::vector<double> w;
+    std::vector<casadi_int> iw;
+  };
+
+  /** \brief Symbolic factorization, cf. LinsolBand */
+  struct CASADI_LINSOL_BAND_EXPORT LinsolBandSymbolic : public LinsolSymbolic {
+    std::vector<casadi_int> bp;
+  };
+
+  /** \brief \pluginbrief{LinsolInternal,band}
+   * @copydoc LinsolInternal_doc
+   * @copydoc plugin_LinsolInternal_band
+   */
+  class CASADI_LINSOL_BAND_EXPORT LinsolBand : public LinsolInternal {
+  public:
+
+    // Create a linear solver given a sparsity pattern and a number of right hand sides
+    LinsolBand(const std::string& name, const Sparsity& sp);
+
+    /** \brief  Create a new LinsolInternal */
+    static LinsolInternal* creator(const std::string& name, const Sparsity& sp) {
+      return new LinsolBand(name, sp);
+    }
+
+    // Destructor
+    ~LinsolBand() override;
+
+    ///@{
+    /** \brief Options */
+    static const Options options_;
+    const Options& get_options() const override { return options_;}
+    ///@}
+
+    // Initialize the solver
+    void init(const Dict& opts) override;
+
+    /** \brief Create memory block */
+    void* alloc_mem() const override { return new LinsolBandMemory();}
+
+    /** \brief Initalize memory block */
+    int init_mem(void* mem) const override;
+
+    /** \brief Free memory block */
+    void free_mem(void *mem) const override { delete static_cast<LinsolBandMemory*>(mem);}
+
+    // Symbolic factorization
+    int sfact(void* mem, const double* A) const override;
+
+    // Factorize the linear system
+    int nfact(void* mem, const double* A) const override;
+
+    // Solve the linear system
+    int solve(void* mem, const double* A, double* x, casadi_int nrhs, bool tr) const override;
+
+    /// Generate C code
+    void generate(CodeGenerator& g, const std::string& A, const std::string& x,
+                  casadi_int nrhs, bool tr) const override;
+
+    /// A documentation string
+    static const std::string meta_doc;
+
+    // Get name of the plugin
+    const char* plugin_name() const override { return "band";}
+
+    // Get name of the class
+    std::string class_name() const override { return "LinsolBand";}
+
+    /** \brief Band structure, cf. casadi_band_fact
+
+        Rows and columns with more than \a border_degree off-diagonal entries
+        in the symmetrized pattern are moved to the border, the remaining ones
+        are ordered to minimize the bandwidth.
+    */
+    static std::vector<casadi_int> band_structure(const Sparsity& sp, casadi_int border_degree);
+
+    /// Reverse Cuthill-McKee ordering of the subgraph of the nodes marked in \a keep
+    static std::vector<casadi_int> rcm(const Sparsity& sp, const std::vector<bool>& keep);
+
+    /// Length of the integer work vector
+    casadi_int sz_iw() const;
+
+    /// Length of the real work vector
+    casadi_int sz_w() const;
+
+    // Band structure: n, nb, kl, ku, pinv
+    std::vector<casadi_int> bp_;
+
+    /** \brief Serialize an object without type information */
+    void serialize_body(SerializingStream &s) const override;
+
+    /** \brief Deserialize with type disambiguation */
+    static ProtoFunction* deserialize(DeserializingStream& s) { return new LinsolBand(s); }
+
+  protected:
+    /** \brief Deserializing constructor */
+    explicit LinsolBand(DeserializingStream& s);
+  };
+
+} // namespace casadi
+
+/// \endcond
+
+#endif // CASADI_LINSOL_BAND_HPP
@@ -0,0 +1,68 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+      #include "linsol_band.hpp"
+      #include <string>
+
+      const std::string casadi::LinsolBand::meta_doc=
+      "\n"
+"Linear solver for banded matrices with a dense border, as arising from\n"
+"multiple shooting and collocation discretizations of optimal control\n"
+"problems.\n"
+"\n"
+"Rows and columns with more off-diagonal entries than border_degree in the\n"
+"symmetrized sparsity pattern, e.g. those of parameters or a free end time,\n"
+"are moved last and form the dense border. The remaining leading block is\n"
+"ordered for a small bandwidth, using reverse Cuthill-McKee if it reduces\n"
+"the storage over the natural ordering, and stored as a band with kl\n"
+"subdiagonals and ku superdiagonals, plus kl extra superdiagonals for the\n"
+"fill-in due to row interchanges.\n"
+"\n"
+"The band is factorized with partial pivoting, in O(n*kl*(kl+ku)) operations.\n"
+"The border is eliminated with a dense LU factorization of its Schur\n"
+"complement. The ordering depends only on the sparsity pattern and is\n"
+"shared among instances, cf. Linsol.\n"
+"\n"
+"\n"
+">List of available options\n"
+"\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"|        Id       |       Type      |     Default     |   Description   |\n"
+"+=================+=================+=================+=================+\n"
+"| border_degree   | OT_INT          | 3*sqrt(n)       | Rows and        |\n"
+"|                 |                 |                 | columns with    |\n"
+"|                 |                 |                 | more off-       |\n"
+"|                 |                 |                 | diagonal        |\n"
+"|                 |                 |                 | entries than    |\n"
+"|                 |                 |                 | this are moved  |\n"
+"|                 |                 |                 | to the dense    |\n"
+"|                 |                 |                 | border.         |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"\n"
+"\n"
+"\n"
+"\n"
+;
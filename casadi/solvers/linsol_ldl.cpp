@@ -25,6 +25,7 @@
 
 #include "linsol_ldl.hpp"
 #include "casadi/core/global_options.hpp"
+#include "casadi/core/thread_pool.hpp"
 
 namespace casadi {
 
@@ -60,7 +61,17 @@ namespace casadi {
        "Incomplete factorization, without any fill-in"}},
       {"preordering",
        {OT_BOOL,
-       "Approximate minimal degree (AMD) preordering"}}
+       "Approximate minimal degree (AMD) preordering"}},
+      {"supernodal",
+       {OT_BOOL,
+       "Factorize supernodes, i.e. groups of columns of L with (nearly) the same "
+       "sparsity pattern, with dense kernels. Not for incomplete factorizations. "
+       "Default: only if the average supernode has at least 8 columns"}},
+      {"max_threads",
+       {OT_INT,
+       "Maximum number of threads for the numeric factorization, which is then "
+       "parallelized over independent subtrees of the elimination tree using the "
+       "CasADi thread pool. Not for incomplete factorizations [1]"}}
      }
   };
 
@@ -71,32 +82,182 @@ namespace casadi {
     // Default options
     incomplete_ = false;
     amd_ = true;
+    casadi_int supernodal = -1;
+    max_threads_ = 1;
 
     // Read user options
     for (auto&& op : opts) {
       if (op.first=="incomplete") {
         incomplete_ = op.second;
-      } else if (op.first=="amd") {
+      } else if (op.first=="preordering") {
         amd_ = op.second;
+      } else if (op.first=="supernodal") {
+        supernodal = op.second.to_bool();
+      } else if (op.first=="max_threads") {
+        max_threads_ = op.second;
       }
     }
 
-    // Symbolic factorization
+    // Symbolic factorization, shared with other instances if possible
+    const auto& sym = static_cast<const LinsolLdlSymbolic&>(symbolic_cached(
+      str(std::vector<casadi_int>{incomplete_, amd_, supernodal, max_threads_}),
+      [&]() { return symbolic(supernodal);}));
+    p_ = sym.p;
+    sp_Lt_ = sym.sp_Lt;
+    sn_ = sym.sn;
+    task_ptr_ = sym.task_ptr;
+    subtrees_ = sym.subtrees;
+    top_ = sym.top;
+    if (verbose_ && !task_ptr_.empty()) {
+      casadi_message("Tree-parallel factorization with " + str(ntask()) + " tasks, "
+        + str(subtrees_.size()/2) + " subtrees");
+    }
+  }
+
+  LinsolSymbolic* LinsolLdl::symbolic(casadi_int supernodal) const {
+    auto sym = new LinsolLdlSymbolic();
+    std::vector<casadi_int>& p = sym->p;
+    Sparsity& sp_Lt = sym->sp_Lt;
+    std::vector<casadi_int>& sn = sym->sn;
     if (incomplete_) {
       if (amd_) {
         // Incomplete LDL^T, AMD permutation
-        p_ = sp_.amd();
+        p = sp_.amd();
         std::vector<casadi_int> tmp;
-        Sparsity Aperm = sp_.sub(p_, p_, tmp);
-        sp_Lt_ = triu(Aperm, false);  // no fill-in
+        Sparsity Aperm = sp_.sub(p, p, tmp);
+        sp_Lt = triu(Aperm, false);  // no fill-in
       } else {
-        p_ = range(sp_.size1());  // no reordering
-        sp_Lt_ = triu(sp_, false);  // no fill-in
+        p = range(sp_.size1());  // no reordering
+        sp_Lt = triu(sp_, false);  // no fill-in
       }
     } else {
       // Regular LDL^T
-      sp_Lt_ = sp_.ldl(p_, amd_);
+      sp_Lt = sp_.ldl(p, amd_);
+      // Postorder the elimination tree, making subtrees contiguous
+      if (max_threads_>1) {
+        std::vector<casadi_int> post = postorder(sp_Lt.etree());
+        if (post!=range(nrow())) {
+          std::vector<casadi_int> tmp;
+          sp_Lt = sp_Lt.sub(post, post, tmp);
+          p = vector_slice(p, post);
+        }
+      }
+    }
+
+    // Supernodal partition
+    if (supernodal!=0 && !incomplete_) {
+      Sparsity sp_Lt_relaxed;
+      std::vector<casadi_int> sn_relaxed = supernodes(sp_Lt, sp_Lt_relaxed);
+      // By default, only when the supernodes are large enough to pay off
+      if (supernodal==1 || sn_relaxed[1]*8 <= nrow()) {
+        sn = sn_relaxed;
+        sp_Lt = sp_Lt_relaxed;
+      }
+    }
+
+    // Partition for a tree-parallel factorization
+    if (max_threads_>1 && !incomplete_) {
+      std::vector<casadi_int> parent;
+      std::vector<double> cost;
+      const casadi_int *lt_colind = sp_Lt.colind(), *lt_row = sp_Lt.row();
+      if (sn.empty()) {
+        // Calculating row c of L requires the rows of L in its pattern
+        parent = sp_Lt.etree();
+        cost.resize(nrow(), 1);
+        for (casadi_int c=0; c<nrow(); ++c) {
+          for (casadi_int k=lt_colind[c]; k<lt_colind[c+1]; ++k) {
+            casadi_int r = lt_row[k];
+            cost[c] += 2*(lt_colind[r+1]-lt_colind[r]) + 2;
+          }
+        }
+      } else {
+        // Supernodal elimination tree, dense updates to and factorization of each panel
+        casadi_int nsuper = sn[1];
+        const casadi_int *super = get_ptr(sn)+2, *rptr = super+nsuper+1,
+          *colsup = rptr+2*(nsuper+1), *srow = colsup+nrow();
+        parent.resize(nsuper);
+        cost.resize(nsuper);
+        for (casadi_int s=0; s<nsuper; ++s) {
+          casadi_int nc = super[s+1]-super[s], nr = rptr[s+1]-rptr[s];
+          parent[s] = nc<nr ? colsup[srow[rptr[s]+nc]] : -1;
+          cost[s] = static_cast<double>(nc)*nr*nr;
+        }
+      }
+      tree_partition(parent, cost, max_threads_, sym->task_ptr, sym->subtrees, sym->top);
+    }
+    return sym;
+  }
+
+  std::vector<casadi_int> LinsolLdl::supernodes(const Sparsity& sp_Lt, Sparsity& sp_Lt_relaxed) {
+    casadi_int n = sp_Lt.size2();
+    // Strictly lower entries of L
+    Sparsity sp_L = sp_Lt.T();
+    const casadi_int *colind = sp_L.colind(), *row = sp_L.row();
+    // Relaxed supernodes: column j joins column j-1 if it is its parent in the
+    // elimination tree, as long as the fraction of explicit zeros remains small
+    std::vector<casadi_int> super(1, 0);
+    casadi_int w = 1, h = n>0 ? colind[1]-colind[0] : 0, z = 0;
+    for (casadi_int j=1; j<n; ++j) {
+      casadi_int h_new = colind[j+1]-colind[j];
+      if (h>0 && row[colind[j-1]]==j) {
+        // Zeros and total number of entries below the diagonal after merging
+        casadi_int z_new = z + w*(1+h_new-h);
+        casadi_int tot = (w+1)*w/2 + (w+1)*h_new;
+        double frac = tot==0 ? 0 : z_new/static_cast<double>(tot);
+        if ((w<4 && frac<=0.5) || (w<16 && frac<=0.2) || (w<48 && frac<=0.1) || frac<=0.05) {
+          w++;
+          h = h_new;
+          z = z_new;
+          continue;
+        }
+      }
+      super.push_back(j);
+      w = 1;
+      h = h_new;
+      z = 0;
     }
+    if (n>0) super.push_back(n);
+    casadi_int nsuper = super.size()-1;
+    // Row indices, panel offsets and supernode of each column
+    std::vector<casadi_int> rptr(1, 0), pptr(1, 0), colsup(n), srow;
+    // Sparsity pattern of L, including the explicit zeros
+    std::vector<casadi_int> L_colind(1, 0), L_row;
+    for (casadi_int s=0; s<nsuper; ++s) {
+      casadi_int f = super[s], l = super[s+1];
+      for (casadi_int j=f; j<l; ++j) {
+        colsup[j] = s;
+        srow.push_back(j);
+      }
+      srow.insert(srow.end(), row+colind[l-1], row+colind[l]);
+      rptr.push_back(srow.size());
+      pptr.push_back(pptr.back() + (rptr[s+1]-rptr[s])*(l-f));
+      for (casadi_int j=f; j<l; ++j) {
+        L_row.insert(L_row.end(), srow.begin()+rptr[s]+(j-f)+1, srow.end());
+        L_colind.push_back(L_row.size());
+      }
+    }
+    sp_Lt_relaxed = Sparsity(n, n, L_colind, L_row).T();
+    // Assemble
+    std::vector<casadi_int> ret = {n, nsuper};
+    ret.insert(ret.end(), super.begin(), super.end());
+    ret.insert(ret.end(), rptr.begin(), rptr.end());
+    ret.insert(ret.end(), pptr.begin(), pptr.end());
+    ret.insert(ret.end(), colsup.begin(), colsup.end());
+    ret.insert(ret.end(), srow.begin(), srow.end());
+    return ret;
+  }
+
+  casadi_int LinsolLdl::sz_iw(casadi_int ntask) const {
+    if (sn_.empty()) return 0;
+    // Shared linked lists, followed by a private vector of length n for each task
+    return 3*sn_[1] + ntask*nrow();
+  }
+
+  casadi_int LinsolLdl::sz_w(casadi_int ntask) const {
+    if (sn_.empty()) return nrow();
+    // Dense panels, followed by eight private vectors of length n for each task
+    casadi_int nsuper = sn_[1];
+    return sn_[2+3*(nsuper+1)-1] + ntask*8*nrow();
   }
 
   int LinsolLdl::init_mem(void* mem) const {
@@ -107,27 +268,96 @@ namespace casadi {
     casadi_int nrow = this->nrow();
     m->d.resize(nrow);
     m->l.resize(sp_Lt_.nnz());
-    m->w.resize(nrow);
+    m->w.resize(std::max(sz_w(ntask()), max_nrhs_block*nrow));
+    m->iw.resize(sz_iw(ntask()));
+    m->nfact_parallel = 0;
 
     return 0;
   }
 
+  Dict LinsolLdl::get_stats(void* mem) const {
+    Dict stats = LinsolInternal::get_stats(mem);
+    auto m = static_cast<LinsolLdlMemory*>(mem);
+    stats["n_task"] = ntask();
+    stats["nfact_parallel"] = m->nfact_parallel;
+    return stats;
+  }
+
   int LinsolLdl::sfact(void* mem, const double* A) const {
     return 0;
   }
 
   int LinsolLdl::nfact(void* mem, const double* A) const {
     auto m = static_cast<LinsolLdlMemory*>(mem);
-    casadi_ldl(sp_, A, sp_Lt_, get_ptr(m->l), get_ptr(m->d), get_ptr(p_), get_ptr(m->w));
+    if (!task_ptr_.empty()) {
+      nfact_parallel(m, A);
+      m->nfact_parallel++;
+    } else if (sn_.empty()) {
+      casadi_ldl(sp_, A, sp_Lt_, get_ptr(m->l), get_ptr(m->d), get_ptr(p_), get_ptr(m->w));
+    } else {
+      casadi_ldl_super(sp_, A, get_ptr(sn_), sp_Lt_, get_ptr(m->l), get_ptr(m->d),
+        get_ptr(p_), get_ptr(m->iw), get_ptr(m->w));
+    }
     for (double d : m->d) {
       if (d==0) casadi_warning("LDL factorization has zeros in D");
     }
     return 0;
   }
 
+  void LinsolLdl::nfact_parallel(LinsolLdlMemory* m, const double* A) const {
+    double *l = get_ptr(m->l), *d = get_ptr(m->d), *w = get_ptr(m->w);
+    casadi_int *iw = get_ptr(m->iw);
+    if (sn_.empty()) {
+      // Subtrees in parallel, sharing the work vector
+      casadi_ldl_copy(sp_, A, sp_Lt_, l, d, get_ptr(p_), w);
+      ThreadPool::instance().run(ntask(), [&](casadi_int t) {
+        for (casadi_int k=task_ptr_[t]; k<task_ptr_[t+1]; ++k) {
+          casadi_ldl_cols(sp_Lt_, l, d, w, subtrees_[2*k], subtrees_[2*k+1]);
+        }
+        return 0;
+      }, 1);
+      // Their ancestors serially
+      for (casadi_int k=0; k<top_.size(); k+=2) {
+        casadi_ldl_cols(sp_Lt_, l, d, w, top_[k], top_[k+1]);
+      }
+    } else {
+      const casadi_int *sn = get_ptr(sn_);
+      casadi_int n = nrow(), nsuper = sn_[1];
+      // Private work vectors of each task
+      casadi_int *iw2 = iw + 3*nsuper;
+      double *w2 = w + sn_[2+3*(nsuper+1)-1];
+      std::fill(iw, iw+nsuper, -1);
+      // Subtrees in parallel, deferring updates to their ancestors
+      ThreadPool::instance().run(ntask(), [&](casadi_int t) {
+        std::fill(w2+t*8*n, w2+(t+1)*8*n, 0.);
+        for (casadi_int k=task_ptr_[t]; k<task_ptr_[t+1]; ++k) {
+          casadi_int s0 = subtrees_[2*k], s1 = subtrees_[2*k+1];
+          casadi_ldl_super_range(sp_, A, sn, get_ptr(p_), s0, s1, s1, iw, w,
+            iw2+t*n, w2+t*8*n);
+        }
+        return 0;
+      }, 1);
+      for (casadi_int k=0; k<subtrees_.size(); k+=2) {
+        casadi_ldl_super_link(sn, subtrees_[k], subtrees_[k+1], iw);
+      }
+      // Their ancestors serially
+      for (casadi_int k=0; k<top_.size(); k+=2) {
+        casadi_ldl_super_range(sp_, A, sn, get_ptr(p_), top_[k], top_[k+1], nsuper, iw, w,
+          iw2, w2);
+      }
+      casadi_ldl_super_copy(sn, sp_Lt_, l, d, w, iw2);
+    }
+  }
+
   int LinsolLdl::solve(void* mem, const double* A, double* x, casadi_int nrhs, bool tr) const {
     auto m = static_cast<LinsolLdlMemory*>(mem);
-    casadi_ldl_solve(x, nrhs, sp_Lt_, get_ptr(m->l), get_ptr(m->d), get_ptr(p_), get_ptr(m->w));
+    if (nrhs>1) {
+      // Stream the factors once per block of right-hand sides
+      casadi_ldl_solve_block(x, nrhs, max_nrhs_block, sp_Lt_, get_ptr(m->l), get_ptr(m->d),
+        get_ptr(p_), get_ptr(m->w));
+    } else {
+      casadi_ldl_solve(x, nrhs, sp_Lt_, get_ptr(m->l), get_ptr(m->d), get_ptr(p_), get_ptr(m->w));
+    }
     return 0;
   }
 
@@ -155,35 +385,55 @@ namespace casadi {
     std::string sp = g.sparsity(sp_);
     std::string sp_Lt = g.sparsity(sp_Lt_);
     std::string p = g.constant(p_);
+    casadi_int nb = std::min(nrhs, max_nrhs_block);
 
     // Place in block to avoid conflicts caused by local variables
     g << "{\n";
     g.comment("FIXME(@jaeandersson): Memory allocation can be avoided");
     g << "casadi_real lt[" << sp_Lt_.nnz() << "], "
          "d[" << nrow() << "], "
-         "w[" << nrow() << "];\n";
+         "w[" << std::max(sz_w(1), nb*nrow()) << "];\n";
 
     // Factorize
-    g << g.ldl(sp, A, sp_Lt, "lt", "d", p, "w") << "\n";
+    if (sn_.empty()) {
+      g << g.ldl(sp, A, sp_Lt, "lt", "d", p, "w") << "\n";
+    } else {
+      g << "casadi_int iw[" << sz_iw(1) << "];\n";
+      g << g.ldl_super(sp, A, g.constant(sn_), sp_Lt, "lt", "d", p, "iw", "w") << "\n";
+    }
 
     // Solve
-    g << g.ldl_solve(x, nrhs, sp_Lt, "lt", "d", p, "w") << "\n";
+    if (nrhs>1) {
+      g << g.ldl_solve_block(x, nrhs, nb, sp_Lt, "lt", "d", p, "w") << "\n";
+    } else {
+      g << g.ldl_solve(x, nrhs, sp_Lt, "lt", "d", p, "w") << "\n";
+    }
 
     // End of block
     g << "}\n";
   }
 
   LinsolLdl::LinsolLdl(DeserializingStream& s) : LinsolInternal(s) {
-    s.version("LinsolLdl", 1);
+    int version = s.version("LinsolLdl", 1, 3);
     s.unpack("LinsolLdl::p", p_);
     s.unpack("LinsolLdl::sp_Lt", sp_Lt_);
+    if (version>=2) s.unpack("LinsolLdl::sn", sn_);
+    if (version>=3) {
+      s.unpack("LinsolLdl::task_ptr", task_ptr_);
+      s.unpack("LinsolLdl::subtrees", subtrees_);
+      s.unpack("LinsolLdl::top", top_);
+    }
   }
 
   void LinsolLdl::serialize_body(SerializingStream &s) const {
     LinsolInternal::serialize_body(s);
-    s.version("LinsolLdl", 1);
+    s.version("LinsolLdl", 3);
     s.pack("LinsolLdl::p", p_);
     s.pack("LinsolLdl::sp_Lt", sp_Lt_);
+    s.pack("LinsolLdl::sn", sn_);
+    s.pack("LinsolLdl::task_ptr", task_ptr_);
+    s.pack("LinsolLdl::subtrees", subtrees_);
+    s.pack("LinsolLdl::top", top_);
   }
 
 } // namespace casadi
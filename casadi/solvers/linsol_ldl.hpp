@@ -42,6 +42,15 @@
 namespace casadi {
   struct CASADI_LINSOL_LDL_EXPORT LinsolLdlMemory : public LinsolMemory {
     std::vector<double> l, d, w;
+    std::vector<casadi_int> iw;
+    // Number of tree-parallel numeric factorizations
+    casadi_int nfact_parallel;
+  };
+
+  /** \brief Symbolic factorization, cf. LinsolLdl */
+  struct CASADI_LINSOL_LDL_EXPORT LinsolLdlSymbolic : public LinsolSymbolic {
+    std::vector<casadi_int> p, sn, task_ptr, subtrees, top;
+    Sparsity sp_Lt;
   };
 
   /** \brief \pluginbrief{LinsolInternal,ldl}
@@ -80,12 +89,21 @@ namespace casadi {
     /** \brief Free memory block */
     void free_mem(void *mem) const override { delete static_cast<LinsolLdlMemory*>(mem);}
 
+    /// Get all statistics
+    Dict get_stats(void* mem) const override;
+
+    // Calculate the symbolic factorization
+    LinsolSymbolic* symbolic(casadi_int supernodal) const;
+
     // Symbolic factorization
     int sfact(void* mem, const double* A) const override;
 
     // Factorize the linear system
     int nfact(void* mem, const double* A) const override;
 
+    // Factorize the linear system in parallel
+    void nfact_parallel(LinsolLdlMemory* m, const double* A) const;
+
     // Solve the linear system
     int solve(void* mem, const double* A, double* x, casadi_int nrhs, bool tr) const override;
 
@@ -112,9 +130,28 @@ namespace casadi {
     std::vector<casadi_int> p_;
     Sparsity sp_Lt_;
 
+    // Supernodal partition, empty if not supernodal
+    std::vector<casadi_int> sn_;
+
+    /// Supernodal partition of the columns of L, cf. casadi_ldl_super
+    static std::vector<casadi_int> supernodes(const Sparsity& sp_Lt, Sparsity& sp_Lt_relaxed);
+
+    /// Length of the integer work vector, for a given number of parallel tasks
+    casadi_int sz_iw(casadi_int ntask) const;
+
+    /// Length of the real work vector, for a given number of parallel tasks
+    casadi_int sz_w(casadi_int ntask) const;
+
+    // Tree-parallel factorization, cf. LinsolInternal::tree_partition, empty if serial
+    std::vector<casadi_int> task_ptr_, subtrees_, top_;
+
+    /// Number of parallel tasks
+    casadi_int ntask() const { return task_ptr_.empty() ? 1 : task_ptr_.size()-1;}
+
     ///@{
     // Options
     bool incomplete_, amd_;
+    casadi_int max_threads_;
     ///@}
 
     /** \brief Serialize an object without type information */
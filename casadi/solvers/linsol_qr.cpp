@@ -25,6 +25,7 @@
 
 #include "linsol_qr.hpp"
 #include "casadi/core/global_options.hpp"
+#include "casadi/core/thread_pool.hpp"
 
 namespace casadi {
 
@@ -60,7 +61,12 @@ namespace casadi {
         "Minimum R entry before singularity is declared [1e-12]"}},
       {"cache",
        {OT_DOUBLE,
-        "Amount of factorisations to remember (thread-local) [0]"}}
+        "Amount of factorisations to remember (thread-local) [0]"}},
+      {"max_threads",
+       {OT_INT,
+        "Maximum number of threads for the numeric factorization, which is then "
+        "parallelized over independent subtrees of the column elimination tree using "
+        "the CasADi thread pool [1]"}}
      }
   };
 
@@ -71,16 +77,62 @@ namespace casadi {
     // Read options
     eps_ = 1e-12;
     n_cache_ = 0;
+    casadi_int max_threads = 1;
     for (auto&& op : opts) {
       if (op.first=="eps") {
         eps_ = op.second;
       } else if (op.first=="cache") {
         n_cache_ = op.second;
+      } else if (op.first=="max_threads") {
+        max_threads = op.second;
       }
     }
 
-    // Symbolic factorization
-    sp_.qr_sparse(sp_v_, sp_r_, prinv_, pc_);
+    // Symbolic factorization, shared with other instances if possible
+    const auto& sym = static_cast<const LinsolQrSymbolic&>(symbolic_cached(
+      str(max_threads), [&]() { return symbolic(max_threads);}));
+    sp_v_ = sym.sp_v;
+    sp_r_ = sym.sp_r;
+    prinv_ = sym.prinv;
+    pc_ = sym.pc;
+    task_ptr_ = sym.task_ptr;
+    subtrees_ = sym.subtrees;
+    top_ = sym.top;
+    if (verbose_ && !task_ptr_.empty()) {
+      casadi_message("Tree-parallel factorization with " + str(task_ptr_.size()-1)
+        + " tasks, " + str(subtrees_.size()/2) + " subtrees");
+    }
+  }
+
+  LinsolSymbolic* LinsolQr::symbolic(casadi_int max_threads) const {
+    auto sym = new LinsolQrSymbolic();
+    sp_.qr_sparse(sym->sp_v, sym->sp_r, sym->prinv, sym->pc);
+
+    // Partition for a tree-parallel factorization
+    if (max_threads>1) {
+      // Postorder the column elimination tree, making subtrees contiguous
+      std::vector<casadi_int> post = postorder(sym->sp_r.etree());
+      if (post!=range(ncol())) {
+        std::vector<casadi_int> pc = vector_slice(sym->pc, post), tmp;
+        Sparsity Aperm = sp_.sub(range(nrow()), pc, tmp);
+        Aperm.qr_sparse(sym->sp_v, sym->sp_r, sym->prinv, tmp, false);
+        sym->pc = pc;
+      }
+      // Calculating column c of R and V requires the columns of V in its pattern
+      const casadi_int *r_colind = sym->sp_r.colind(), *r_row = sym->sp_r.row(),
+        *v_colind = sym->sp_v.colind();
+      std::vector<double> cost(ncol());
+      for (casadi_int c=0; c<ncol(); ++c) {
+        cost[c] = 1 + v_colind[c+1]-v_colind[c];
+        for (casadi_int k=r_colind[c]; k<r_colind[c+1]; ++k) {
+          casadi_int r = r_row[k];
+          if (r<c) cost[c] += 4*(v_colind[r+1]-v_colind[r]);
+        }
+      }
+      tree_partition(sym->sp_r.etree(), cost, max_threads,
+                     sym->task_ptr, sym->subtrees, sym->top);
+    }
+    return sym;
   }
 
   void LinsolQr::finalize() {
@@ -96,14 +148,23 @@ namespace casadi {
     m->v.resize(sp_v_.nnz());
     m->r.resize(sp_r_.nnz());
     m->beta.resize(ncol());
-    m->w.resize(nrow() + ncol());
+    m->w.resize(std::max(nrow() + ncol(), max_nrhs_block*(sp_v_.size1()+1)));
 
     m->cache.resize(cache_stride_*n_cache_);
     m->cache_loc.resize(n_cache_, -1);
+    m->nfact_parallel = 0;
 
     return 0;
   }
 
+  Dict LinsolQr::get_stats(void* mem) const {
+    Dict stats = LinsolInternal::get_stats(mem);
+    auto m = static_cast<LinsolQrMemory*>(mem);
+    stats["n_task"] = static_cast<casadi_int>(task_ptr_.empty() ? 1 : task_ptr_.size()-1);
+    stats["nfact_parallel"] = m->nfact_parallel;
+    return stats;
+  }
+
   int LinsolQr::sfact(void* mem, const double* A) const {
     return 0;
   }
@@ -126,9 +187,27 @@ namespace casadi {
     }
 
     // Cache miss -> compute result
-    casadi_qr(sp_, A, get_ptr(m->w),
-              sp_v_, get_ptr(m->v), sp_r_, get_ptr(m->r),
-              get_ptr(m->beta), get_ptr(prinv_), get_ptr(pc_));
+    if (task_ptr_.empty()) {
+      casadi_qr(sp_, A, get_ptr(m->w),
+                sp_v_, get_ptr(m->v), sp_r_, get_ptr(m->r),
+                get_ptr(m->beta), get_ptr(prinv_), get_ptr(pc_));
+    } else {
+      casadi_fill(get_ptr(m->w), sp_v_.size1(), 0.);
+      // Subtrees in parallel, sharing the work vector
+      ThreadPool::instance().run(task_ptr_.size()-1, [&](casadi_int t) {
+        for (casadi_int k=task_ptr_[t]; k<task_ptr_[t+1]; ++k) {
+          casadi_qr_cols(sp_, A, get_ptr(m->w), sp_v_, get_ptr(m->v), sp_r_, get_ptr(m->r),
+            get_ptr(m->beta), get_ptr(prinv_), get_ptr(pc_), subtrees_[2*k], subtrees_[2*k+1]);
+        }
+        return 0;
+      }, 1);
+      m->nfact_parallel++;
+      // Their ancestors serially
+      for (casadi_int k=0; k<top_.size(); k+=2) {
+        casadi_qr_cols(sp_, A, get_ptr(m->w), sp_v_, get_ptr(m->v), sp_r_, get_ptr(m->r),
+          get_ptr(m->beta), get_ptr(prinv_), get_ptr(pc_), top_[k], top_[k+1]);
+      }
+    }
     // Check singularity
     double rmin;
     casadi_int irmin, nullity;
@@ -156,9 +235,16 @@ namespace casadi {
 
   int LinsolQr::solve(void* mem, const double* A, double* x, casadi_int nrhs, bool tr) const {
     auto m = static_cast<LinsolQrMemory*>(mem);
-    casadi_qr_solve(x, nrhs, tr,
-                    sp_v_, get_ptr(m->v), sp_r_, get_ptr(m->r),
-                    get_ptr(m->beta), get_ptr(prinv_), get_ptr(pc_), get_ptr(m->w));
+    if (nrhs>1) {
+      // Stream the factors once per block of right-hand sides
+      casadi_qr_solve_block(x, nrhs, max_nrhs_block, tr,
+                            sp_v_, get_ptr(m->v), sp_r_, get_ptr(m->r),
+                            get_ptr(m->beta), get_ptr(prinv_), get_ptr(pc_), get_ptr(m->w));
+    } else {
+      casadi_qr_solve(x, nrhs, tr,
+                      sp_v_, get_ptr(m->v), sp_r_, get_ptr(m->r),
+                      get_ptr(m->beta), get_ptr(prinv_), get_ptr(pc_), get_ptr(m->w));
+    }
     return 0;
   }
 
@@ -170,6 +256,7 @@ namespace casadi {
     std::string sp = g.sparsity(sp_);
     std::string sp_v = g.sparsity(sp_v_);
     std::string sp_r = g.sparsity(sp_r_);
+    casadi_int nb = std::min(nrhs, max_nrhs_block);
 
     // Place in block to avoid conflicts caused by local variables
     g << "{\n";
@@ -177,7 +264,7 @@ namespace casadi {
     g << "casadi_real v[" << sp_v_.nnz() << "], "
          "r[" << sp_r_.nnz() << "], "
          "beta[" << ncol() << "], "
-         "w[" << nrow() + ncol() << "];\n";
+         "w[" << std::max(nrow() + ncol(), nb*(sp_v_.size1()+1)) << "];\n";
 
     if (n_cache_) {
       g << "casadi_real *c;\n";
@@ -211,14 +298,19 @@ namespace casadi {
     }
 
     // Solve
-    g << g.qr_solve(x, nrhs, tr, sp_v, "v", sp_r, "r", "beta", prinv, pc, "w") << "\n";
+    if (nrhs>1) {
+      g << g.qr_solve_block(x, nrhs, nb, tr, sp_v, "v", sp_r, "r", "beta", prinv, pc, "w")
+        << "\n";
+    } else {
+      g << g.qr_solve(x, nrhs, tr, sp_v, "v", sp_r, "r", "beta", prinv, pc, "w") << "\n";
+    }
 
     // End of block
     g << "}\n";
   }
 
   LinsolQr::LinsolQr(DeserializingStream& s) : LinsolInternal(s) {
-    int version = s.version("LinsolQr", 1, 2);
+    int version = s.version("LinsolQr", 1, 3);
     s.unpack("LinsolQr::prinv", prinv_);
     s.unpack("LinsolQr::pc", pc_);
     s.unpack("LinsolQr::sp_v", sp_v_);
@@ -229,17 +321,25 @@ namespace casadi {
     } else {
       n_cache_ = 1;
     }
+    if (version>2) {
+      s.unpack("LinsolQr::task_ptr", task_ptr_);
+      s.unpack("LinsolQr::subtrees", subtrees_);
+      s.unpack("LinsolQr::top", top_);
+    }
   }
 
   void LinsolQr::serialize_body(SerializingStream &s) const {
     LinsolInternal::serialize_body(s);
-    s.version("LinsolQr", 2);
+    s.version("LinsolQr", 3);
     s.pack("LinsolQr::prinv", prinv_);
     s.pack("LinsolQr::pc", pc_);
     s.pack("LinsolQr::sp_v", sp_v_);
     s.pack("LinsolQr::sp_r", sp_r_);
     s.pack("LinsolQr::eps", eps_);
     s.pack("LinsolQr::n_cache", n_cache_);
+    s.pack("LinsolQr::task_ptr", task_ptr_);
+    s.pack("LinsolQr::subtrees", subtrees_);
+    s.pack("LinsolQr::top", top_);
   }
 
 } // namespace casadi
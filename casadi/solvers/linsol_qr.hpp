@@ -46,6 +46,15 @@ namespace casadi {
 
     // Cache locations sorted by access time
     std::vector<int> cache_loc;
+
+    // Number of tree-parallel numeric factorizations
+    casadi_int nfact_parallel;
+  };
+
+  /** \brief Symbolic factorization, cf. LinsolQr */
+  struct CASADI_LINSOL_QR_EXPORT LinsolQrSymbolic : public LinsolSymbolic {
+    std::vector<casadi_int> prinv, pc, task_ptr, subtrees, top;
+    Sparsity sp_v, sp_r;
   };
 
   /** \brief \pluginbrief{LinsolInternal,qr}
@@ -87,6 +96,12 @@ namespace casadi {
     /** \brief Free memory block */
     void free_mem(void *mem) const override { delete static_cast<LinsolQrMemory*>(mem);}
 
+    /// Get all statistics
+    Dict get_stats(void* mem) const override;
+
+    // Calculate the symbolic factorization
+    LinsolSymbolic* symbolic(casadi_int max_threads) const;
+
     // Symbolic factorization
     int nfact(void* mem, const double* A) const override;
 
@@ -118,6 +133,9 @@ namespace casadi {
     casadi_int n_cache_;
     casadi_int cache_stride_;
 
+    // Tree-parallel factorization, cf. LinsolInternal::tree_partition, empty if serial
+    std::vector<casadi_int> task_ptr_, subtrees_, top_;
+
     /** \brief Serialize an object without type information */
     void serialize_body(SerializingStream &s) const override;
 
@@ -0,0 +1,448 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "ocpqp.hpp"
+#include <numeric>
+
+namespace casadi {
+
+  extern "C"
+  int CASADI_CONIC_OCPQP_EXPORT
+  casadi_register_conic_ocpqp(Conic::Plugin* plugin) {
+    plugin->creator = Ocpqp::creator;
+    plugin->name = "ocpqp";
+    plugin->doc = Ocpqp::meta_doc.c_str();
+    plugin->version = CASADI_VERSION;
+    plugin->options = &Ocpqp::options_;
+    plugin->deserialize = &Ocpqp::deserialize;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_CONIC_OCPQP_EXPORT casadi_load_conic_ocpqp() {
+    Conic::registerPlugin(casadi_register_conic_ocpqp);
+  }
+
+  Ocpqp::Ocpqp(const std::string& name, const std::map<std::string, Sparsity> &st)
+    : Conic(name, st) {
+  }
+
+  Ocpqp::~Ocpqp() {
+    clear_mem();
+  }
+
+  const Options Ocpqp::options_
+  = {{&Conic::options_},
+     {{"N",
+       {OT_INT,
+        "OCP horizon"}},
+      {"nx",
+       {OT_INTVECTOR,
+        "Number of states, length N+1"}},
+      {"nu",
+       {OT_INTVECTOR,
+        "Number of controls, length N or N+1"}},
+      {"ng",
+       {OT_INTVECTOR,
+        "Number of non-dynamic constraints, length N+1"}},
+      {"max_iter",
+       {OT_INT,
+        "Maximum number of iterations [100]."}},
+      {"max_corrections",
+       {OT_INT,
+        "Maximum number of Gondzio centrality corrections per iteration [0]."}},
+      {"pr_tol",
+       {OT_DOUBLE,
+        "Primal feasibility tolerance [1e-8]."}},
+      {"du_tol",
+       {OT_DOUBLE,
+        "Dual feasibility tolerance [1e-8]."}},
+      {"co_tol",
+       {OT_DOUBLE,
+        "Complementarity tolerance [1e-8]."}},
+      {"mu_tol",
+       {OT_DOUBLE,
+        "Barrier parameter tolerance [1e-8]."}},
+      {"print_header",
+       {OT_BOOL,
+        "Print header [true]."}},
+      {"print_iter",
+       {OT_BOOL,
+        "Print iterations [true]."}}
+     }
+  };
+
+  void Ocpqp::init(const Dict& opts) {
+    // Initialize the base classes
+    Conic::init(opts);
+    // Assemble KKT system sparsity
+    kkt_ = Sparsity::kkt(H_, A_, true, true);
+    // Setup memory structure
+    set_qp_prob();
+    // Default options
+    print_iter_ = true;
+    print_header_ = true;
+    casadi_int N = -1;
+    std::vector<casadi_int> nxs, nus, ngs;
+    // Read user options
+    for (auto&& op : opts) {
+      if (op.first=="N") {
+        N = op.second;
+      } else if (op.first=="nx") {
+        nxs = op.second;
+      } else if (op.first=="nu") {
+        nus = op.second;
+      } else if (op.first=="ng") {
+        ngs = op.second;
+      } else if (op.first=="max_iter") {
+        p_.max_iter = op.second;
+      } else if (op.first=="max_corrections") {
+        p_.max_corr = op.second;
+      } else if (op.first=="pr_tol") {
+        p_.pr_tol = op.second;
+      } else if (op.first=="du_tol") {
+        p_.du_tol = op.second;
+      } else if (op.first=="co_tol") {
+        p_.co_tol = op.second;
+      } else if (op.first=="mu_tol") {
+        p_.mu_tol = op.second;
+      } else if (op.first=="print_iter") {
+        print_iter_ = op.second;
+      } else if (op.first=="print_header") {
+        print_header_ = op.second;
+      }
+    }
+    // Check structure
+    casadi_assert(N>=0 && !nxs.empty() && !ngs.empty(),
+      "The options N, nx, nu and ng must be set.");
+    if (nus.size()==N) nus.push_back(0);
+    casadi_assert(nxs.size()==N+1 && nus.size()==N+1 && ngs.size()==N+1,
+      "Expected nx and ng of length N+1 and nu of length N or N+1. "
+      "Structure is: N " + str(N) + ", nx " + str(nxs) + ", nu " + str(nus) + ", "
+      "ng " + str(ngs) + ".");
+    casadi_assert(nx_ == std::accumulate(nxs.begin(), nxs.end(), casadi_int(0))
+      + std::accumulate(nus.begin(), nus.end(), casadi_int(0)),
+      "sum(nx)+sum(nu) must equal the number of variables (" + str(nx_) + "). "
+      "Structure is: N " + str(N) + ", nx " + str(nxs) + ", nu " + str(nus) + ", "
+      "ng " + str(ngs) + ".");
+    casadi_assert(na_ == std::accumulate(nxs.begin()+1, nxs.end(), casadi_int(0))
+      + std::accumulate(ngs.begin(), ngs.end(), casadi_int(0)),
+      "sum(nx[1:])+sum(ng) must equal the number of constraints (" + str(na_) + "). "
+      "Structure is: N " + str(N) + ", nx " + str(nxs) + ", nu " + str(nus) + ", "
+      "ng " + str(ngs) + ".");
+    // Stage-wise ordering of the KKT system
+    bp_ = band_structure(kkt_, nx_, nxs, nus, ngs);
+    // Memory for IP solver
+    alloc_w(casadi_ipqp_sz_w(&p_), true);
+    // KKT matrix and its band factorization
+    alloc_w(kkt_.nnz(), true);
+    alloc_w(sz_w_band(), true);
+    alloc_iw(kkt_.size1(), true);
+    // Nonzeros of H, A and g, for generated code
+    alloc_w(H_.nnz() + A_.nnz() + nx_, true);
+    // Memory for KKT formation
+    alloc_iw(na_);
+    alloc_w(nx_ + na_);
+    // Print summary
+    if (print_header_) {
+      print("-------------------------------------------\n");
+      print("This is casadi::Ocpqp\n");
+      print("Number of stages:                %12d\n", N);
+      print("Number of variables:             %12d\n", nx_);
+      print("Number of constraints:           %12d\n", na_);
+      print("Number of nonzeros in H:         %12d\n", H_.nnz());
+      print("Number of nonzeros in A:         %12d\n", A_.nnz());
+      print("Number of nonzeros in KKT:       %12d\n", kkt_.nnz());
+      print("Bandwidth of KKT:                %12d\n", std::max(bp_[2], bp_[3]));
+    }
+  }
+
+  std::vector<casadi_int> Ocpqp::band_structure(const Sparsity& kkt, casadi_int nx,
+      const std::vector<casadi_int>& nxs, const std::vector<casadi_int>& nus,
+      const std::vector<casadi_int>& ngs) {
+    casadi_int n = kkt.size2(), N = nxs.size()-1;
+    // Order stage by stage: x_k, u_k, g_k, gap_k
+    std::vector<casadi_int> order;
+    casadi_int offset_x = 0, offset_g = nx;
+    for (casadi_int k=0; k<=N; ++k) {
+      for (casadi_int i=0; i<nxs[k]+nus[k]; ++i) order.push_back(offset_x++);
+      casadi_int n_gap = k<N ? nxs[k+1] : 0;
+      for (casadi_int i=0; i<ngs[k]; ++i) order.push_back(offset_g + n_gap + i);
+      for (casadi_int i=0; i<n_gap; ++i) order.push_back(offset_g + i);
+      offset_g += n_gap + ngs[k];
+    }
+    casadi_assert_dev(order.size()==n);
+    std::vector<casadi_int> pinv(n);
+    for (casadi_int i=0; i<n; ++i) pinv[order[i]] = i;
+    // Bandwidths
+    const casadi_int *colind = kkt.colind(), *row = kkt.row();
+    casadi_int kl = 0, ku = 0;
+    for (casadi_int c=0; c<n; ++c) {
+      for (casadi_int k=colind[c]; k<colind[c+1]; ++k) {
+        casadi_int d = pinv[row[k]] - pinv[c];
+        kl = std::max(kl, d);
+        ku = std::max(ku, -d);
+      }
+    }
+    // Assemble, without a dense border
+    std::vector<casadi_int> ret = {n, 0, kl, ku};
+    ret.insert(ret.end(), pinv.begin(), pinv.end());
+    return ret;
+  }
+
+  casadi_int Ocpqp::sz_w_band() const {
+    casadi_int n = bp_[0], kl = bp_[2], ku = bp_[3];
+    // Band storage with fill-in, permuted vector
+    return (2*kl+ku+1)*n + n;
+  }
+
+  void Ocpqp::set_qp_prob() {
+    casadi_ipqp_setup(&p_, nx_, na_);
+  }
+
+  int Ocpqp::init_mem(void* mem) const {
+    if (Conic::init_mem(mem)) return 1;
+    auto m = static_cast<OcpqpMemory*>(mem);
+    m->return_status = "";
+    return 0;
+  }
+
+  int Ocpqp::
+  solve(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const {
+    auto m = static_cast<OcpqpMemory*>(mem);
+    // Message buffer
+    char buf[121];
+    // Setup IP solver
+    casadi_ipqp_data<double> d;
+    d.prob = &p_;
+    casadi_ipqp_init(&d, &iw, &w);
+    // KKT matrix and its band factorization
+    double* nz_kkt = w; w += kkt_.nnz();
+    double* w_band = w; w += sz_w_band();
+    casadi_int* iw_band = iw; iw += kkt_.size1();
+    w += H_.nnz() + A_.nnz() + nx_;
+    // Pass problem data
+    casadi_ipqp_bounds(&d, arg[CONIC_G],
+      arg[CONIC_LBX], arg[CONIC_UBX], arg[CONIC_LBA], arg[CONIC_UBA]);
+    casadi_ipqp_guess(&d, arg[CONIC_X0], arg[CONIC_LAM_X0], arg[CONIC_LAM_A0]);
+    // Reverse communication loop
+    while (casadi_ipqp(&d)) {
+      switch (d.task) {
+      case IPQP_MV:
+        // Matrix-vector multiplication
+        casadi_mv(arg[CONIC_H], H_, d.z, d.rz, 0);
+        casadi_mv(arg[CONIC_A], A_, d.lam + p_.nx, d.rz, 1);
+        casadi_mv(arg[CONIC_A], A_, d.z, d.rz + p_.nx, 0);
+        break;
+      case IPQP_PROGRESS:
+        // Print progress
+        if (print_iter_) {
+          if (d.iter % 10 == 0) {
+            // Print header
+            if (casadi_ipqp_print_header(&d, buf, sizeof(buf))) break;
+            uout() << buf << "\n";
+          }
+          // Print iteration
+          if (casadi_ipqp_print_iteration(&d, buf, sizeof(buf))) break;
+          uout() << buf << "\n";
+          // User interrupt?
+          InterruptHandler::check();
+        }
+        break;
+      case IPQP_FACTOR:
+        // Form KKT
+        casadi_kkt(kkt_, nz_kkt, H_, arg[CONIC_H], A_, arg[CONIC_A],
+          d.S, d.D, w, iw);
+        // Factorize KKT
+        if (casadi_band_fact(kkt_, nz_kkt, get_ptr(bp_), iw_band, w_band))
+          d.status = IPQP_FACTOR_ERROR;
+        break;
+      case IPQP_SOLVE:
+        // Solve KKT
+        casadi_band_solve(d.linsys, 1, 0, get_ptr(bp_), iw_band, w_band);
+        break;
+      }
+    }
+    // Read return status
+    m->return_status = casadi_ipqp_return_status(d.status);
+    if (d.status == IPQP_MAX_ITER)
+      m->d_qp.unified_return_status = SOLVER_RET_LIMITED;
+    // Get solution
+    casadi_ipqp_solution(&d, res[CONIC_X], res[CONIC_LAM_X], res[CONIC_LAM_A]);
+    if (res[CONIC_COST]) {
+      *res[CONIC_COST] = .5 * casadi_bilin(arg[CONIC_H], H_, d.z, d.z)
+        + casadi_dot(p_.nx, d.z, d.g);
+    }
+    m->d_qp.iter_count = d.iter;
+    // Return
+    if (verbose_) casadi_warning(m->return_status);
+    m->d_qp.success = d.status == IPQP_SUCCESS;
+    return 0;
+  }
+
+  void Ocpqp::codegen_body(CodeGenerator& g) const {
+    g.add_auxiliary(CodeGenerator::AUX_IPQP);
+    g.add_auxiliary(CodeGenerator::AUX_KKT);
+    g.add_auxiliary(CodeGenerator::AUX_BAND);
+    g.add_auxiliary(CodeGenerator::AUX_MV);
+    g.add_auxiliary(CodeGenerator::AUX_BILIN);
+    g.add_auxiliary(CodeGenerator::AUX_DOT);
+    if (print_iter_) g.add_auxiliary(CodeGenerator::AUX_PRINTF);
+    g.local("d", "struct casadi_ipqp_data");
+    g.local("p", "struct casadi_ipqp_prob");
+    g.local("nz_kkt", "casadi_real", "*");
+    g.local("w_band", "casadi_real", "*");
+    g.local("iw_band", "casadi_int", "*");
+    g.local("h", "casadi_real", "*");
+    g.local("a", "casadi_real", "*");
+    g.local("g", "casadi_real", "*");
+    if (print_iter_) g.local("buf[121]", "char");
+
+    // Setup memory structure
+    g << "casadi_ipqp_setup(&p, " << nx_ << ", " << na_ << ");\n";
+    g << "p.max_iter = " << p_.max_iter << ";\n";
+    g << "p.max_corr = " << p_.max_corr << ";\n";
+    g << "p.pr_tol = " << p_.pr_tol << ";\n";
+    g << "p.du_tol = " << p_.du_tol << ";\n";
+    g << "p.co_tol = " << p_.co_tol << ";\n";
+    g << "p.mu_tol = " << p_.mu_tol << ";\n";
+
+    // Setup data structure
+    g << "d.prob = &p;\n";
+    g << "casadi_ipqp_init(&d, &iw, &w);\n";
+    g << "nz_kkt = w; w += " << kkt_.nnz() << ";\n";
+    g << "w_band = w; w += " << sz_w_band() << ";\n";
+    g << "iw_band = iw; iw += " << kkt_.size1() << ";\n";
+    g << "h = w; w += " << H_.nnz() << ";\n";
+    g << "a = w; w += " << A_.nnz() << ";\n";
+    g << "g = w; w += " << nx_ << ";\n";
+
+    g.comment("Pass problem data");
+    g.copy_default(g.arg(CONIC_H), H_.nnz(), "h", "0", false);
+    g.copy_default(g.arg(CONIC_A), A_.nnz(), "a", "0", false);
+    g.copy_default(g.arg(CONIC_G), nx_, "g", "0", false);
+    g << "d.g = g;\n";
+    g.copy_default(g.arg(CONIC_LBX), nx_, "d.lbz", "-casadi_inf", false);
+    g.copy_default(g.arg(CONIC_LBA), na_, "d.lbz+" + str(nx_), "-casadi_inf", false);
+    g.copy_default(g.arg(CONIC_UBX), nx_, "d.ubz", "casadi_inf", false);
+    g.copy_default(g.arg(CONIC_UBA), na_, "d.ubz+" + str(nx_), "casadi_inf", false);
+
+    g.comment("Pass initial guess");
+    g.copy_default(g.arg(CONIC_X0), nx_, "d.z", "0", false);
+    g << g.fill("d.z+" + str(nx_), na_, "0") << "\n";
+    g.copy_default(g.arg(CONIC_LAM_X0), nx_, "d.lam", "0", false);
+    g.copy_default(g.arg(CONIC_LAM_A0), na_, "d.lam+" + str(nx_), "0", false);
+    g << g.fill("d.lam_lbz", nx_ + na_, "0") << "\n";
+    g << g.fill("d.lam_ubz", nx_ + na_, "0") << "\n";
+
+    g.comment("Solve QP");
+    g << "while (casadi_ipqp(&d)) {\n";
+    g << "switch (d.task) {\n";
+    g << "case IPQP_MV:\n";
+    g << g.mv("h", H_, "d.z", "d.rz", false) << "\n";
+    g << g.mv("a", A_, "d.lam+" + str(nx_), "d.rz", true) << "\n";
+    g << g.mv("a", A_, "d.z", "d.rz+" + str(nx_), false) << "\n";
+    g << "break;\n";
+    g << "case IPQP_PROGRESS:\n";
+    if (print_iter_) {
+      // Print header
+      g << "if (d.iter % 10 == 0) {\n";
+      g << "if (casadi_ipqp_print_header(&d, buf, sizeof(buf))) break;\n";
+      g << g.printf("%s\\n", "buf") << "\n";
+      g << "}\n";
+      // Print iteration
+      g << "if (casadi_ipqp_print_iteration(&d, buf, sizeof(buf))) break;\n";
+      g << g.printf("%s\\n", "buf") << "\n";
+    }
+    g << "break;\n";
+    g << "case IPQP_FACTOR:\n";
+    g << "casadi_kkt(" << g.sparsity(kkt_) << ", nz_kkt, " << g.sparsity(H_) << ", h, "
+      << g.sparsity(A_) << ", a, d.S, d.D, w, iw);\n";
+    g << "if (casadi_band_fact(" << g.sparsity(kkt_) << ", nz_kkt, " << g.constant(bp_)
+      << ", iw_band, w_band)) d.status = IPQP_FACTOR_ERROR;\n";
+    g << "break;\n";
+    g << "case IPQP_SOLVE:\n";
+    g << g.band_solve("d.linsys", 1, false, g.constant(bp_), "iw_band", "w_band") << "\n";
+    g << "break;\n";
+    g << "}\n";
+    g << "}\n";
+
+    g.comment("Get solution");
+    g.copy_check("d.z", nx_, g.res(CONIC_X), false, true);
+    g.copy_check("d.lam", nx_, g.res(CONIC_LAM_X), false, true);
+    g.copy_check("d.lam+" + str(nx_), na_, g.res(CONIC_LAM_A), false, true);
+    g << "if (" << g.res(CONIC_COST) << ") *" << g.res(CONIC_COST) << " = 0.5*"
+      << g.bilin("h", H_, "d.z", "d.z") << "+" << g.dot(nx_, "d.z", "g") << ";\n";
+
+    g << "if (d.status == IPQP_SUCCESS) {\n";
+    g << "return 0;\n";
+    g << "} else {\n";
+    if (error_on_fail_) {
+      g << "return -1000;\n";
+    } else {
+      g << "return -1;\n";
+    }
+    g << "}\n";
+  }
+
+  Dict Ocpqp::get_stats(void* mem) const {
+    Dict stats = Conic::get_stats(mem);
+    auto m = static_cast<OcpqpMemory*>(mem);
+    stats["return_status"] = m->return_status;
+    return stats;
+  }
+
+  Ocpqp::Ocpqp(DeserializingStream& s) : Conic(s) {
+    s.version("Ocpqp", 1);
+    s.unpack("Ocpqp::kkt", kkt_);
+    s.unpack("Ocpqp::bp", bp_);
+    s.unpack("Ocpqp::print_iter", print_iter_);
+    s.unpack("Ocpqp::print_header", print_header_);
+    set_qp_prob();
+    s.unpack("Ocpqp::max_iter", p_.max_iter);
+    s.unpack("Ocpqp::max_corr", p_.max_corr);
+    s.unpack("Ocpqp::pr_tol", p_.pr_tol);
+    s.unpack("Ocpqp::du_tol", p_.du_tol);
+    s.unpack("Ocpqp::co_tol", p_.co_tol);
+    s.unpack("Ocpqp::mu_tol", p_.mu_tol);
+  }
+
+  void Ocpqp::serialize_body(SerializingStream &s) const {
+    Conic::serialize_body(s);
+
+    s.version("Ocpqp", 1);
+    s.pack("Ocpqp::kkt", kkt_);
+    s.pack("Ocpqp::bp", bp_);
+    s.pack("Ocpqp::print_iter", print_iter_);
+    s.pack("Ocpqp::print_header", print_header_);
+    s.pack("Ocpqp::max_iter", p_.max_iter);
+    s.pack("Ocpqp::max_corr", p_.max_corr);
+    s.pack("Ocpqp::pr_tol", p_.pr_tol);
+    s.pack("Ocpqp::du_tol", p_.du_tol);
+    s.pack("Ocpqp::co_tol", p_.co_tol);
+    s.pack("Ocpqp::mu_tol", p_.mu_tol);
+  }
+
+} // namespace casadi
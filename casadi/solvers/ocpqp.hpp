@@ -0,0 +1,145 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#ifndef CASADI_OCPQP_HPP
+#define CASADI_OCPQP_HPP
+
+#include "casadi/core/conic_impl.hpp"
+#include <casadi/solvers/casadi_conic_ocpqp_export.h>
+
+/** \defgroup plugin_Conic_ocpqp Title
+    \par
+
+ Solves QPs with the stage structure of an optimal control problem using the
+ interior point method of ipqp. The KKT system is reordered stage by stage
+ and factorized as a band matrix, with a cost that grows linearly in the horizon.
+
+ The structure is given with the options N, nx, nu and ng, as for hpipm.
+ The decision variables are ordered as x_0, u_0, x_1, u_1, ..., x_N and the
+ constraints as gap_0, g_0, gap_1, g_1, ..., g_N, with the gap constraints
+ coupling x_{k+1} to x_k and u_k.
+
+*/
+
+/** \pluginsection{Conic,ocpqp} */
+
+/// \cond INTERNAL
+namespace casadi {
+  struct CASADI_CONIC_OCPQP_EXPORT OcpqpMemory : public ConicMemory {
+    const char* return_status;
+  };
+
+  /** \brief \pluginbrief{Conic,ocpqp}
+
+      @copydoc Conic_doc
+      @copydoc plugin_Conic_ocpqp
+  */
+  class CASADI_CONIC_OCPQP_EXPORT Ocpqp : public Conic {
+  public:
+    /** \brief  Create a new Solver */
+    explicit Ocpqp(const std::string& name,
+                   const std::map<std::string, Sparsity> &st);
+
+    /** \brief  Create a new QP Solver */
+    static Conic* creator(const std::string& name,
+                          const std::map<std::string, Sparsity>& st) {
+      return new Ocpqp(name, st);
+    }
+
+    /** \brief  Destructor */
+    ~Ocpqp() override;
+
+    // Get name of the plugin
+    const char* plugin_name() const override { return "ocpqp";}
+
+    // Get name of the class
+    std::string class_name() const override { return "Ocpqp";}
+
+    /** \brief Create memory block */
+    void* alloc_mem() const override { return new OcpqpMemory();}
+
+    /** \brief Initalize memory block */
+    int init_mem(void* mem) const override;
+
+    /** \brief Free memory block */
+    void free_mem(void *mem) const override { delete static_cast<OcpqpMemory*>(mem);}
+
+    ///@{
+    /** \brief Options */
+    static const Options options_;
+    const Options& get_options() const override { return options_;}
+    ///@}
+
+    /** \brief Initialize */
+    void init(const Dict& opts) override;
+
+    /** \brief Solve the QP */
+    int solve(const double** arg, double** res,
+             casadi_int* iw, double* w, void* mem) const override;
+
+    /// Get all statistics
+    Dict get_stats(void* mem) const override;
+
+    /** \brief Generate code for the function body */
+    void codegen_body(CodeGenerator& g) const override;
+
+    /** \brief Stage-wise ordering of the KKT system and its bandwidths */
+    static std::vector<casadi_int> band_structure(const Sparsity& kkt, casadi_int nx,
+      const std::vector<casadi_int>& nxs, const std::vector<casadi_int>& nus,
+      const std::vector<casadi_int>& ngs);
+
+    /// A documentation string
+    static const std::string meta_doc;
+    // Memory structure
+    casadi_ipqp_prob<double> p_;
+    // KKT system
+    Sparsity kkt_;
+    // Band structure of the KKT system: n, 0, kl, ku, pinv
+    std::vector<casadi_int> bp_;
+    ///@{
+    // Options
+    bool print_iter_, print_header_;
+    ///@}
+
+    // Size of the work vectors for the band factorization
+    casadi_int sz_w_band() const;
+
+    void serialize_body(SerializingStream &s) const override;
+
+    /** \brief Deserialize with type disambiguation */
+    static ProtoFunction* deserialize(DeserializingStream& s) { return new Ocpqp(s); }
+
+  protected:
+     /** \brief Deserializing constructor */
+    explicit Ocpqp(DeserializingStream& s);
+
+  private:
+    void set_qp_prob();
+  };
+
+} // namespace casadi
+/// \endcond
+#endif // CASADI_OCPQP_HPP
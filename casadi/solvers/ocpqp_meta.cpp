@@ -0,0 +1,95 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+      #include "ocpqp.hpp"
+      #include <string>
+
+      const std::string casadi::Ocpqp::meta_doc=
+      "\n"
+"Solves QPs with the stage structure of an optimal control problem using the\n"
+"interior point method of ipqp. The KKT system is reordered stage by stage\n"
+"and factorized as a band matrix, with a cost that grows linearly in the\n"
+"horizon.\n"
+"\n"
+"The structure is given with the options N, nx, nu and ng, as for hpipm.\n"
+"The decision variables are ordered as x_0, u_0, x_1, u_1, ..., x_N and the\n"
+"constraints as gap_0, g_0, gap_1, g_1, ..., g_N, with the gap constraints\n"
+"coupling x_{k+1} to x_k and u_k.\n"
+"\n"
+"\n"
+">List of available options\n"
+"\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"|        Id       |       Type      |     Default     |   Description   |\n"
+"+=================+=================+=================+=================+\n"
+"| N               | OT_INT          |                 | OCP horizon     |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| co_tol          | OT_DOUBLE       | 1e-8            | Complementarity |\n"
+"|                 |                 |                 | tolerance       |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| du_tol          | OT_DOUBLE       | 1e-8            | Dual            |\n"
+"|                 |                 |                 | feasibility     |\n"
+"|                 |                 |                 | tolerance       |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| max_corrections | OT_INT          | 0               | Maximum number  |\n"
+"|                 |                 |                 | of Gondzio      |\n"
+"|                 |                 |                 | centrality      |\n"
+"|                 |                 |                 | corrections per |\n"
+"|                 |                 |                 | iteration       |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| max_iter        | OT_INT          | 100             | Maximum number  |\n"
+"|                 |                 |                 | of iterations   |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| mu_tol          | OT_DOUBLE       | 1e-8            | Barrier         |\n"
+"|                 |                 |                 | parameter       |\n"
+"|                 |                 |                 | tolerance       |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| ng              | OT_INTVECTOR    |                 | Number of       |\n"
+"|                 |                 |                 | non-dynamic     |\n"
+"|                 |                 |                 | constraints,    |\n"
+"|                 |                 |                 | length N+1      |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| nu              | OT_INTVECTOR    |                 | Number of       |\n"
+"|                 |                 |                 | controls,       |\n"
+"|                 |                 |                 | length N or N+1 |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| nx              | OT_INTVECTOR    |                 | Number of       |\n"
+"|                 |                 |                 | states, length  |\n"
+"|                 |                 |                 | N+1             |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| pr_tol          | OT_DOUBLE       | 1e-8            | Primal          |\n"
+"|                 |                 |                 | feasibility     |\n"
+"|                 |                 |                 | tolerance       |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| print_header    | OT_BOOL         | true            | Print header    |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| print_iter      | OT_BOOL         | true            | Print           |\n"
+"|                 |                 |                 | iterations      |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"\n"
+"\n"
+"\n"
+"\n"
+;
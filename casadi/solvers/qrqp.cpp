@@ -79,7 +79,13 @@ namespace casadi {
         "Printed numbers are 0-based indices into the vector of [simple bounds;linear bounds]"}},
       {"min_lam",
        {OT_DOUBLE,
-        "Smallest multiplier treated as inactive for the initial active set [0]."}}
+        "Smallest multiplier treated as inactive for the initial active set [0]."}},
+      {"warm_start",
+       {OT_BOOL,
+        "Start from the primal solution and active set of the previous successful call "
+        "on the same memory object, ignoring x0, lam_x0 and lam_a0, and reuse its "
+        "QR factorization for as long as the KKT matrix is unchanged [false]. "
+        "Not supported in generated code."}}
      }
   };
 
@@ -104,6 +110,7 @@ namespace casadi {
     print_header_ = true;
     print_info_ = true;
     print_lincomb_ = false;
+    warm_start_ = false;
 
     // Read user options
     for (auto&& op : opts) {
@@ -123,6 +130,8 @@ namespace casadi {
         print_info_ = op.second;
       } else if (op.first=="print_lincomb") {
         print_lincomb_ = op.second;
+      } else if (op.first=="warm_start") {
+        warm_start_ = op.second;
       }
     }
 
@@ -177,6 +186,16 @@ namespace casadi {
     if (Conic::init_mem(mem)) return 1;
     auto m = static_cast<QrqpMemory*>(mem);
     m->return_status = "";
+    m->has_prev = false;
+    m->warm_started = false;
+    m->n_active_kept = 0;
+    if (warm_start_) {
+      m->prev_z.resize(nx_);
+      m->prev_lam.resize(nx_ + na_);
+      m->prev_kkt.resize(kkt_.nnz());
+      m->prev_vr.resize(sp_v_.nnz() + sp_r_.nnz());
+      m->prev_beta.resize(nx_ + na_);
+    }
     return 0;
   }
 
@@ -199,6 +218,15 @@ namespace casadi {
     casadi_fill(d.z+nx_, na_, nan);
     casadi_copy(d_qp.lam_x0, nx_, d.lam);
     casadi_copy(d_qp.lam_a0, na_, d.lam+nx_);
+    // Warm start from the previous solution
+    m->warm_started = warm_start_ && m->has_prev;
+    if (m->warm_started) {
+      casadi_copy(get_ptr(m->prev_z), nx_, d.z);
+      casadi_copy(get_ptr(m->prev_lam), nx_ + na_, d.lam);
+      d.prev_kkt = get_ptr(m->prev_kkt);
+      d.prev_vr = get_ptr(m->prev_vr);
+      d.prev_beta = get_ptr(m->prev_beta);
+    }
 
     // Reset solver
     if (casadi_qrqp_reset(&d)) return 1;
@@ -248,11 +276,31 @@ namespace casadi {
         m->return_status = "Printing error";
         break;
     }
+    // Inequality constraints kept active from the warm start
+    m->n_active_kept = 0;
+    if (m->warm_started) {
+      for (casadi_int i=0; i<nx_+na_; ++i) {
+        if (d.neverzero[i]) continue;
+        if (m->prev_lam[i]>0 ? d.lam[i]>0 : m->prev_lam[i]<0 && d.lam[i]<0) m->n_active_kept++;
+      }
+    }
+    // Store solution and factorization for the next call
+    if (warm_start_) {
+      m->has_prev = d.status == QP_SUCCESS;
+      if (m->has_prev) {
+        casadi_copy(d.z, nx_, get_ptr(m->prev_z));
+        casadi_copy(d.lam, nx_ + na_, get_ptr(m->prev_lam));
+        casadi_copy(d.nz_kkt, kkt_.nnz(), get_ptr(m->prev_kkt));
+        casadi_copy(d.nz_v, sp_v_.nnz() + sp_r_.nnz(), get_ptr(m->prev_vr));
+        casadi_copy(d.beta, nx_ + na_, get_ptr(m->prev_beta));
+      }
+    }
     // Get solution
     casadi_copy(&d.f, 1, d_qp.f);
     casadi_copy(d.z, nx_, d_qp.x);
     casadi_copy(d.lam, nx_, d_qp.lam_x);
     casadi_copy(d.lam+nx_, na_, d_qp.lam_a);
+    d_qp.iter_count = d.iter;
     // Return
     if (verbose_) casadi_warning(m->return_status);
     m->d_qp.success = d.status == QP_SUCCESS;
@@ -348,11 +396,17 @@ namespace casadi {
     Dict stats = Conic::get_stats(mem);
     auto m = static_cast<QrqpMemory*>(mem);
     stats["return_status"] = m->return_status;
+    stats["n_factorizations"] = m->d.n_fact;
+    stats["n_factorizations_reused"] = m->d.n_reuse;
+    if (warm_start_) {
+      stats["warm_started"] = m->warm_started;
+      stats["n_active_kept"] = m->n_active_kept;
+    }
     return stats;
   }
 
   Qrqp::Qrqp(DeserializingStream& s) : Conic(s) {
-    s.version("Qrqp", 1);
+    int version = s.version("Qrqp", 1, 2);
     s.unpack("Qrqp::AT", AT_);
     s.unpack("Qrqp::kkt", kkt_);
     s.unpack("Qrqp::sp_v", sp_v_);
@@ -363,6 +417,11 @@ namespace casadi {
     s.unpack("Qrqp::print_header", print_header_);
     s.unpack("Qrqp::print_info", print_info_);
     s.unpack("Qrqp::print_lincomb_", print_lincomb_);
+    if (version >= 2) {
+      s.unpack("Qrqp::warm_start", warm_start_);
+    } else {
+      warm_start_ = false;
+    }
     set_qrqp_prob();
     s.unpack("Qrqp::max_iter", p_.max_iter);
     s.unpack("Qrqp::min_lam", p_.min_lam);
@@ -373,7 +432,7 @@ namespace casadi {
   void Qrqp::serialize_body(SerializingStream &s) const {
     Conic::serialize_body(s);
 
-    s.version("Qrqp", 1);
+    s.version("Qrqp", 2);
     s.pack("Qrqp::AT", AT_);
     s.pack("Qrqp::kkt", kkt_);
     s.pack("Qrqp::sp_v", sp_v_);
@@ -384,6 +443,7 @@ namespace casadi {
     s.pack("Qrqp::print_header", print_header_);
     s.pack("Qrqp::print_info", print_info_);
     s.pack("Qrqp::print_lincomb_", print_lincomb_);
+    s.pack("Qrqp::warm_start", warm_start_);
     s.pack("Qrqp::max_iter", p_.max_iter);
     s.pack("Qrqp::min_lam", p_.min_lam);
     s.pack("Qrqp::constr_viol_tol", p_.constr_viol_tol);
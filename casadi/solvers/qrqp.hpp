@@ -45,6 +45,12 @@ namespace casadi {
     // Problem data structure
     casadi_qrqp_data<double> d;
     const char* return_status;
+    // Solution and KKT factorization of the last successful solve, for warm starting
+    bool has_prev;
+    std::vector<double> prev_z, prev_lam, prev_kkt, prev_vr, prev_beta;
+    // Was the last solve warm started, and how many active constraints were kept
+    bool warm_started;
+    casadi_int n_active_kept;
   };
 
   /** \brief \pluginbrief{Conic,qrqp}
@@ -118,7 +124,7 @@ namespace casadi {
     std::vector<casadi_int> prinv_, pc_;
     ///@{
     // Options
-    bool print_iter_, print_header_, print_info_, print_lincomb_;
+    bool print_iter_, print_header_, print_info_, print_lincomb_, warm_start_;
     ///@}
 
     void serialize_body(SerializingStream &s) const override;
@@ -27,6 +27,7 @@
 #include "casadi/core/casadi_misc.hpp"
 #include "casadi/core/casadi_meta.hpp"
 #include "casadi/core/casadi_logger.hpp"
+#include "casadi/core/thread_pool.hpp"
 #include <fstream>
 
 // Set default object file suffix
@@ -57,14 +58,18 @@ namespace casadi {
   ShellCompiler::ShellCompiler(const std::string& name) :
     ImporterInternal(name) {
       handle_ = nullptr;
+      cache_hit_ = false;
   }
 
   ShellCompiler::~ShellCompiler() {
     if (handle_) close_shared_library(handle_);
 
-    if (cleanup_) {
+    if (cleanup_ && !cache_hit_) {
       if (remove(bin_name_.c_str())) casadi_warning("Failed to remove " + bin_name_);
       if (remove(obj_name_.c_str())) casadi_warning("Failed to remove " + obj_name_);
+      for (const std::string& s : unit_obj_names_) {
+        if (remove(s.c_str())) casadi_warning("Failed to remove " + s);
+      }
       for (const std::string& s : extra_suffixes_) {
         std::string name = base_name_+s;
         remove(name.c_str());
@@ -211,24 +216,66 @@ namespace casadi {
     }
 #endif // _WIN32
 
-    // Construct the compiler command
-    std::stringstream cccmd;
-    cccmd << compiler;
-    for (auto i=compiler_flags.begin(); i!=compiler_flags.end(); ++i) {
-      cccmd << " " << *i;
+    std::vector<std::string> search_paths = get_search_paths();
+
+    // Compiler configuration, excluding file names
+    std::stringstream config;
+    config << compiler << " " << join(compiler_flags, " ") << " " << compiler_setup << " "
+           << compiler_output_flag << "\n" << linker << " " << linker_output_flag << " "
+           << join(linker_flags, " ") << " " << linker_setup;
+
+    // Look up the compiled library in the cache
+    std::string key;
+    if (!cache_directory_.empty()) {
+      key = cache_key(config.str());
+      if (cache_get(key, SHARED_LIBRARY_SUFFIX, lib_name_)) {
+        cache_hit_ = true;
+        // Remove placeholder created for the temporary object file
+        if (temp_suffix) remove(obj_name_.c_str());
+#ifndef _WIN32
+        if (lib_name_.at(0)!='/') lib_name_ = "./" + lib_name_;
+#endif // _WIN32
+        handle_ = open_shared_library(lib_name_, search_paths, "ShellCompiler::init");
+        return;
+      }
+    }
+
+    // Source files and corresponding object files
+    std::vector<std::string> sources = units(), objects;
+    sources.insert(sources.begin(), name_);
+    objects.push_back(obj_name_);
+    for (casadi_int k=1; k<sources.size(); ++k) {
+      unit_obj_names_.push_back(base_name_ + "_" + str(k) + suffix);
+      objects.push_back(unit_obj_names_.back());
     }
-    cccmd << " " << compiler_setup;
 
-    // C/C++ source file
-    cccmd << " " << name_;
+    // Construct the compiler commands
+    std::vector<std::string> cccmds;
+    for (casadi_int k=0; k<sources.size(); ++k) {
+      std::stringstream cccmd;
+      cccmd << compiler;
+      for (auto i=compiler_flags.begin(); i!=compiler_flags.end(); ++i) {
+        cccmd << " " << *i;
+      }
+      cccmd << " " << compiler_setup;
 
-    // Temporary object file
-    cccmd << " " + compiler_output_flag << obj_name_;
+      // C/C++ source file
+      cccmd << " " << sources[k];
 
-    // Compile into an object
-    if (verbose_) casadi_message("calling \"" + cccmd.str() + "\"");
-    if (system(cccmd.str().c_str())) {
-      casadi_error("Compilation failed. Tried \"" + cccmd.str() + "\"");
+      // Temporary object file
+      cccmd << " " + compiler_output_flag << objects[k];
+      cccmds.push_back(cccmd.str());
+    }
+
+    // Compile into objects, in parallel if there are multiple translation units
+    std::vector<int> failed(cccmds.size(), 0);
+    ThreadPool::instance().run(cccmds.size(), [&](casadi_int k) {
+      if (verbose_) casadi_message("calling \"" + cccmds[k] + "\"");
+      failed[k] = system(cccmds[k].c_str())!=0;
+      return failed[k];
+    }, 1);
+    for (casadi_int k=0; k<cccmds.size(); ++k) {
+      if (failed[k]) casadi_error("Compilation failed. Tried \"" + cccmds[k] + "\"");
     }
 
     // Link step
@@ -236,7 +283,8 @@ namespace casadi {
     ldcmd << linker;
 
     // Temporary file
-    ldcmd << " " << obj_name_ << " " + linker_output_flag + bin_name_;
+    for (auto&& obj : objects) ldcmd << " " << obj;
+    ldcmd << " " + linker_output_flag + bin_name_;
 
     // Add flags
     for (auto i=linker_flags.begin(); i!=linker_flags.end(); ++i) {
@@ -250,13 +298,24 @@ namespace casadi {
       casadi_error("Linking failed. Tried \"" + ldcmd.str() + "\"");
     }
 
-    std::vector<std::string> search_paths = get_search_paths();
-    handle_ = open_shared_library(bin_name_, search_paths, "ShellCompiler::init");
+    // Publish in the cache and load the cached copy
+    lib_name_ = bin_name_;
+    if (!key.empty()) {
+      std::string cached = cache_put(key, SHARED_LIBRARY_SUFFIX, bin_name_);
+      if (!cached.empty()) {
+        lib_name_ = cached;
+#ifndef _WIN32
+        if (lib_name_.at(0)!='/') lib_name_ = "./" + lib_name_;
+#endif // _WIN32
+      }
+    }
+
+    handle_ = open_shared_library(lib_name_, search_paths, "ShellCompiler::init");
 
   }
 
   std::string ShellCompiler::library() const {
-    return bin_name_;
+    return lib_name_;
   }
 
   signal_t ShellCompiler::get_function(const std::string& symname) {
@@ -97,12 +97,21 @@ namespace casadi {
     /// Temporary file
     std::string obj_name_;
 
+    /// Object files of additional translation units
+    std::vector<std::string> unit_obj_names_;
+
     /// Extra files
     std::vector<std::string> extra_suffixes_;
 
     /// Cleanup temporary files when unloading
     bool cleanup_;
 
+    /// Loaded shared library, either bin_name_ or a cached copy
+    std::string lib_name_;
+
+    /// Loaded from the cache without compiling
+    bool cache_hit_;
+
     // Shared library handle
     handle_t handle_;
   };
@@ -101,6 +101,11 @@ const Options Sqpmethod::options_
     {"lbfgs_memory",
       {OT_INT,
       "Size of L-BFGS memory."}},
+    {"block_bfgs",
+      {OT_BOOL,
+      "With hessian_approximation=limited-memory, detect the block-diagonal structure "
+      "of the Lagrangian Hessian and apply an independent damped BFGS update to each "
+      "diagonal block instead of the limited-memory update [false]."}},
     {"print_header",
       {OT_BOOL,
       "Print the header with problem statistics"}},
@@ -166,6 +171,7 @@ void Sqpmethod::init(const Dict& opts) {
   beta_ = 0.8;
   merit_memsize_ = 4;
   lbfgs_memory_ = 10;
+  block_bfgs_ = false;
   tol_pr_ = 1e-6;
   tol_du_ = 1e-6;
   std::string hessian_approximation = "exact";
@@ -202,6 +208,8 @@ void Sqpmethod::init(const Dict& opts) {
       merit_memsize_ = op.second;
     } else if (op.first=="lbfgs_memory") {
       lbfgs_memory_ = op.second;
+    } else if (op.first=="block_bfgs") {
+      block_bfgs_ = op.second;
     } else if (op.first=="tol_pr") {
       tol_pr_ = op.second;
     } else if (op.first=="tol_du") {
@@ -263,6 +271,10 @@ void Sqpmethod::init(const Dict& opts) {
 
   // Use exact Hessian?
   exact_hessian_ = hessian_approximation =="exact";
+  casadi_assert(exact_hessian_ || lbfgs_memory_ > 0,
+    "Option 'lbfgs_memory' must be positive, got " + str(lbfgs_memory_) + ".");
+  casadi_assert(!(exact_hessian_ && block_bfgs_),
+    "Option 'block_bfgs' requires hessian_approximation=limited-memory.");
 
   convexify_ = false;
 
@@ -292,6 +304,10 @@ void Sqpmethod::init(const Dict& opts) {
       opts["verbose"] = verbose_;
       Hsp_ = Convexify::setup(convexify_data_, Hsp_, opts);
     }
+  } else if (block_bfgs_) {
+    Hsp_ = hess_l_blocks(bfgs_block_);
+    bfgs_nblocks_ = bfgs_block_.empty() ? 0
+      : *std::max_element(bfgs_block_.begin(), bfgs_block_.end()) + 1;
   } else {
     Hsp_ = Sparsity::dense(nx_, nx_);
   }
@@ -325,7 +341,11 @@ void Sqpmethod::init(const Dict& opts) {
 
   // BFGS?
   if (!exact_hessian_) {
-    alloc_w(2*nx_); // casadi_bfgs
+    if (block_bfgs_) {
+      alloc_w(2*nx_ + 3*bfgs_nblocks_); // casadi_bfgs_block
+    } else {
+      alloc_w(2*nx_); // casadi_bfgs
+    }
   }
 
   // Header
@@ -334,6 +354,8 @@ void Sqpmethod::init(const Dict& opts) {
     print("This is casadi::Sqpmethod.\n");
     if (exact_hessian_) {
       print("Using exact Hessian\n");
+    } else if (block_bfgs_) {
+      print("Using blockwise BFGS Hessian approximation, %d blocks\n", bfgs_nblocks_);
     } else {
       print("Using limited memory BFGS Hessian approximation\n");
     }
@@ -522,6 +544,17 @@ int Sqpmethod::solve(void* mem) const {
         ScopedTiming tic(m->fstats.at("convexify"));
         if (convexify_eval(&convexify_data_.config, d->Bk, d->Bk, m->iw, m->w)) return 1;
       }
+    } else if (block_bfgs_) {
+      ScopedTiming tic(m->fstats.at("BFGS"));
+      if (m->iter_count==0) {
+        // Initialize BFGS
+        casadi_fill(d->Bk, Hsp_.nnz(), 1.);
+        casadi_bfgs_reset(Hsp_, d->Bk);
+      } else {
+        // Update each diagonal block of the Hessian approximation
+        casadi_bfgs_block(Hsp_, d->Bk, d->dx, d->gLag, d->gLag_old,
+          bfgs_nblocks_, get_ptr(bfgs_block_), m->w);
+      }
     } else if (m->iter_count==0) {
       ScopedTiming tic(m->fstats.at("BFGS"));
       // Initialize BFGS
@@ -1127,6 +1160,16 @@ void Sqpmethod::codegen_body(CodeGenerator& g) const {
       std::string ret = g.convexify_eval(convexify_data_, "d->Bk", "d->Bk", "d->iw", "d->w");
       g << "if (" << ret << ") return 1;\n";
     }
+  } else if (block_bfgs_) {
+    g << "if (iter_count==0) {\n";
+    g.comment("Initialize BFGS");
+    g << g.fill("d->Bk", Hsp_.nnz(), "1.") << "\n";
+    g << "casadi_bfgs_reset(p.sp_h, d->Bk);\n";
+    g << "} else {\n";
+    g.comment("Update each diagonal block of the Hessian approximation");
+    g << "casadi_bfgs_block(p.sp_h, d->Bk, d->dx, d->gLag, d->gLag_old, "
+      << bfgs_nblocks_ << ", " << g.constant(bfgs_block_) << ", d->w);\n";
+    g << "}\n";
   } else {
     g << "if (iter_count==0) {\n";
     g.comment("Initialize BFGS");
@@ -1537,7 +1580,7 @@ Dict Sqpmethod::get_stats(void* mem) const {
 }
 
 Sqpmethod::Sqpmethod(DeserializingStream& s) : Nlpsol(s) {
-  int version = s.version("Sqpmethod", 1, 3);
+  int version = s.version("Sqpmethod", 1, 4);
   s.unpack("Sqpmethod::qpsol", qpsol_);
   if (version>=3) {
     s.unpack("Sqpmethod::qpsol_ela", qpsol_ela_);
@@ -1546,6 +1589,14 @@ Sqpmethod::Sqpmethod(DeserializingStream& s) : Nlpsol(s) {
   s.unpack("Sqpmethod::max_iter", max_iter_);
   s.unpack("Sqpmethod::min_iter", min_iter_);
   s.unpack("Sqpmethod::lbfgs_memory", lbfgs_memory_);
+  if (version>=4) {
+    s.unpack("Sqpmethod::block_bfgs", block_bfgs_);
+    s.unpack("Sqpmethod::bfgs_block", bfgs_block_);
+    s.unpack("Sqpmethod::bfgs_nblocks", bfgs_nblocks_);
+  } else {
+    block_bfgs_ = false;
+    bfgs_nblocks_ = 0;
+  }
   s.unpack("Sqpmethod::tol_pr_", tol_pr_);
   s.unpack("Sqpmethod::tol_du_", tol_du_);
   s.unpack("Sqpmethod::min_step_size_", min_step_size_);
@@ -1611,13 +1662,16 @@ Sqpmethod::Sqpmethod(DeserializingStream& s) : Nlpsol(s) {
 
 void Sqpmethod::serialize_body(SerializingStream &s) const {
   Nlpsol::serialize_body(s);
-  s.version("Sqpmethod", 3);
+  s.version("Sqpmethod", 4);
   s.pack("Sqpmethod::qpsol", qpsol_);
   s.pack("Sqpmethod::qpsol_ela", qpsol_ela_);
   s.pack("Sqpmethod::exact_hessian", exact_hessian_);
   s.pack("Sqpmethod::max_iter", max_iter_);
   s.pack("Sqpmethod::min_iter", min_iter_);
   s.pack("Sqpmethod::lbfgs_memory", lbfgs_memory_);
+  s.pack("Sqpmethod::block_bfgs", block_bfgs_);
+  s.pack("Sqpmethod::bfgs_block", bfgs_block_);
+  s.pack("Sqpmethod::bfgs_nblocks", bfgs_nblocks_);
   s.pack("Sqpmethod::tol_pr_", tol_pr_);
   s.pack("Sqpmethod::tol_du_", tol_du_);
   s.pack("Sqpmethod::min_step_size_", min_step_size_);
@@ -130,6 +130,13 @@ namespace casadi {
     /// Memory size of L-BFGS method
     casadi_int lbfgs_memory_;
 
+    /// Blockwise BFGS updates
+    bool block_bfgs_;
+
+    /// Block index of each variable, number of blocks for blockwise BFGS
+    std::vector<casadi_int> bfgs_block_;
+    casadi_int bfgs_nblocks_;
+
     /// Tolerance of primal and dual infeasibility
     double tol_pr_, tol_du_;
 
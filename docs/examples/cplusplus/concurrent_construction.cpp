@@ -0,0 +1,103 @@
+/*
+ *    MIT No Attribution
+ *
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl, KU Leuven.
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ *    software and associated documentation files (the "Software"), to deal in the Software
+ *    without restriction, including without limitation the rights to use, copy, modify,
+ *    merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ *    permit persons to whom the Software is furnished to do so.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ *    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+/** \brief Construction of expressions and functions from several threads
+ * NOTE: Example is mainly intended for developers of CasADi.
+ * Requires CasADi to be built WITH_THREAD.
+ * Every thread builds its own variant of a model, sharing a dynamics
+ * function, symbols and constants with the other threads, then generates
+ * derivatives and evaluates the result. The results are checked against
+ * the same construction done serially.
+ *
+ * Usage: concurrent_construction [n_threads]
+ */
+
+#include "casadi/casadi.hpp"
+#include <thread>
+#include <cmath>
+#include <cstdlib>
+
+using namespace casadi;
+
+// Build and evaluate model variant k, returns a checksum
+double variant(const Function& ode, const MX& x0, casadi_int k) {
+  // SX: Runge-Kutta step with a variant dependent step size
+  SX x = SX::sym("x", 2), u = SX::sym("u");
+  double h = 0.1/(1 + k % 3);
+  SX xk = x;
+  for (casadi_int i=0; i<20; ++i) {
+    SX k1 = ode(std::vector<SX>{xk, u}).at(0);
+    SX k2 = ode(std::vector<SX>{xk + h/2*k1, u}).at(0);
+    SX k3 = ode(std::vector<SX>{xk + h/2*k2, u}).at(0);
+    SX k4 = ode(std::vector<SX>{xk + h*k3, u}).at(0);
+    xk += h/6*(k1 + 2*k2 + 2*k3 + k4);
+  }
+  Function F("F_" + str(k), {x, u}, {xk, jacobian(xk, x)});
+
+  // MX: chain the step, calling the SX function
+  MX u_mx = MX::sym("u", 5);
+  MX xm = x0;
+  for (casadi_int i=0; i<5; ++i) xm = F(std::vector<MX>{xm, u_mx(i)}).at(0);
+  MX J = dot(xm, xm) + 0.5*k*dot(u_mx, u_mx);
+  Function G("G_" + str(k), {x0, u_mx}, {J, gradient(J, u_mx)});
+
+  // Derivatives of the shared dynamics are cached in the shared instance
+  Function H = G.forward(1);
+
+  std::vector<DM> r = G(std::vector<DM>{DM({1, 0}), DM::ones(5, 1)});
+  std::vector<DM> d = H(std::vector<DM>{DM({1, 0}), DM::ones(5, 1), r[0], r[1],
+    DM({0, 1}), DM::ones(5, 1)});
+  return static_cast<double>(r[0]) + static_cast<double>(sum1(r[1]))
+    + static_cast<double>(d[0]);
+}
+
+int main(int argc, char* argv[]) {
+  casadi_int n_threads = argc>1 ? std::atoi(argv[1]) : 8;
+  casadi_int n_variants = 4*n_threads;
+
+  // Shared between all threads
+  SX x = SX::sym("x", 2), u = SX::sym("u");
+  Function ode("ode", {x, u}, {vertcat(x(1), -sin(x(0)) - 0.1*x(1) + u)});
+  MX x0 = MX::sym("x0", 2);
+
+  // Serial reference
+  std::vector<double> ref(n_variants);
+  for (casadi_int k=0; k<n_variants; ++k) ref[k] = variant(ode, x0, k);
+
+  // Concurrent construction
+  std::vector<double> res(n_variants);
+  std::vector<std::thread> threads;
+  for (casadi_int t=0; t<n_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (casadi_int k=t; k<n_variants; k+=n_threads) res[k] = variant(ode, x0, k);
+    });
+  }
+  for (auto&& th : threads) th.join();
+
+  for (casadi_int k=0; k<n_variants; ++k) {
+    if (std::fabs(res[k]-ref[k]) > 1e-12*(1+std::fabs(ref[k]))) {
+      uerr() << "Variant " << k << ": " << res[k] << " != " << ref[k] << std::endl;
+      return 1;
+    }
+  }
+  uout() << n_variants << " variants built on " << n_threads << " threads" << std::endl;
+  return 0;
+}
@@ -0,0 +1,127 @@
+/*
+ *    MIT No Attribution
+ *
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl, KU Leuven.
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ *    software and associated documentation files (the "Software"), to deal in the Software
+ *    without restriction, including without limitation the rights to use, copy, modify,
+ *    merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ *    permit persons to whom the Software is furnished to do so.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ *    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+/** \brief Tree-parallel numeric factorization with the built-in linear solvers
+ * NOTE: Example is mainly intended for developers of CasADi.
+ * Times the numeric factorization of the ldl and qr linear solvers with
+ * an increasing number of threads (option max_threads) for
+ *  - the quasi-definite KKT matrix of a chain of dense stages, as in the test suite
+ *  - the KKT matrix of the same chain, coupled by parameters
+ *  - a 2D Laplacian on a square grid
+ *
+ * Usage: factorization_benchmark [max_threads]
+ */
+
+#include "casadi/casadi.hpp"
+#include <chrono>
+#include <cstdlib>
+
+using namespace casadi;
+
+// Quasi-definite KKT matrix of a chain of N dense stages with nx states each
+DM kkt_chain(casadi_int N, casadi_int nx, casadi_int np) {
+  std::vector<casadi_int> row, col;
+  std::vector<double> val;
+  auto add = [&](casadi_int i, casadi_int j, double v) {
+    row.push_back(i); col.push_back(j); val.push_back(v);
+    if (i!=j) {
+      row.push_back(j); col.push_back(i); val.push_back(v);
+    }
+  };
+  casadi_int nz = N*nx + np, ng = (N-1)*nx;
+  for (casadi_int k=0; k<N; ++k) {
+    for (casadi_int i=0; i<nx; ++i) {
+      for (casadi_int j=0; j<i; ++j) add(k*nx+i, k*nx+j, std::rand()/(2.*RAND_MAX));
+      add(k*nx+i, k*nx+i, 2*nx);
+    }
+  }
+  for (casadi_int i=0; i<np; ++i) add(N*nx+i, N*nx+i, 1);
+  for (casadi_int k=0; k+1<N; ++k) {
+    for (casadi_int i=0; i<nx; ++i) {
+      casadi_int c = nz + k*nx + i;
+      for (casadi_int j=0; j<nx; ++j) add(c, k*nx+j, std::rand()/(1.*RAND_MAX));
+      add(c, (k+1)*nx+i, -1);
+      for (casadi_int j=0; j<np; ++j) add(c, N*nx+j, std::rand()/(1.*RAND_MAX));
+      add(c, c, -1e-3);
+    }
+  }
+  return DM::triplet(row, col, val, nz+ng, nz+ng);
+}
+
+// 2D Laplacian on a k-by-k grid
+DM laplace2d(casadi_int k) {
+  std::vector<casadi_int> row, col;
+  std::vector<double> val;
+  for (casadi_int i=0; i<k; ++i) {
+    for (casadi_int j=0; j<k; ++j) {
+      casadi_int c = i*k+j;
+      row.push_back(c); col.push_back(c); val.push_back(4);
+      if (i>0) { row.push_back(c); col.push_back(c-k); val.push_back(-1);}
+      if (i+1<k) { row.push_back(c); col.push_back(c+k); val.push_back(-1);}
+      if (j>0) { row.push_back(c); col.push_back(c-1); val.push_back(-1);}
+      if (j+1<k) { row.push_back(c); col.push_back(c+1); val.push_back(-1);}
+    }
+  }
+  return DM::triplet(row, col, val, k*k, k*k);
+}
+
+void benchmark(const std::string& name, const DM& A, const std::string& solver,
+               const Dict& opts, casadi_int max_threads) {
+  DM b = DM::ones(A.size1());
+  double t_serial = 0;
+  for (casadi_int nt=1; nt<=max_threads; nt*=2) {
+    Dict opts_nt = opts;
+    opts_nt["max_threads"] = nt;
+    Linsol L("L", solver, A.sparsity(), opts_nt);
+    L.sfact(A);
+    L.nfact(A);
+    casadi_int rep = 10;
+    auto t0 = std::chrono::steady_clock::now();
+    for (casadi_int r=0; r<rep; ++r) L.nfact(A);
+    auto t1 = std::chrono::steady_clock::now();
+    double t = std::chrono::duration<double>(t1-t0).count()/rep;
+    if (nt==1) t_serial = t;
+    DM x = L.solve(A, b);
+    std::cout << name << ", " << solver << " " << str(opts) << ", n=" << A.size1()
+              << ", max_threads=" << nt << ": " << t*1e3 << " ms, speedup "
+              << t_serial/t << ", residual " << norm_inf(mtimes(A, x)-b) << std::endl;
+  }
+}
+
+int main(int argc, char* argv[]) {
+  casadi_int max_threads = argc>1 ? std::atoi(argv[1]) : 8;
+  GlobalOptions::setThreadPoolSize(max_threads);
+
+  DM kkt = kkt_chain(400, 20, 0);
+  DM kkt_param = kkt_chain(400, 20, 5);
+  DM lap = laplace2d(150);
+
+  for (bool supernodal : {false, true}) {
+    Dict opts = {{"supernodal", supernodal}};
+    benchmark("KKT", kkt, "ldl", opts, max_threads);
+    benchmark("KKT with parameters", kkt_param, "ldl", opts, max_threads);
+    benchmark("Laplacian", lap, "ldl", opts, max_threads);
+  }
+  benchmark("KKT", kkt, "qr", Dict(), max_threads);
+  benchmark("Laplacian", laplace2d(60), "qr", Dict(), max_threads);
+
+  return 0;
+}
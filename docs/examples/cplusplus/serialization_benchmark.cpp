@@ -0,0 +1,128 @@
+/*
+ *    MIT No Attribution
+ *
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl, KU Leuven.
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ *    software and associated documentation files (the "Software"), to deal in the Software
+ *    without restriction, including without limitation the rights to use, copy, modify,
+ *    merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ *    permit persons to whom the Software is furnished to do so.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ *    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+/** \brief Load time and memory of serialized Functions
+ * NOTE: Example is mainly intended for developers of CasADi.
+ * Saves a Function holding large sparse constants and a long SX algorithm,
+ * both in the default text encoding and in the binary encoding,
+ * and reports the time and resident memory needed to load each file.
+ *
+ * Usage: serialization_benchmark [n] [text|binary]
+ * When a format is given, only that file is loaded, such that the reported
+ * peak resident memory is not polluted by the other format.
+ */
+
+#include "casadi/casadi.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <unistd.h>
+#endif // _WIN32
+
+using namespace casadi;
+
+// Current resident memory in MB, if available
+double rss_current() {
+#ifndef _WIN32
+  std::ifstream statm("/proc/self/statm");
+  long pages, resident;
+  if (statm >> pages >> resident) {
+    return resident * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1024*1024);
+  }
+#endif // _WIN32
+  return -1;
+}
+
+// Peak resident memory in MB, if available
+double rss_peak() {
+#ifndef _WIN32
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage)==0) {
+#ifdef __APPLE__
+    return usage.ru_maxrss / (1024.*1024);
+#else
+    return usage.ru_maxrss / 1024.;
+#endif
+  }
+#endif // _WIN32
+  return -1;
+}
+
+// File size in MB
+double file_size(const std::string& fname) {
+  std::ifstream f(fname, std::ios::binary | std::ios::ate);
+  return f.tellg() / (1024.*1024);
+}
+
+void load(const std::string& fname, const DM& x0, const DM& ref) {
+  double rss0 = rss_current();
+  auto t0 = std::chrono::steady_clock::now();
+  Function f = Function::load(fname);
+  auto t1 = std::chrono::steady_clock::now();
+  double rss1 = rss_current();
+  DM r = f(std::vector<DM>{x0}).at(0);
+  casadi_assert(static_cast<double>(norm_inf(r-ref))==0, "Mismatch after loading " + fname);
+  std::cout << fname << ": " << file_size(fname) << " MB on disk, loaded in "
+            << std::chrono::duration<double>(t1-t0).count() << " s, "
+            << "resident memory +" << (rss1-rss0) << " MB, "
+            << "peak " << rss_peak() << " MB" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  casadi_int n = argc>1 ? std::stoll(argv[1]) : 100000;
+  std::string format = argc>2 ? argv[2] : "";
+
+  // Banded constant matrix
+  std::vector<casadi_int> row, col;
+  std::vector<double> val;
+  for (casadi_int k=0; k<n; ++k) {
+    for (casadi_int j=std::max<casadi_int>(k-5, 0); j<std::min(k+6, n); ++j) {
+      row.push_back(j);
+      col.push_back(k);
+      val.push_back(1./(1+k+j));
+    }
+  }
+  DM A = DM::triplet(row, col, val, n, n);
+
+  // MX Function with a large embedded constant and an SX Function with a long algorithm
+  MX x = MX::sym("x", n);
+  Function g("g", {x}, {sin(mtimes(A, x))});
+  Function h = g.expand();
+  Function f("f", {x}, {g(x).at(0) + h(x).at(0)});
+
+  DM x0 = DM::ones(n);
+  DM ref = f(std::vector<DM>{x0}).at(0);
+
+  if (format.empty() || format=="text") f.save("benchmark_text.casadi");
+  if (format.empty() || format=="binary") f.save("benchmark_binary.casadi", {{"binary", true}});
+
+  if (format.empty() || format=="text") load("benchmark_text.casadi", x0, ref);
+  if (format.empty() || format=="binary") load("benchmark_binary.casadi", x0, ref);
+
+  std::remove("benchmark_text.casadi");
+  std::remove("benchmark_binary.casadi");
+
+  return 0;
+}
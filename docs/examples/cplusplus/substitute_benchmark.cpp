@@ -0,0 +1,82 @@
+/*
+ *    MIT No Attribution
+ *
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl, KU Leuven.
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ *    software and associated documentation files (the "Software"), to deal in the Software
+ *    without restriction, including without limitation the rights to use, copy, modify,
+ *    merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ *    permit persons to whom the Software is furnished to do so.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ *    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+/** \brief Substitution in large MX graphs
+ * NOTE: Example is mainly intended for developers of CasADi.
+ * Times MX::substitute and MX::graph_substitute on a chain of N stages, each
+ * with its own parameter, replacing the parameter of the last stage, i.e.
+ * with a cone of constant size. The reference is the symbolic evaluation of
+ * a temporary MXFunction, which substitute used for all inputs before.
+ * Both find the cone with one search over the graph and are hence linear
+ * in N, the difference is the cost of sorting the graph into a Function.
+ * MXSubstitution indexes the graph once, after which each substitution only
+ * visits the cone and takes constant time.
+ *
+ * Usage: substitute_benchmark [N_max]
+ */
+
+#include "casadi/casadi.hpp"
+#include <chrono>
+#include <cstdlib>
+
+using namespace casadi;
+
+// Average time of a number of calls, in ms
+template<typename F>
+double timing(F f, casadi_int rep) {
+  auto t0 = std::chrono::steady_clock::now();
+  for (casadi_int r=0; r<rep; ++r) f();
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(t1-t0).count()/rep*1e3;
+}
+
+int main(int argc, char* argv[]) {
+  casadi_int N_max = argc>1 ? std::atoi(argv[1]) : 100000;
+
+  for (casadi_int N=1000; N<=N_max; N*=10) {
+    MX x = MX::sym("x", 4);
+    MX A = MX::sym("A", 4, 4);
+    std::vector<MX> p(N);
+    MX e = x;
+    for (casadi_int k=0; k<N; ++k) {
+      p[k] = MX::sym("p" + str(k), 4);
+      e = mtimes(A, sin(e)) + p[k];
+    }
+    std::vector<MX> ex = {e, dot(e, e)};
+    std::vector<MX> v = {p.back()}, vdef = {2*x};
+
+    casadi_int rep = std::max(casadi_int(1), 100000/N);
+    double t_subs = timing([&]() { substitute(ex, v, vdef);}, rep);
+    double t_graph = timing([&]() { graph_substitute(ex, v, vdef);}, rep);
+    double t_fun = timing([&]() {
+      Function F("tmp_substitute", v, ex, Dict{{"max_io", 0}, {"allow_free", true}});
+      F(vdef);
+    }, rep);
+    double t_index = timing([&]() { MXSubstitution s(ex);}, 1);
+    MXSubstitution s(ex);
+    double t_indexed = timing([&]() { s.substitute(v, vdef);}, 1000);
+    std::cout << "N=" << N << ": substitute " << t_subs << " ms, graph_substitute "
+              << t_graph << " ms, MXFunction " << t_fun << " ms, speedup "
+              << t_fun/t_subs << ", MXSubstitution " << t_index << " ms once, then "
+              << t_indexed << " ms" << std::endl;
+  }
+  return 0;
+}
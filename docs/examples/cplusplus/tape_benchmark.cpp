@@ -0,0 +1,73 @@
+/*
+ *    MIT No Attribution
+ *
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl, KU Leuven.
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ *    software and associated documentation files (the "Software"), to deal in the Software
+ *    without restriction, including without limitation the rights to use, copy, modify,
+ *    merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ *    permit persons to whom the Software is furnished to do so.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ *    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ *    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ *    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+/** \brief Numerical evaluation of large SX algorithms with the compact tape
+ * NOTE: Example is mainly intended for developers of CasADi.
+ * Times the numerical evaluation of SXFunctions with 1e5 instructions and up,
+ * with and without the option compact_tape. The expression mixes multiply-add
+ * chains, outputs and builtin functions, as obtained from e.g. a discretized
+ * ODE. Only numerical evaluation uses the tape.
+ *
+ * Usage: tape_benchmark [n_max], e.g. tape_benchmark 10000000
+ */
+
+#include "casadi/casadi.hpp"
+#include <chrono>
+#include <cstdlib>
+
+using namespace casadi;
+
+int main(int argc, char* argv[]) {
+  casadi_int n_max = argc>1 ? std::atoi(argv[1]) : 1000000;
+
+  for (casadi_int n=100000; n<=n_max; n*=10) {
+    // Integration of a small ODE with a fixed step, about 25 instructions per step
+    SX x = SX::sym("x", 4), u = SX::sym("u");
+    SX xk = x;
+    std::vector<SX> traj;
+    casadi_int n_step = n/25;
+    for (casadi_int k=0; k<n_step; ++k) {
+      SX dx = vertcat(xk(1), -sin(xk(0)) + 0.1*xk(1)*xk(2) + u,
+                      xk(3), 0.5*xk(0)/(1 + xk(2)*xk(2)) - 0.2*xk(3));
+      xk = xk + 0.01*dx;
+      if (k % 100 == 0) traj.push_back(xk);
+    }
+    traj.push_back(xk);
+    SX out = vertcat(traj);
+
+    DM x0 = DM({0.1, 0.2, 0.3, 0.4}), u0 = 0.5;
+    double t_ref = 0;
+    for (bool compact_tape : {false, true}) {
+      Function f("f", {x, u}, {out}, {{"compact_tape", compact_tape}});
+      std::vector<DM> r = f(std::vector<DM>{x0, u0});
+      casadi_int rep = std::max(casadi_int(1), casadi_int(10000000)/n);
+      auto t0 = std::chrono::steady_clock::now();
+      for (casadi_int i=0; i<rep; ++i) r = f(std::vector<DM>{x0, u0});
+      auto t1 = std::chrono::steady_clock::now();
+      double t = std::chrono::duration<double>(t1-t0).count()/rep;
+      if (!compact_tape) t_ref = t;
+      std::cout << f.n_instructions() << " instructions, compact_tape=" << compact_tape
+                << ": " << t*1e3 << " ms, " << t*1e9/f.n_instructions()
+                << " ns/instruction, speedup " << t_ref/t << std::endl;
+    }
+  }
+  return 0;
+}
@@ -4436,6 +4436,7 @@ namespace casadi {
 %include <casadi/core/nlp_tools.hpp>
 %include <casadi/core/tools.hpp>
 %include <casadi/core/nlp_builder.hpp>
+%include <casadi/core/mx_substitution.hpp>
 %include <casadi/core/dae_builder.hpp>
 %include <casadi/core/xml_file.hpp>
 
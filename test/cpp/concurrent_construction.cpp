@@ -0,0 +1,101 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/** \brief Concurrent construction of SX and MX Functions
+
+    Several threads build Functions over the same symbols, constants and
+    shared subexpressions, and evaluate them. The results must match a
+    serial construction. Run under ThreadSanitizer to detect data races.
+*/
+
+#include "casadi/casadi.hpp"
+#include <thread>
+#include <cmath>
+
+using namespace casadi;
+
+// Shared between all threads
+struct Shared {
+  SX x, p;
+  SX e;
+  MX X, P;
+  MX E;
+};
+
+// Build and evaluate variant k, returns a checksum
+double variant(const Shared& s, casadi_int k) {
+  // SX: extend the shared subexpression, reusing interned constants
+  SX ek = s.e;
+  for (casadi_int i=0; i<k % 5 + 1; ++i) ek = sin(ek + 2.5) * s.p + 3;
+  Function f("f_" + str(k), {s.x, s.p}, {ek, jacobian(ek, s.x)});
+
+  // MX: extend the shared subexpression and call the SX Function
+  MX Ek = s.E;
+  for (casadi_int i=0; i<k % 3 + 1; ++i) {
+    Ek = f(std::vector<MX>{Ek + 2.5, s.P}).at(0);
+  }
+  Function g("g_" + str(k), {s.X, s.P}, {dot(Ek, Ek), gradient(dot(Ek, Ek), s.X)});
+
+  DM x0 = DM({0.1, 0.2, 0.3}), p0 = 0.7;
+  std::vector<DM> rf = f(std::vector<DM>{x0, p0});
+  std::vector<DM> rg = g(std::vector<DM>{x0, p0});
+  return static_cast<double>(sum1(rf[0])) + static_cast<double>(sum2(sum1(rf[1])))
+    + static_cast<double>(rg[0]) + static_cast<double>(sum1(rg[1]));
+}
+
+int main() {
+  Shared s;
+  s.x = SX::sym("x", 3);
+  s.p = SX::sym("p");
+  s.e = s.x;
+  for (casadi_int i=0; i<50; ++i) s.e = cos(s.e * 2.5) + s.p * s.e;
+  s.X = MX::sym("X", 3);
+  s.P = MX::sym("P");
+  s.E = s.X;
+  for (casadi_int i=0; i<20; ++i) s.E = cos(s.E * 2.5) + s.P * s.E;
+
+  // Serial reference
+  casadi_int n_threads = 8, n_variants = 64;
+  std::vector<double> ref(n_variants);
+  for (casadi_int k=0; k<n_variants; ++k) ref[k] = variant(s, k);
+
+  // Concurrent construction
+  std::vector<double> res(n_variants);
+  std::vector<std::thread> threads;
+  for (casadi_int t=0; t<n_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (casadi_int k=t; k<n_variants; k+=n_threads) res[k] = variant(s, k);
+    });
+  }
+  for (auto&& th : threads) th.join();
+
+  for (casadi_int k=0; k<n_variants; ++k) {
+    if (!(std::fabs(res[k]-ref[k]) <= 1e-12*(1+std::fabs(ref[k])))) {
+      uerr() << "Variant " << k << ": " << res[k] << " != " << ref[k] << std::endl;
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,66 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2023 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            KU Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/** \brief Bookkeeping of the node pools
+
+    Building an expression graph takes nodes from the pools, destroying it
+    must return all of them, and the slabs that were allocated for it.
+*/
+
+#include "casadi/casadi.hpp"
+#include "casadi/core/node_pool.hpp"
+
+using namespace casadi;
+
+// Build and destroy SX and MX graphs with n operations and their Functions
+casadi_int build(casadi_int n) {
+  SX x = SX::sym("x");
+  MX X = MX::sym("X", 3);
+  SX e = x;
+  for (casadi_int i=0; i<n; ++i) e = sin(e) * x + 0.5 * i;
+  MX E = X;
+  for (casadi_int i=0; i<n/10; ++i) E = sin(E) * X;
+  Function f("f", {x}, {e}), F("F", {X}, {E});
+  return NodePool::n_live();
+}
+
+int main() {
+  // Every size class keeps one empty slab around, make sure it exists
+  build(100);
+  casadi_int n_live = NodePool::n_live(), n_slabs = NodePool::n_slabs();
+
+  // Graphs spanning many slabs
+  if (build(100000) < n_live + 300000) {
+    uerr() << "Nodes not allocated from the pools" << std::endl;
+    return 1;
+  }
+
+  if (NodePool::n_live()!=n_live || NodePool::n_slabs()!=n_slabs) {
+    uerr() << "Live nodes " << NodePool::n_live() << " (was " << n_live << "), slabs "
+           << NodePool::n_slabs() << " (was " << n_slabs << ")" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -192,6 +192,38 @@ class ComplexityTests(casadiTestCase):
       setup['f'].evaluate()
     self.complexity(setupfun,fun, 1)
 
+  def test_SX_compact_tape(self):
+    self.message("SX evaluation of a large tape, compact tape")
+    def setupfun(self,N):
+      A = SX.sym("A",N,1)
+      B = SX.sym("B",N,1)
+      f = Function('f', [A,B],[c.dot(A,B)*A+sin(B)],{"compact_tape":True})
+      return {'f':f,'A':DM.ones(N,1),'B':DM.ones(N,1)}
+    def fun(self,N,setup):
+      setup['f'](setup['A'],setup['B'])
+    self.complexity(setupfun,fun, 1)
+
+  def test_SX_cse(self):
+    self.message("SX common subexpression elimination")
+    def setupfun(self,N):
+      x = SX.sym("x",N,1)
+      # Each entry is built twice, as distinct but equal nodes
+      return {'e':vertcat(sin(x)*cos(x)+x**2, sin(x)*cos(x)+x**2)}
+    def fun(self,N,setup):
+      cse(setup['e'])
+    self.complexity(setupfun,fun, 1)
+
+  def test_SX_build_teardown(self):
+    self.message("SX graph construction and destruction")
+    def setupfun(self,N):
+      return {'x':SX.sym("x")}
+    def fun(self,N,setup):
+      # Deep chain, released in one go when it goes out of scope
+      e = setup['x']
+      for i in range(N):
+        e = sin(e)*setup['x']+i
+    self.complexity(setupfun,fun, 1)
+
   def test_SX_funprodsparse(self):
     self.message("SX prod sparse")
     def setupfun(self,N):
@@ -949,6 +949,145 @@ class ConicTests(casadiTestCase):
     
     
 
+  @requires_conic("qrqp")
+  def test_qrqp_warm_start(self):
+    n = 20
+    x = SX.sym("x",n)
+    p = SX.sym("p",n)
+    qp = {"x":x,"p":p,"f":0.5*dot(x,x)-dot(p,x),"g":x[1:]-x[:-1]}
+    opts = {"print_header":False,"print_iter":False}
+    cold = qpsol("cold","qrqp",qp,opts)
+    opts["warm_start"] = True
+    warm = qpsol("warm","qrqp",qp,opts)
+    args = {"p":sin(3*DM(range(n))),"lbx":-0.5,"ubx":0.5,"lbg":-0.2,"ubg":0.2}
+
+    ref = cold(**args)
+    iter_cold = cold.stats()["iter_count"]
+    sol = warm(**args)
+    self.checkarray(sol["x"],ref["x"],digits=8)
+    self.assertFalse(warm.stats()["warm_started"])
+    self.assertEqual(warm.stats()["iter_count"],iter_cold)
+
+    # Same active set and KKT matrix: no refactorization
+    sol = warm(**args)
+    self.checkarray(sol["x"],ref["x"],digits=8)
+    stats = warm.stats()
+    self.assertTrue(stats["warm_started"])
+    self.assertTrue(stats["iter_count"]<iter_cold)
+    self.assertTrue(stats["n_active_kept"]>0)
+    self.assertEqual(stats["n_factorizations"],0)
+    self.assertTrue(stats["n_factorizations_reused"]>0)
+
+    # Perturbed problem
+    args["p"] = args["p"]*1.01
+    ref = cold(**args)
+    stats_cold = cold.stats()
+    sol = warm(**args)
+    self.checkarray(sol["x"],ref["x"],digits=8)
+    self.checkarray(sol["lam_x"],ref["lam_x"],digits=8)
+    self.checkarray(sol["lam_a"],ref["lam_a"],digits=8)
+    stats = warm.stats()
+    self.assertTrue(stats["iter_count"]<stats_cold["iter_count"])
+    self.assertTrue(stats["n_active_kept"]>0)
+    # The previous factorization is updated rather than recomputed
+    self.assertTrue(stats["n_factorizations"]<stats_cold["n_factorizations"])
+    self.assertTrue(stats["n_factorizations_reused"]>0)
+
+    # Option survives serialization
+    warm2 = Function.deserialize(warm.serialize())
+    warm2(**args)
+    self.assertFalse(warm2.stats()["warm_started"])
+    warm2(**args)
+    self.assertTrue(warm2.stats()["warm_started"])
+
+  @requires_conic("ipqp")
+  def test_ipqp_centrality_corrections(self):
+    n = 100
+    x = SX.sym("x",n)
+    p = SX.sym("p",n)
+    qp = {"x":x,"p":p,"f":0.5*dot(x,x)-dot(p,x),"g":x[1:]-x[:-1]}
+    args = {"p":3*sin(3*DM(range(n))),"lbx":-0.5,"ubx":0.5,"lbg":-0.2,"ubg":0.2}
+    opts = {"print_header":False,"print_iter":False}
+    solver = qpsol("solver","ipqp",qp,opts)
+    ref = solver(**args)
+    stats_ref = solver.stats()
+    self.assertEqual(stats_ref["n_factorizations"],stats_ref["iter_count"])
+    self.assertEqual(stats_ref["n_solves"],2*stats_ref["iter_count"])
+    for max_corr in [1,3]:
+      opts["max_corrections"] = max_corr
+      solver = qpsol("solver","ipqp",qp,opts)
+      sol = solver(**args)
+      self.checkarray(sol["x"],ref["x"],digits=6)
+      stats = solver.stats()
+      self.assertTrue(stats["success"])
+      self.assertTrue(stats["n_factorizations"]<=stats_ref["n_factorizations"])
+      self.assertTrue(stats["n_solves"]>2*stats["n_factorizations"])
+    solver = Function.deserialize(solver.serialize())
+    solver(**args)
+    self.assertEqual(solver.stats()["n_solves"],stats["n_solves"])
+
+  @requires_conic("ocpqp")
+  def test_ocpqp(self):
+    N = 4
+    x = SX.sym('x',2)
+    u = SX.sym('u')
+    F = Function('F', [x, u], [vertcat(1.6*x[0]-1.11*x[1]+0.3*u-0.03, 0.7*x[0]+x[1]+0.01)])
+
+    Xs = SX.sym('X', 2, 1, N+1)
+    Us = SX.sym('U', 1, 1, N)
+    w = []
+    lbw = []
+    ubw = []
+    g = []
+    lbg = []
+    ubg = []
+    J = 0
+    for k in range(N):
+        w += [Xs[k], Us[k]]
+        lbw += [-inf, 1, -1] if k==0 else [-inf, -inf, -1]
+        ubw += [inf, 1, 1] if k==0 else [inf, inf, 1]
+        J += dot(Xs[k],Xs[k]) + 7*Us[k]**2 - 0.4*Xs[k][0]*Xs[k][1] + Us[k] - Xs[k][0]
+        # Gap closing constraints with a non-unit block
+        g += [3*(F(Xs[k],Us[k])-Xs[k+1])]
+        lbg += [0, 0]
+        ubg += [0, 0]
+        g += [0.1*Xs[k][1]-0.05*Us[k]]
+        lbg += [-0.5*k-0.1]
+        ubg += [2]
+    w += [Xs[-1]]
+    lbw += [-inf, -inf]
+    ubw += [inf, inf]
+    g += [0.1*Xs[-1][1]]
+    lbg += [0.1]
+    ubg += [2]
+    J += dot(Xs[-1],Xs[-1])
+    prob = {'f': J, 'x': vertcat(*w), 'g': vertcat(*g)}
+    args = dict(lbx=lbw, ubx=ubw, lbg=lbg, ubg=ubg)
+
+    solver_ref = qpsol('solver', 'qrqp', prob, {"print_iter":False,"print_header":False})
+    sol_ref = solver_ref(**args)
+
+    opts = {"N":N,"nx":[2]*(N+1),"nu":[1]*N,"ng":[1]*(N+1),"print_iter":False,"print_header":False}
+    for max_corr in [0, 2]:
+      opts["max_corrections"] = max_corr
+      solver = qpsol('solver', 'ocpqp', prob, opts)
+      sol = solver(**args)
+      self.assertTrue(solver.stats()["success"])
+      self.checkarray(sol_ref["x"], sol["x"],digits=7)
+      self.checkarray(sol_ref["lam_g"], sol["lam_g"],digits=6)
+      self.checkarray(sol_ref["lam_x"], sol["lam_x"],digits=6)
+      self.checkarray(sol_ref["f"], sol["f"],digits=7)
+      self.check_codegen(solver,args,std="c99")
+      self.check_serialize(solver,args)
+
+    # Inconsistent structure
+    opts["nx"] = [2]*N
+    with self.assertInException("Expected nx and ng of length N+1"):
+      qpsol('solver', 'ocpqp', prob, opts)
+    opts["nx"] = [2]*N+[1]
+    with self.assertInException("sum(nx)+sum(nu)"):
+      qpsol('solver', 'ocpqp', prob, opts)
+
   @requires_conic("hpipm")
   @requires_conic("qpoases")
   def test_hpipm(self):
@@ -629,6 +629,76 @@ class Functiontests(casadiTestCase):
     self.checkfunction_light(fun.map(4,"thread",2),fun.map(4),inputs=[hcat(X_[:4]),hcat(Y_[:4]),hcat(Z_[:4]),hcat(V_[:4])])
     self.checkfunction_light(fun.map(4,"thread",5),fun.map(4),inputs=[hcat(X_[:4]),hcat(Y_[:4]),hcat(Z_[:4]),hcat(V_[:4])])
 
+  def test_thread_pool(self):
+    x = SX.sym("x")
+    y = SX.sym("y",2)
+    fun = Function("f",[x,y],[sin(y*x),x**2])
+
+    X = DM(np.random.random((1,20)))
+    Y = DM(np.random.random((2,20)))
+    ref = fun.map(20)(X,Y)
+
+    try:
+      for size in [1,2,3,8]:
+        for chunk in [0,1,3,50]:
+          GlobalOptions.setThreadPoolSize(size)
+          GlobalOptions.setThreadPoolChunkSize(chunk)
+          res = fun.map(20,"thread")(X,Y)
+          for r,rr in zip(res,ref):
+            self.checkarray(r,rr)
+          # Nested maps are evaluated serially by the inner map
+          res = fun.map(5,"thread").map(4,"thread")(X,Y)
+          for r,rr in zip(res,ref):
+            self.checkarray(r,rr)
+    finally:
+      GlobalOptions.setThreadPoolSize(0)
+      GlobalOptions.setThreadPoolChunkSize(0)
+
+  def test_map_sx_batch(self):
+    x = SX.sym("x")
+    y = SX.sym("y",2)
+    z = SX.sym("z",Sparsity.lower(2))
+    f = Function("f",[x,y,z],[sin(x)*y+3,mtimes(z,y)/x,fmax(x,y[0])**2])
+
+    for n in [2,3,4,5,8,9,13,16,21]:
+      X = DM(np.random.random((1,n)))
+      Y = DM(np.random.random((2,n)))
+      Z = DM(repmat(z.sparsity(),1,n),np.random.random(3*n))
+      F = f.map(n)
+      # Reference: evaluation one by one
+      ref = [hcat(e) for e in zip(*[f(X[:,i],Y[:,i],Z[:,2*i:2*i+2]) for i in range(n)])]
+      for r,rr in zip(F(X,Y,Z),ref):
+        self.checkarray(r,rr)
+      self.checkfunction_light(F,f.map(n,"unroll"),inputs=[X,Y,Z])
+
+  def test_compact_tape(self):
+    x = SX.sym("x",3)
+    y = SX.sym("y",2)
+    e = vertcat(x[0]*y[0]+x[1],x[2]*x[1]-y[1],sin(x[0])/y[1],fmax(x[2],3.1)*x[0]**2,-x[1],7)
+    f = Function("f",[x,y],[e,x[0]*x[1]+y[0]*x[2],x[0]/y[0]])
+    g = Function("g",[x,y],[e,x[0]*x[1]+y[0]*x[2],x[0]/y[0]],{"compact_tape":True})
+    self.checkfunction_light(g,f,inputs=[DM([1.1,2.3,-0.7]),DM([0.3,1.7])])
+    g = Function.deserialize(g.serialize())
+    self.checkfunction_light(g,f,inputs=[DM([1.1,2.3,-0.7]),DM([0.3,1.7])])
+
+  def test_n_mem_prealloc(self):
+    x = SX.sym("x")
+    f = Function("f",[x],[sin(x)])
+    self.assertEqual(f.stats()["n_mem"],1)
+
+    f = Function("f",[x],[sin(x)],{"n_mem_prealloc":5})
+    self.assertEqual(f.stats()["n_mem"],5)
+
+    # Preallocated memory is reused by parallel evaluation
+    F = f.map(4,"thread")
+    for i in range(3):
+      self.checkarray(F(DM([[1,2,3,4]])),sin(DM([[1,2,3,4]])))
+    self.assertEqual(f.stats()["n_mem"],5)
+    self.assertTrue(f.stats()["n_mem_contention"]>=0)
+
+    with self.assertInException("n_mem_prealloc"):
+      Function("f",[x],[sin(x)],{"n_mem_prealloc":0})
+
   @memory_heavy()
   def test_mapsum(self):
     x = SX.sym("x")
@@ -2048,6 +2118,38 @@ class Functiontests(casadiTestCase):
       fs = Function.deserialize(f.serialize(opts))
       self.checkfunction(f,fs,inputs=[1.1, vertcat(2.7,3)],hessian=False)
 
+  def test_serialize_binary(self):
+    x = MX.sym("x",3)
+    A = DM(Sparsity.lower(3),range(1,7))
+    y = SX.sym("y",3)
+    g = Function('g',[y],[sin(y)*y[0]])
+    f = Function('f',[x],[mtimes(A,x)+g(x),vertcat(x,bilin(A,x,x))])
+
+    sizes = []
+    for opts in [{},{"debug":True},{"binary":True},{"binary":True,"debug":True}]:
+      f.save('f.casadi',opts)
+      with open('f.casadi','rb') as fh:
+        sizes.append(len(fh.read()))
+      fs = Function.load('f.casadi')
+      self.checkfunction(f,fs,inputs=[vertcat(1.1,2.7,3)],hessian=False)
+
+      si = FileSerializer('foo.dat',opts)
+      si.pack([A.sparsity()])
+      si.pack(A)
+      si.pack([1,2,3])
+      si.pack("foo")
+      si = None
+      si = FileDeserializer('foo.dat')
+      self.assertTrue(si.unpack()[0]==A.sparsity())
+      self.checkarray(si.unpack(),A)
+      self.assertEqual(si.unpack(),[1,2,3])
+      self.assertEqual(si.unpack(),"foo")
+      with self.assertInException("end of stream"):
+        si.unpack()
+    # Binary encoding uses a single character per byte
+    self.assertTrue(sizes[2]<0.6*sizes[0])
+    self.assertTrue(sizes[3]<0.6*sizes[1])
+
   @memory_heavy()
   def test_serialize_recursion_limit(self):
       for X in [SX,MX]:
@@ -2477,6 +2579,46 @@ class Functiontests(casadiTestCase):
       F = f.map(4,"thread",2)
       F(3)
       
+  def test_specialize(self):
+    x = SX.sym("x",2)
+    p = SX.sym("p")
+    e = vertcat(sin(x[0])*p+3.5*x[1], x[1]**2+p, 7)
+    f = Function("f",[x],[e],{"allow_free":True})
+    x0 = DM([0.3,0.7])
+
+    # Fix the parameter and change a constant
+    g = f.specialize("g",vertcat(p,3.5),vertcat(2,1.5))
+    self.assertFalse(g.has_free())
+    # The algorithm is reused
+    self.assertEqual(g.n_instructions(),f.n_instructions())
+    e_ref = vertcat(sin(x[0])*2+1.5*x[1], x[1]**2+2, 7)
+    self.checkfunction(g,Function("ref",[x],[e_ref]),inputs=[x0])
+    self.checkarray(Function.deserialize(g.serialize())(x0),g(x0))
+
+    # Values that allow simplifications
+    g = f.specialize("g",p,1)
+    self.checkfunction(g,Function("ref",[x],[substitute(e,p,1)]),inputs=[x0])
+
+    # Options that change the algorithm
+    for opts in [{"cse":True},{"live_variables":False}]:
+      g = f.specialize("g",vertcat(p,3.5),vertcat(2,1.5),opts)
+      self.checkfunction(g,Function("ref",[x],[e_ref]),inputs=[x0])
+
+    # Turn a constant into a parameter, and derive further
+    q = SX.sym("q")
+    h = f.specialize("h",vertcat(p,7),vertcat(2,q))
+    self.assertEqual(h.get_free(),["q"])
+    k = h.specialize("k",q,-1)
+    self.checkarray(k(x0),vertcat(sin(0.3)*2+3.5*0.7,0.7**2+2,-1))
+
+    with self.assertInException("is an input"):
+      f.specialize("g",x[0],1)
+    with self.assertInException("neither a constant nor a symbol"):
+      f.specialize("g",p,x[0]*2)
+    y = MX.sym("y")
+    with self.assertInException("only defined for 'SXFunction'"):
+      Function("f",[y],[y**2]).specialize("g",SX(2),SX(3))
+
   def test_DM_arg(self):
     f = Function('f',[DM(0,1)],[])
     print(f)
@@ -2692,6 +2834,85 @@ class Functiontests(casadiTestCase):
     f = Function("f",[],[c])
     self.check_codegen(f,inputs=[])
 
+  @requiresPlugin(Importer,"shell")
+  def test_jit_cache(self):
+    import tempfile
+    cache = tempfile.mkdtemp() + os.sep
+    x = SX.sym("x")
+    opts = {"jit":True, "compiler": "shell", "jit_options": {"cache_directory": cache}}
+    stats0 = Importer.cache_stats()
+    f = Function('f',[x],[sin(x)*x],opts)
+    stats1 = Importer.cache_stats()
+    self.assertEqual(stats1["misses"]-stats0["misses"],1)
+    self.assertEqual(stats1["stores"]-stats0["stores"],1)
+    # Identical source: loaded from the cache
+    g = Function('f',[x],[sin(x)*x],opts)
+    stats2 = Importer.cache_stats()
+    self.assertEqual(stats2["hits"]-stats1["hits"],1)
+    self.checkfunction_light(f,g,inputs=[0.3])
+    # Different compiler flags: recompiled
+    opts["jit_options"]["compiler_flags"] = ["-O1"]
+    h = Function('f',[x],[sin(x)*x],opts)
+    self.assertEqual(Importer.cache_stats()["misses"]-stats2["misses"],1)
+    self.checkfunction_light(f,h,inputs=[0.3])
+    # Size limit: least recently used entries are removed
+    opts["jit_options"]["cache_max_size"] = 1
+    h = Function('f',[x],[cos(x)*x],opts)
+    self.assertEqual(len([e for e in os.listdir(cache) if e.startswith("casadi_jit_")]),1)
+
+  def test_codegen_split(self):
+    x = SX.sym("x",5)
+    e = x
+    for k in range(20):
+      e = sin(e)*x[k%5]+cos(vertcat(e[1:],e[0]))
+    f = Function("f",[x],[sum1(e),e[2]*e[3],e])
+    self.check_codegen(f,inputs=[DM([0.1,0.2,0.3,0.4,0.5])],opts={"split_size":30})
+    for n_units in [1,3]:
+      opts = {"jit":True, "compiler": "shell", "jit_codegen_options": {"split_size": 50, "n_units": n_units}}
+      g = Function("f",[x],[sum1(e),e[2]*e[3],e],opts)
+      self.checkfunction_light(g,f,inputs=[DM([0.1,0.2,0.3,0.4,0.5])])
+
+  def test_jacobian_parallelization(self):
+    for X in [SX,MX]:
+      x = X.sym("x",Sparsity.lower(3))
+      y = X.sym("y",20)
+      e = vertcat(*[sin(y[i])*y[(i+1)%20]+x[i%6]*x[5] for i in range(20)])
+      for z in [e,sum1(e)]:
+        f = Function("f",[x,y],[z,mtimes(x,x)])
+        inputs = [DM(Sparsity.lower(3),[1,2,3,4,5,6]),DM(range(20))*0.1]
+        for parallelization in ["serial","thread"]:
+          g = Function("f",[x,y],[z,mtimes(x,x)],{"jacobian_options":{"parallelization":parallelization}})
+          J = g.jacobian()
+          Jref = f.jacobian()
+          for i in range(J.n_out()):
+            self.assertTrue(J.sparsity_out(i)==Jref.sparsity_out(i))
+          self.checkfunction_light(J,Jref,inputs=inputs+[0,0])
+
+  def test_sparsity_cache(self):
+    import tempfile
+    cache = tempfile.mkdtemp()
+    x = SX.sym("x",10)
+    e = vertcat(*[sin(x[i])*x[(i+1)%10] for i in range(10)])
+    Jref = Function("f",[x],[e]).jacobian()
+    GlobalOptions.setSparsityCacheDirectory(cache)
+    try:
+      J1 = Function("f",[x],[e]).jacobian()
+      entries = [f for f in os.listdir(cache) if f.startswith("casadi_sp_")]
+      self.assertTrue(len(entries)>0)
+      # Identical function: patterns and colorings read from the cache
+      J2 = Function("f",[x],[e]).jacobian()
+      self.assertEqual(len([f for f in os.listdir(cache) if f.startswith("casadi_sp_")]),len(entries))
+      for J in [J1,J2]:
+        self.assertTrue(J.sparsity_out(0)==Jref.sparsity_out(0))
+        self.checkfunction_light(J,Jref,inputs=[DM(range(10)),0])
+      # Corrupt entries are ignored
+      for f in entries:
+        with open(os.path.join(cache,f),"w") as out: out.write("garbage")
+      J3 = Function("f",[x],[e]).jacobian()
+      self.assertTrue(J3.sparsity_out(0)==Jref.sparsity_out(0))
+    finally:
+      GlobalOptions.setSparsityCacheDirectory("")
+
   def test_jit_serialize(self):
     if not args.run_slow: return
     if sys.platform=="darwin": return
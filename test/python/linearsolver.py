@@ -90,6 +90,13 @@ except:
 try:
   load_linsol("ldl")
   lsolvers.append(("ldl",{},{"posdef","symmetry"}))
+  lsolvers.append(("ldl",{"supernodal":True},{"posdef","symmetry"}))
+except:
+  pass
+
+try:
+  load_linsol("band")
+  lsolvers.append(("band",{},set()))
 except:
   pass
 
@@ -531,6 +538,143 @@ class LinearSolverTests(casadiTestCase):
       res = f_par(numpy.linspace(10, 0, 200), numpy.linspace(0, 10, 200))
 
 
+  def test_ldl_supernodal(self):
+    # Quasi-definite KKT matrix of a chain of dense stages
+    N = 8
+    nx = 5
+    np.random.seed(0)
+    H = diagcat(*[DM(np.random.random((nx,nx))) for i in range(N)])
+    H = H + H.T + 2*nx*DM.eye(N*nx)
+    J = DM.zeros((N-1)*nx,N*nx)
+    for i in range(N-1):
+      J[i*nx:(i+1)*nx,i*nx:(i+1)*nx] = np.random.random((nx,nx))
+      J[i*nx:(i+1)*nx,(i+1)*nx:(i+2)*nx] = -DM.eye(nx)
+    K = sparsify(blockcat(H,J.T,J,-1e-3*DM.eye((N-1)*nx)))
+    b = DM(np.random.random((K.shape[0],2)))
+
+    Ks = MX.sym("K",K.sparsity())
+    bs = MX.sym("b",b.shape)
+    for opts in [{"supernodal":True},{"supernodal":False}]:
+      f = Function("f",[Ks,bs],[solve(Ks,bs,"ldl",opts)])
+      x = f(K,b)
+      self.checkarray(mtimes(K,x),b,digits=10)
+      self.check_codegen(f,inputs=[K,b])
+      self.check_serialize(f,inputs=[K,b])
+
+    L = Linsol("L","ldl",K.sparsity(),{"supernodal":True})
+    L.sfact(K)
+    L.nfact(K)
+    self.assertEqual(L.neig(K),(N-1)*nx)
+    self.assertEqual(L.rank(K),K.shape[0])
+
+  def test_band(self):
+    # Multiple shooting KKT matrix with a parameter coupling all stages
+    N = 8
+    nx = 3
+    np.random.seed(1)
+    H = diagcat(*[DM(np.random.random((nx,nx))) for i in range(N)])
+    H = H + H.T + 2*nx*DM.eye(N*nx)
+    J = DM.zeros((N-1)*nx,N*nx+1)
+    for i in range(N-1):
+      J[i*nx:(i+1)*nx,i*nx:(i+1)*nx] = np.random.random((nx,nx))
+      J[i*nx:(i+1)*nx,(i+1)*nx:(i+2)*nx] = -DM.eye(nx)
+      J[i*nx:(i+1)*nx,N*nx] = np.random.random((nx,1))
+    H = diagcat(H,1)
+    K = sparsify(blockcat(H,J.T,J,DM((N-1)*nx,(N-1)*nx)))
+    # Shuffle rows and columns
+    p = list(np.random.permutation(K.shape[0]))
+    K = K[p,p]
+    K[0,1] = 1
+    b = DM(np.random.random((K.shape[0],2)))
+
+    Ks = MX.sym("K",K.sparsity())
+    bs = MX.sym("b",b.shape)
+    for opts in [{},{"border_degree":4}]:
+      f = Function("f",[Ks,bs],[solve(Ks,bs,"band",opts),solve(Ks.T,bs,"band",opts)])
+      [x,xt] = f(K,b)
+      self.checkarray(mtimes(K,x),b,digits=10)
+      self.checkarray(mtimes(K.T,xt),b,digits=10)
+      self.check_codegen(f,inputs=[K,b])
+      self.check_serialize(f,inputs=[K,b])
+
+    # As linear solver of an interior point QP solver
+    x = MX.sym("x",N)
+    u = MX.sym("u",N-1)
+    g = vertcat(*[x[i+1]-0.9*x[i]-u[i] for i in range(N-1)])
+    qp = {"x":vertcat(x,u),"f":sumsqr(x)+sumsqr(u),"g":vertcat(x[0],g)}
+    res = {}
+    for ls in ["qr","band"]:
+      solver = qpsol("solver","ipqp",qp,{"linear_solver":ls,"print_iter":False,
+        "print_header":False,"print_info":False})
+      res[ls] = solver(lbg=vertcat(1,DM.zeros(N-1)),ubg=vertcat(1,DM.zeros(N-1)),
+        lbx=-0.5,ubx=0.5)
+    self.checkarray(res["band"]["x"],res["qr"]["x"],digits=6)
+
+  def test_parallel_factorization(self):
+    # 2D Laplacian, large enough for the elimination tree to be partitioned
+    k = 40
+    T = DM(Sparsity.band(k,1))
+    T = 2*DM.eye(k)-T-T.T
+    K = sparsify(kron(T,DM.eye(k))+kron(DM.eye(k),T))
+    np.random.seed(2)
+    b = DM(np.random.random((K.shape[0],2)))
+
+    Ks = MX.sym("K",K.sparsity())
+    bs = MX.sym("b",b.shape)
+    for ls, opts in [("ldl",{"supernodal":True}),("ldl",{"supernodal":False}),("qr",{})]:
+      opts["max_threads"] = 4
+      f = Function("f",[Ks,bs],[solve(Ks,bs,ls,opts),solve(Ks.T,bs,ls,opts)])
+      [x,xt] = f(K,b)
+      self.checkarray(mtimes(K,x),b,digits=10)
+      self.checkarray(mtimes(K.T,xt),b,digits=10)
+      self.check_serialize(f,inputs=[K,b])
+      # The factorization was split up over the elimination tree
+      L = Linsol("L",ls,K.sparsity(),opts)
+      self.checkarray(mtimes(K,L.solve(K,b)),b,digits=10)
+      stats = L.stats()
+      self.assertTrue(stats["n_task"]>1)
+      self.assertEqual(stats["nfact_parallel"],1)
+
+  def test_multiple_rhs(self):
+    # Right-hand sides are solved for in blocks, the last one incomplete
+    np.random.seed(4)
+    A = DM(np.random.random((15,15)))*DM(Sparsity.banded(15,3))+10*DM.eye(15)
+    A = sparsify(A+A.T)
+    b = DM(np.random.random((15,11)))
+    As = MX.sym("A",A.sparsity())
+    bs = MX.sym("b",b.shape)
+    for ls, opts in [("ldl",{}),("ldl",{"supernodal":True}),("qr",{})]:
+      f = Function("f",[As,bs],[solve(As,bs,ls,opts),solve(As.T,bs,ls,opts)])
+      [x,xt] = f(A,b)
+      self.checkarray(mtimes(A,x),b,digits=10)
+      self.checkarray(mtimes(A.T,xt),b,digits=10)
+      # Same result as one right-hand side at a time
+      b1 = MX.sym("b1",15)
+      f1 = Function("f1",[As,b1],[solve(As,b1,ls,opts)])
+      for j in range(b.shape[1]):
+        self.checkarray(x[:,j],f1(A,b[:,j]),digits=12)
+      self.check_codegen(f,inputs=[A,b])
+
+  def test_symbolic_cache(self):
+    # Instances with the same sparsity pattern share their symbolic factorization,
+    # unless the options differ
+    np.random.seed(3)
+    A = DM(np.random.random((20,20)))*DM(Sparsity.banded(20,2))
+    A = A+A.T+10*DM.eye(20)
+    B = A+DM(Sparsity.banded(20,2))
+    b = DM(np.random.random((20,1)))
+    for ls, opts in [("ldl",{}),("ldl",{"preordering":False}),("ldl",{"supernodal":True}),
+                     ("qr",{}),("band",{}),("band",{"border_degree":0})]:
+      L = [Linsol("L%d" % i,ls,A.sparsity(),opts) for i in range(3)]
+      for i, M in enumerate([A,B,A]):
+        x = L[i].solve(M,b)
+        self.checkarray(mtimes(M,x),b,digits=10)
+        self.assertEqual(L[i].stats()["n_symbolic_users"],3)
+      # A different sparsity pattern gets its own
+      C = Linsol("C",ls,Sparsity.banded(20,1),opts)
+      C.solve(DM(Sparsity.banded(20,1),1)+2*DM.eye(20),b)
+      self.assertEqual(C.stats()["n_symbolic_users"],1)
+
   def test_issue2664(self):
 
     bnum = DM.rand(3,3)
@@ -1812,6 +1812,58 @@ class MXtests(casadiTestCase):
 
     self.checkarray(F_out,9*DM.ones(4,4))
 
+  def test_substitute_cone(self):
+    x = MX.sym("x",2)
+    y = MX.sym("y")
+    z = MX.sym("z")
+    g = Function("g",[x],[sin(x),x[0]*x[1]])
+    [g1,g2] = g(x*y)
+    c = cos(x)*3
+    e = vertcat(c,g1*z+g2)
+
+    # Untouched subexpressions are shared
+    f = substitute(e,z,y**2)
+    self.assertTrue(depends_on(f,y))
+    self.assertFalse(depends_on(f,z))
+    self.assertTrue(is_equal(substitute(c,z,y**2),c))
+    F = Function("F",[x,y],[f])
+    G = Function("G",[x,y,z],[e])
+    self.checkarray(F([0.1,0.2],3),G([0.1,0.2],3,9))
+
+    # Sparsity of the replacement differs
+    f = substitute(e,x,sparsify(DM([0,2])))
+    self.checkarray(Function("F",[y,z],[f])(3,4),G([0,2],3,4))
+
+    # Replace a node with multiple outputs through one of its outputs
+    w = MX.sym("w",2)
+    f = graph_substitute(e,[g1],[w])
+    self.checkarray(Function("F",[x,y,z,w],[f])([0.1,0.2],3,4,[5,6]),
+                    vertcat(cos(DM([0.1,0.2]))*3,DM([5,6])*4+0.3*0.6))
+
+  def test_mx_substitution(self):
+    x = MX.sym("x",2)
+    y = MX.sym("y")
+    z = MX.sym("z")
+    g = Function("g",[x],[sin(x),x[0]*x[1]])
+    [g1,g2] = g(x*y)
+    c = cos(x)*3
+    e = [c,g1*z+g2]
+    s = MXSubstitution(e)
+
+    # Same result as graph_substitute, repeatedly
+    for v, vdef in [([z],[y**2]), ([x],[sparsify(DM([0,2]))]), ([g1,z],[MX.sym("w",2),y])]:
+      f = s.substitute(v,vdef)
+      f_ref = graph_substitute(e,v,vdef)
+      syms = symvar(vertcat(*f_ref))
+      self.checkfunction_light(Function("F",syms,f),Function("F",syms,f_ref),inputs=[DM.rand(i.sparsity()) for i in syms])
+
+    # Untouched expressions are returned as is
+    f = s.substitute([z],[y**2])
+    self.assertTrue(is_equal(f[0],c))
+    # Nodes that do not occur in the graph are ignored
+    f = s.substitute([MX.sym("q")],[y])
+    self.assertTrue(is_equal(f[0],c) and is_equal(f[1],e[1]))
+
 
   def test_matrix_expand(self):
     n = 2
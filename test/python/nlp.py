@@ -1690,6 +1690,100 @@ class NLPtests(casadiTestCase):
         print(solver_in)
         self.check_codegen(solver,solver_in,**aux_options["codegen"])
 
+  @requires_nlpsol("sqpmethod")
+  def test_lbfgs_sqpmethod(self):
+    x = SX.sym("x",6)
+    f = sum1((1-x[:-1])**2 + 10*(x[1:]-x[:-1]**2)**2)
+    nlp = {"x":x,"f":f,"g":x[0]+x[-1]}
+
+    with self.assertInException("lbfgs_memory"):
+      nlpsol("mysolver", "sqpmethod", nlp, {"hessian_approximation":"limited-memory","lbfgs_memory":0})
+
+  @requires_nlpsol("sqpmethod")
+  def test_block_bfgs_sqpmethod(self):
+    N = 8
+    X = [SX.sym("x%d" % k,2) for k in range(N+1)]
+    U = [SX.sym("u%d" % k) for k in range(N)]
+    w = []
+    g = []
+    J = 0
+    for k in range(N):
+      w += [X[k], U[k]]
+      J += (1-X[k][0])**2 + 5*(X[k][1]-X[k][0]**2)**2 + U[k]**2
+      g.append(X[k+1]-vertcat(X[k][0]+0.1*X[k][1], X[k][1]+0.1*sin(X[k][0])+0.1*U[k]))
+    w.append(X[N])
+    J += dot(X[N],X[N])
+    g.append(X[0]-vertcat(0.5,-0.2))
+    nlp = {"x":vertcat(*w),"f":J,"g":vertcat(*g)}
+    solver_in = {"lbg":0,"ubg":0}
+
+    opts = {"qpsol":"qrqp","qpsol_options": {"print_iter":False,"print_header":False},
+            "tol_pr":1e-10,"tol_du":1e-10,"min_step_size":1e-14,"max_iter":100,
+            "print_header":False,"print_iteration":False,"print_status":False}
+    solver = nlpsol("mysolver", "sqpmethod", nlp, opts)
+    sol_ref = solver(**solver_in)
+
+    opts["hessian_approximation"] = "limited-memory"
+    solver = nlpsol("mysolver", "sqpmethod", nlp, opts)
+    solver(**solver_in)
+    iter_lbfgs = solver.stats()["iter_count"]
+
+    opts["block_bfgs"] = True
+    solver = nlpsol("mysolver", "sqpmethod", nlp, opts)
+    sol = solver(**solver_in)
+    self.assertTrue(solver.stats()["success"])
+    self.assertTrue(solver.stats()["iter_count"]<iter_lbfgs)
+    self.checkarray(sol["x"],sol_ref["x"],digits=7)
+    self.check_codegen(solver,solver_in,std="c99")
+    self.check_serialize(solver,solver_in)
+
+    with self.assertInException("block_bfgs"):
+      nlpsol("mysolver", "sqpmethod", nlp, {"block_bfgs":True})
+
+  @requires_nlpsol("feasiblesqpmethod")
+  def test_block_bfgs_feasiblesqpmethod(self):
+    N = 8
+    X = [SX.sym("x%d" % k,2) for k in range(N+1)]
+    U = [SX.sym("u%d" % k) for k in range(N)]
+    w = []
+    g = []
+    J = 0
+    # Feasible initial guess: simulation with zero controls
+    w0 = []
+    xk = [0.5,-0.2]
+    for k in range(N):
+      w += [X[k], U[k]]
+      w0 += xk + [0]
+      J += (1-X[k][0])**2 + 5*(X[k][1]-X[k][0]**2)**2 + U[k]**2
+      g.append(X[k+1]-vertcat(X[k][0]+0.1*X[k][1], X[k][1]+0.1*sin(X[k][0])+0.1*U[k]))
+      xk = [xk[0]+0.1*xk[1], xk[1]+0.1*sin(xk[0])]
+    w.append(X[N])
+    w0 += xk
+    J += dot(X[N],X[N])
+    g.append(X[0]-vertcat(0.5,-0.2))
+    nlp = {"x":vertcat(*w),"f":J,"g":vertcat(*g)}
+    solver_in = {"x0":w0,"lbg":0,"ubg":0}
+
+    opts = {"qpsol":"qrqp","print_header":False,"print_iteration":False,"print_status":False}
+    sol_ref = nlpsol("mysolver", "sqpmethod", nlp, opts)(**solver_in)
+
+    opts = {"qpsol":"qrqp","qpsol_options": {"print_iter":False,"print_header":False,"error_on_fail":False},
+            "hessian_approximation":"limited-memory","optim_tol":1e-10,"feas_tol":1e-10,
+            "max_iter":200,"print_header":False,"print_iteration":False,"print_status":False}
+    solver = nlpsol("mysolver", "feasiblesqpmethod", nlp, opts)
+    solver(**solver_in)
+    iter_lbfgs = solver.stats()["iter_count"]
+
+    opts["block_bfgs"] = True
+    solver = nlpsol("mysolver", "feasiblesqpmethod", nlp, opts)
+    sol = solver(**solver_in)
+    self.assertTrue(solver.stats()["success"])
+    self.assertTrue(solver.stats()["iter_count"]<iter_lbfgs)
+    self.checkarray(sol["x"],sol_ref["x"],digits=4)
+
+    with self.assertInException("block_bfgs"):
+      nlpsol("mysolver", "feasiblesqpmethod", nlp, {"block_bfgs":True})
+
   @requires_nlpsol("sqpmethod")
   def test_gauss_newton_sqpmethod(self):
     x = SX.sym("x",3)
@@ -479,6 +479,36 @@ class Sparsitytests(casadiTestCase):
 
     self.assertTrue(DM(J.sparsity_out(0))[:X.nnz(),:].sparsity()==Sparsity.diag(100))
 
+  def test_jacsparsity_parallel(self):
+    x = MX.sym("x",2000)
+    z = MX.sym("z",4)
+    F = Function("F",[z],[vertcat(sin(z[0])*z[1],z[2]*z[3]+z[0],cos(z[3]),z[1]*z[2])])
+    y = F.map(499)(reshape(x[2:1998],4,499))
+    results = []
+    hierarchical0 = GlobalOptions.getHierarchicalSparsity()
+    size0 = GlobalOptions.getThreadPoolSize()
+    try:
+      for hierarchical in [True,False]:
+        GlobalOptions.setHierarchicalSparsity(hierarchical)
+        for size in [1,4]:
+          GlobalOptions.setThreadPoolSize(size)
+          f = Function("f",[x],[vec(y)+x[4:]])
+          sp = f.jac_sparsity(0,0)
+          results.append((sp,sp.uni_coloring(sp.T)))
+      for sp, D in results:
+        self.assertTrue(sp==results[0][0])
+        self.assertTrue(D==results[0][1])
+
+      # Coloring of a pattern large enough to be parallelized
+      A = Sparsity.banded(100000,3)
+      for size in [1,4]:
+        GlobalOptions.setThreadPoolSize(size)
+        D = A.uni_coloring(A.T)
+        self.assertEqual(D.size2(),7)
+    finally:
+      GlobalOptions.setHierarchicalSparsity(hierarchical0)
+      GlobalOptions.setThreadPoolSize(size0)
+
   @memory_heavy()
   def test_jacsparsityHierarchicalSymm(self):
     GlobalOptions.setHierarchicalSparsity(False)